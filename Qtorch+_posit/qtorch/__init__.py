@@ -1,3 +1,6 @@
 from .number import *
 from .posit_activation import *
-__all__ = ["FixedPoint", "BlockFloatingPoint", "FloatingPoint", "Posit", "PositTanhModule","PositTanhModuleEnhanced","RefTanhModule"]
+from .posit_embedding import *
+from .posit_saved_tensors import *
+from .posit_checkpoint import *
+__all__ = ["FixedPoint", "BlockFloatingPoint", "FloatingPoint", "Posit", "PositSigmoidModule", "PositTanhModule","PositTanhModuleEnhanced","RefTanhModule","PositEmbedding","PositEmbeddingBag","posit_saved_tensors","save_posit_checkpoint","load_posit_checkpoint","PositCheckpoint"]
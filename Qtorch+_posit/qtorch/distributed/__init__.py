@@ -0,0 +1,3 @@
+from .posit_hook import *
+
+__all__ = ["PositCompressionState", "posit_compress_hook"]
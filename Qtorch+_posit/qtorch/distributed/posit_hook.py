@@ -0,0 +1,127 @@
+import math
+import torch
+import torch.distributed as dist
+from qtorch.quant import posit_pack, posit_unpack, posit_unpack_sum
+
+__all__ = ["PositCompressionState", "posit_compress_hook"]
+
+
+class PositCompressionState:
+    """
+    State of :func:`posit_compress_hook`, created once and handed to
+    `DistributedDataParallel.register_comm_hook`.
+
+    Args:
+        - :attr: `nsize` (int) : posit word length used on the wire, 8 or 16
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `error_feedback` (bool) : carry the local compression error of every bucket over
+                 to the next iteration
+        - :attr: `process_group` : process group to communicate in, defaults to the world group
+
+    Example:
+        >>> state = PositCompressionState(nsize=8, es=2, error_feedback=True)
+        >>> model = DistributedDataParallel(model)
+        >>> model.register_comm_hook(state, posit_compress_hook)
+    """
+
+    def __init__(self, nsize=8, es=2, error_feedback=False, process_group=None):
+        assert nsize in [8, 16], "only posit8 and posit16 packing is supported"
+        self.nsize = nsize
+        self.es = es
+        self.error_feedback = error_feedback
+        self.process_group = process_group
+        self.residuals = {}
+
+    def __repr__(self):
+        return "PositCompressionState (nsize={:d}, es={:d}, error_feedback={})".format(
+            self.nsize, self.es, self.error_feedback
+        )
+
+
+def _bucket_scale(grad):
+    # power-of-2 scale mapping the mean magnitude of the bucket to 1, where posits are most accurate;
+    # a power of 2 keeps the scaling itself exact
+    mean_abs = grad.abs().mean().item()
+    if mean_abs == 0 or not math.isfinite(mean_abs):
+        return 1.0
+    return 2.0 ** (-round(math.log2(mean_abs)))
+
+
+def _payload(packed, scale):
+    # gloo has no int16 collectives, so posit16 travels as bytes; every row carries its scale
+    # in its last 4 bytes
+    rows = packed.size(0)
+    scales = torch.tensor([scale], dtype=torch.float).view(torch.uint8).expand(rows, 4)
+    return torch.cat([packed.view(torch.uint8).view(rows, -1), scales], dim=1).contiguous()
+
+
+def _split(payload, nsize):
+    # inverse of _payload: the packed bits and the per-row scales
+    scales = payload[:, -4:].contiguous().view(torch.float).view(-1)
+    bits = payload[:, :-4].contiguous()
+    if nsize > 8:
+        bits = bits.view(torch.int16)
+    return bits, scales
+
+
+def posit_compress_hook(state, bucket):
+    """
+    DDP communication hook exchanging gradient buckets as packed posit bits.
+
+    Every rank encodes its bucket to posit(nsize, es) with a per-bucket power-of-2 scale and
+    splits it into world_size shards. A packed reduce-scatter (all_to_all_single) hands shard r
+    of every rank to rank r, which decodes the contributions, sums them in fp32, averages and
+    re-encodes its shard with a scale of its own; a packed all-gather then returns every shard
+    to every rank. Each element is thus rounded to posit twice, on the way in and after the
+    average. The fp32 sum rounds once per addition, so it is not exact when the contributions
+    of different ranks differ widely in magnitude.
+
+    For a bucket of N elements each rank sends about 2 * (world_size - 1) / world_size * N * b
+    bytes (b = 1 for posit8, 2 for posit16), against 8 * (world_size - 1) / world_size * N for
+    a ring fp32 all-reduce: 4x less traffic with posit8 and 2x less with posit16 at any world size.
+    Runs on any backend supporting uint8 all_to_all_single and all_gather, including gloo.
+
+    Returns:
+        - a torch.futures.Future resolving to the averaged bucket
+    """
+    group = state.process_group if state.process_group is not None else dist.group.WORLD
+    world_size = dist.get_world_size(group)
+    buffer = bucket.buffer()
+    grad = buffer.float()
+    n = grad.numel()
+    shard = -(-n // world_size)
+
+    if state.error_feedback:
+        residual = state.residuals.get(bucket.index())
+        # buckets are rebuilt after the first iteration, drop residuals that no longer fit
+        if residual is not None and residual.shape == grad.shape:
+            grad = grad + residual
+
+    scale = _bucket_scale(grad)
+    packed = posit_pack(grad, state.nsize, state.es, scale)
+    if state.error_feedback:
+        state.residuals[bucket.index()] = grad - posit_unpack(packed, state.nsize, state.es, scale)
+
+    # pad to world_size equal shards with posit zeros
+    padded = torch.zeros(world_size * shard, dtype=packed.dtype)
+    padded[:n] = packed
+    send = _payload(padded.view(world_size, shard), scale)
+    received = torch.empty_like(send)
+    fut = dist.all_to_all_single(received, send, group=group, async_op=True).get_future()
+
+    def reduce_shard(fut):
+        bits, scales = _split(received, state.nsize)
+        mean = posit_unpack_sum(bits, scales, state.nsize, state.es).div_(world_size)
+        mean_scale = _bucket_scale(mean)
+        payload = _payload(posit_pack(mean, state.nsize, state.es, mean_scale).view(1, shard), mean_scale)
+        gathered = [torch.empty_like(payload) for _ in range(world_size)]
+        dist.all_gather(gathered, payload, group=group, async_op=True).get_future().wait()
+        return gathered
+
+    def decode(fut):
+        bits, scales = _split(torch.cat(fut.value()), state.nsize)
+        shards = [posit_unpack(b, state.nsize, state.es, s) for b, s in zip(bits, scales.tolist())]
+        buffer.copy_(torch.cat(shards)[:n].view_as(buffer))
+        return buffer
+
+    return fut.then(reduce_shard).then(decode)
@@ -1,7 +1,47 @@
-__all__ = ["PositTanhModule","PositTanhModuleEnhanced","RefTanhModule"]
-#Todo : implement sigmoid, rarely used in modern DNN
+__all__ = ["PositSigmoidModule","PositTanhModule","PositTanhModuleEnhanced","RefTanhModule"]
 import torch
 from qtorch.quant import posit_sigmoid, posit_tanh, posit_tanh_enhanced
+from qtorch.quant import posit_activation_forward, posit_activation_backward
+
+
+# On CPU the forward saves the posit16 bits of the sigmoid the output is made from (exact,
+# half the size of the output) and the backward is one fused kernel; elsewhere the output
+# is saved and the gradient computed in PyTorch.
+def _activation_forward(ctx, input, activation, quantize):
+    ctx.saved_bits = not input.is_cuda
+    if ctx.saved_bits:
+        output, bits = posit_activation_forward(input, activation, nsize=16)
+        ctx.save_for_backward(bits)
+        return output
+    output = quantize(input,nsize=16,es=0)
+    ctx.save_for_backward(output)
+    return output#input.clamp(min=0)
+
+def _activation_backward(ctx, grad_output, activation):
+    saved, = ctx.saved_tensors
+    if ctx.saved_bits:
+        return posit_activation_backward(grad_output, saved, activation, nsize=16)
+    if activation == "sigmoid":
+        return grad_output*(saved*(1- saved))
+    #tanhx = top_data[i];
+    #bottom_diff[i] = top_diff[i] * (1 - tanhx * tanhx);
+    return grad_output*(1- saved*saved)
+
+
+class PositSigmoidModule(torch.nn.Module):
+    def forward(self, input):
+        return PositSigmoidFunction.apply(input)
+
+class PositSigmoidFunction(torch.autograd.Function):
+
+    @staticmethod
+    def forward(ctx, input):
+        return _activation_forward(ctx, input, "sigmoid", posit_sigmoid)
+
+    @staticmethod
+    def backward(ctx, grad_output):
+        return _activation_backward(ctx, grad_output, "sigmoid")
+
 class PositTanhModule(torch.nn.Module):
     def forward(self, input):
         return PositTanhFunction.apply(input)
@@ -12,18 +52,11 @@ class PositTanhFunction(torch.autograd.Function):
     @staticmethod
     def forward(ctx, input):
         # replace posit_tanh_enhanced <> posit_tanh for different approx
-        output = posit_tanh(input,nsize=16,es=0)
-        ctx.save_for_backward(output)
-        return output#input.clamp(min=0)
+        return _activation_forward(ctx, input, "tanh", posit_tanh)
 
     @staticmethod
     def backward(ctx, grad_output):
-        output, = ctx.saved_tensors
-        #tanhx = top_data[i];
-        #bottom_diff[i] = top_diff[i] * (1 - tanhx * tanhx);
-        #grad_input = grad_output.clone()
-        grad_input = grad_output*(1- output*output)
-        return grad_input
+        return _activation_backward(ctx, grad_output, "tanh")
     
 class PositTanhModuleEnhanced(torch.nn.Module):
     def forward(self, input):
@@ -33,19 +66,14 @@ class PositTanhFunctionEnhanced(torch.autograd.Function):
 
     @staticmethod
     def forward(ctx, input):
-        output = posit_tanh_enhanced(input,nsize=16,es=0)
-        ctx.save_for_backward(output)
-        return output#input.clamp(min=0)
+        return _activation_forward(ctx, input, "tanh_enhanced", posit_tanh_enhanced)
 
     @staticmethod
     def backward(ctx, grad_output):
-        output, = ctx.saved_tensors
-        grad_input = grad_output*(1- output*output)
-        return grad_input
+        return _activation_backward(ctx, grad_output, "tanh_enhanced")
     
 
     
 class RefTanhModule(torch.nn.Module):
     def forward(self, input):
         return torch.tanh(input)
-    
\ No newline at end of file
@@ -0,0 +1,176 @@
+__all__ = ["save_posit_checkpoint", "load_posit_checkpoint", "PositCheckpoint"]
+import json
+import mmap
+import struct
+from collections import OrderedDict
+from concurrent.futures import ThreadPoolExecutor
+import torch
+from qtorch import Posit
+from qtorch.quant import posit_pack_exact, posit_unpack
+
+# layout: magic | uint64 header length | json header | data, every tensor 64-byte aligned
+_MAGIC = b"QTPOSIT\x01"
+_ALIGN = 64
+
+
+def _align(offset):
+    return (offset + _ALIGN - 1) // _ALIGN * _ALIGN
+
+
+def _dtype_name(dtype):
+    return str(dtype).split(".")[-1]
+
+
+def _encode(tensor, numbers):
+    # returns (entry, bytes view); posit entries only when the encoding is lossless
+    tensor = tensor.detach().cpu().contiguous()
+    if tensor.dtype == torch.float32 and tensor.numel() > 0:
+        for number in numbers:
+            bits, exact = posit_pack_exact(tensor, number.nsize, number.es, float(number.scale))
+            if exact:
+                entry = {"format": "posit", "dtype": _dtype_name(bits.dtype), "shape": list(tensor.shape),
+                         "nsize": number.nsize, "es": number.es, "scale": float(number.scale)}
+                return entry, bits.reshape(-1).view(torch.uint8)
+    entry = {"format": "raw", "dtype": _dtype_name(tensor.dtype), "shape": list(tensor.shape)}
+    return entry, tensor.reshape(-1).view(torch.uint8)
+
+
+def save_posit_checkpoint(state_dict, path, numbers):
+    """
+    Save a state dict with every posit-representable single precision tensor stored as packed
+    posit bits (1 byte per value for nsize <= 8, 2 bytes for nsize <= 16) together with its
+    (nsize, es, scale). Other tensors are stored as they are, so loading is always lossless.
+
+    Args:
+        - :attr: `state_dict` (dict) : name to tensor mapping, e.g. `model.state_dict()` of a lowered model
+        - :attr: `path` (string) : output file
+        - :attr: `numbers` (Posit or list of Posit) : formats tried in order, the scale of each
+          format is the one the weights were quantized with
+    """
+    numbers = [numbers] if isinstance(numbers, Posit) else list(numbers)
+    for number in numbers:
+        assert isinstance(number, Posit), "checkpoint tensors can only be packed into posit formats"
+        assert number.nsize <= 16, "packed posit storage only supports nsize <= 16"
+
+    entries = OrderedDict()
+    blobs = []
+    offset = 0
+    for name, tensor in state_dict.items():
+        entry, blob = _encode(tensor, numbers)
+        offset = _align(offset)
+        entry["offset"] = offset
+        entry["nbytes"] = blob.numel()
+        entries[name] = entry
+        blobs.append(blob)
+        offset += blob.numel()
+
+    header = json.dumps(entries).encode("utf-8")
+    data_start = _align(len(_MAGIC) + 8 + len(header))
+    with open(path, "wb") as f:
+        f.write(_MAGIC)
+        f.write(struct.pack("<Q", len(header)))
+        f.write(header)
+        for entry, blob in zip(entries.values(), blobs):
+            f.write(b"\0" * (data_start + entry["offset"] - f.tell()))
+            f.write(blob.numpy().tobytes())
+
+
+class PositCheckpoint(object):
+    """
+    Memory-mapped checkpoint written by :func:`save_posit_checkpoint`. Nothing is read until a
+    tensor is accessed: raw tensors and packed bits are zero-copy views of the mapping, posit
+    tensors are decoded on access with the multithreaded `posit_unpack`. Since the views keep the
+    mapping alive, they must be deleted (or `.clone()`d) before the checkpoint is closed.
+
+    Example:
+        >>> ckpt = load_posit_checkpoint("model.qtp")
+        >>> model.load_state_dict(ckpt.state_dict())
+        >>> emb = PositEmbedding.from_packed(*ckpt.packed("embedding.weight"))
+    """
+
+    def __init__(self, path):
+        self._file = open(path, "rb")
+        # copy-on-write mapping: pages are shared with the page cache until a tensor is modified
+        self._map = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_COPY)
+        assert self._map[:len(_MAGIC)] == _MAGIC, "{} is not a posit checkpoint".format(path)
+        (header_len,) = struct.unpack("<Q", self._map[len(_MAGIC):len(_MAGIC) + 8])
+        header_start = len(_MAGIC) + 8
+        self.entries = json.loads(self._map[header_start:header_start + header_len].decode("utf-8"),
+                                  object_pairs_hook=OrderedDict)
+        self._data_start = _align(header_start + header_len)
+
+    def _view(self, entry):
+        dtype = getattr(torch, entry["dtype"])
+        count = entry["nbytes"] // torch.empty((), dtype=dtype).element_size()
+        if count == 0:
+            return torch.empty(entry["shape"], dtype=dtype)
+        view = torch.frombuffer(self._map, dtype=dtype, count=count, offset=self._data_start + entry["offset"])
+        return view.reshape(entry["shape"])
+
+    def keys(self):
+        return self.entries.keys()
+
+    def __contains__(self, name):
+        return name in self.entries
+
+    def __iter__(self):
+        return iter(self.entries)
+
+    def __len__(self):
+        return len(self.entries)
+
+    def packed(self, name):
+        """
+        Returns (bits, nsize, es, scale) of a posit tensor without decoding it, the bits
+        being a zero-copy view of the file
+        """
+        entry = self.entries[name]
+        assert entry["format"] == "posit", "{} is not stored as packed posit bits".format(name)
+        return self._view(entry), entry["nsize"], entry["es"], entry["scale"]
+
+    def __getitem__(self, name):
+        entry = self.entries[name]
+        if entry["format"] == "raw":
+            return self._view(entry)
+        return posit_unpack(self._view(entry), entry["nsize"], entry["es"], entry["scale"])
+
+    def state_dict(self, num_workers=4):
+        """
+        Returns every tensor, posit tensors decoded to single precision. `posit_unpack` releases
+        the GIL, so many small tensors are decoded concurrently by `num_workers` threads.
+        """
+        with ThreadPoolExecutor(max_workers=num_workers) as pool:
+            tensors = list(pool.map(self.__getitem__, self.entries))
+        return OrderedDict(zip(self.entries, tensors))
+
+    def close(self):
+        """
+        Unmap the file. Raises BufferError while raw tensors or packed bits read from the
+        checkpoint are still alive, as they are views of the mapping; decoded posit tensors are copies.
+        """
+        try:
+            self._map.close()
+        except BufferError:
+            raise BufferError("cannot close a posit checkpoint while tensors loaded from it are alive "
+                              "(raw tensors and packed bits view the file): delete or .clone() them first") from None
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+
+def load_posit_checkpoint(path):
+    """
+    Open a checkpoint written by :func:`save_posit_checkpoint` without reading it
+
+    Args:
+        - :attr: `path` (string) : checkpoint file
+
+    Returns:
+        - a :class:`PositCheckpoint`, whose raw tensors and packed bits must be deleted (or
+          `.clone()`d) before it is closed
+    """
+    return PositCheckpoint(path)
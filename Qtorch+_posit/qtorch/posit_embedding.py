@@ -0,0 +1,186 @@
+__all__ = ["PositEmbedding", "PositEmbeddingBag"]
+import torch
+from qtorch.quant import posit_pack, posit_unpack
+from qtorch.quant.quant_function import posit_embedding, posit_embedding_bag, posit_embedding_sparse_update
+
+
+def _row_scales(weight):
+    # power-of-2 scale per row mapping the mean magnitude of the row to 1
+    mean_abs = weight.abs().mean(dim=1)
+    scale = torch.exp2(-torch.round(torch.log2(mean_abs)))
+    return torch.where(mean_abs > 0, scale, torch.ones_like(scale)).float()
+
+
+def _pack_rows(weight, nsize, es, row_scale):
+    if row_scale is None:
+        return posit_pack(weight, nsize, es)
+    # scaling each row first keeps the packing a single pass with scale 1
+    return posit_pack(weight * row_scale.unsqueeze(1), nsize, es)
+
+
+class _SparseGradFunction(torch.autograd.Function):
+    """Routes the gradient of the gathered rows to the owning module as (indices, rows) pairs."""
+
+    @staticmethod
+    def forward(ctx, output, anchor, module, indices, grad_rows):
+        ctx.module = module
+        ctx.indices = indices
+        ctx.grad_rows = grad_rows
+        return output
+
+    @staticmethod
+    def backward(ctx, grad_output):
+        ctx.module._grads.append((ctx.indices, ctx.grad_rows(grad_output)))
+        return None, None, None, None, None
+
+
+class _PositEmbeddingBase(torch.nn.Module):
+    def __init__(self, num_embeddings, embedding_dim, nsize, es, per_row_scale, weight):
+        super(_PositEmbeddingBase, self).__init__()
+        assert 16 >= nsize > 0, "packed posit storage only supports nsize <= 16"
+        self.num_embeddings = num_embeddings
+        self.embedding_dim = embedding_dim
+        self.nsize = nsize
+        self.es = es
+        if weight is None:
+            weight = torch.randn(num_embeddings, embedding_dim)
+        assert weight.shape == (num_embeddings, embedding_dim), "weight shape does not match the table"
+        if weight.dtype in [torch.uint8, torch.int16]:
+            # already packed bits, see from_packed
+            self.register_buffer("weight", weight)
+            self.register_buffer("row_scale", None)
+        else:
+            weight = weight.detach().float().cpu()
+            row_scale = _row_scales(weight) if per_row_scale else None
+            self.register_buffer("weight", _pack_rows(weight, nsize, es, row_scale))
+            self.register_buffer("row_scale", row_scale)
+        # the packed table cannot require grad, this tensor only makes autograd call back into the module
+        self._anchor = torch.zeros((), requires_grad=True)
+        self._grads = []
+
+    def _track(self, output, indices, grad_rows):
+        if not (self.training and torch.is_grad_enabled()):
+            return output
+        return _SparseGradFunction.apply(output, self._anchor, self, indices, grad_rows)
+
+    @classmethod
+    def from_packed(cls, weight, nsize, es, scale=1.0, **kwargs):
+        """
+        Wraps packed posit bits, e.g. `PositCheckpoint.packed(name)`, without decoding them.
+        `scale` is the packing scale, a float for the whole table or a tensor with one per row.
+        """
+        assert weight.dtype == (torch.uint8 if nsize <= 8 else torch.int16), "weight is not packed for nsize"
+        module = cls(weight.size(0), weight.size(1), nsize=nsize, es=es, weight=weight, **kwargs)
+        if not isinstance(scale, torch.Tensor):
+            scale = None if scale == 1.0 else torch.full((weight.size(0),), float(scale))
+        module.row_scale = scale
+        return module
+
+    def zero_grad(self, set_to_none=True):
+        self._grads = []
+        super(_PositEmbeddingBase, self).zero_grad(set_to_none)
+
+    def step(self, lr):
+        """
+        Applies the gradients accumulated since the last step as a sparse SGD update,
+        stochastically rounded back into the packed table.
+        """
+        if not self._grads:
+            return
+        indices = torch.cat([i.reshape(-1) for i, _ in self._grads])
+        grads = torch.cat([g.reshape(-1, self.embedding_dim) for _, g in self._grads])
+        posit_embedding_sparse_update(self.weight, indices, grads, lr, self.nsize, self.es, self.row_scale)
+        self._grads = []
+
+    def dequantize(self):
+        """Returns the table decoded to single precision."""
+        weight = posit_unpack(self.weight, self.nsize, self.es)
+        return weight if self.row_scale is None else weight / self.row_scale.unsqueeze(1)
+
+    def extra_repr(self):
+        return "{}, {}, nsize={}, es={}, per_row_scale={}".format(
+            self.num_embeddings, self.embedding_dim, self.nsize, self.es, self.row_scale is not None
+        )
+
+
+class PositEmbedding(_PositEmbeddingBase):
+    """
+    Embedding table stored as packed posit bits (1 byte per value for nsize <= 8, 2 bytes for nsize <= 16)
+    with an optional power-of-2 scale per row. Lookups gather and decode the requested rows in a single
+    multithreaded pass. Training updates are sparse: after `backward`, call `step(lr)` to apply SGD to the
+    touched rows with stochastic rounding back into packed form.
+
+    Args:
+        - :attr: `num_embeddings` (int) : number of rows
+        - :attr: `embedding_dim` (int) : size of each row
+        - :attr: `nsize` (int) : number of bits allocated for the posit format
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `per_row_scale` (bool) : store a power-of-2 scale per row
+        - :attr: `weight` (torch.Tensor, optional) : initial single precision table, or packed bits (see `from_packed`)
+
+    Example:
+        >>> emb = PositEmbedding.from_embedding(nn.Embedding(1000, 64), nsize=8, es=1)
+        >>> loss = emb(indices).sum()
+        >>> loss.backward()
+        >>> emb.step(lr=0.1)
+    """
+
+    def __init__(self, num_embeddings, embedding_dim, nsize=8, es=1, per_row_scale=True, weight=None):
+        super(PositEmbedding, self).__init__(num_embeddings, embedding_dim, nsize, es, per_row_scale, weight)
+
+    @classmethod
+    def from_embedding(cls, embedding, nsize=8, es=1, per_row_scale=True):
+        return cls(embedding.num_embeddings, embedding.embedding_dim, nsize, es, per_row_scale, embedding.weight)
+
+    def forward(self, input):
+        output = posit_embedding(self.weight, input, self.nsize, self.es, self.row_scale)
+        return self._track(output, input, lambda grad: grad.reshape(-1, self.embedding_dim))
+
+
+class PositEmbeddingBag(_PositEmbeddingBase):
+    """
+    Packed posit counterpart of `torch.nn.EmbeddingBag` with \"sum\" and \"mean\" pooling.
+    Rows are gathered, decoded and pooled in a single multithreaded pass; training works as in
+    :class:`PositEmbedding`.
+
+    Args:
+        - :attr: `num_embeddings` (int) : number of rows
+        - :attr: `embedding_dim` (int) : size of each row
+        - :attr: `mode` (string) : \"sum\" or \"mean\"
+        - :attr: `nsize` (int) : number of bits allocated for the posit format
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `per_row_scale` (bool) : store a power-of-2 scale per row
+        - :attr: `weight` (torch.Tensor, optional) : initial single precision table, or packed bits (see `from_packed`)
+    """
+
+    def __init__(self, num_embeddings, embedding_dim, mode="mean", nsize=8, es=1, per_row_scale=True, weight=None):
+        super(PositEmbeddingBag, self).__init__(num_embeddings, embedding_dim, nsize, es, per_row_scale, weight)
+        assert mode in ["sum", "mean"], "invalid pooling mode {}".format(mode)
+        self.mode = mode
+
+    @classmethod
+    def from_embedding_bag(cls, embedding_bag, nsize=8, es=1, per_row_scale=True):
+        return cls(embedding_bag.num_embeddings, embedding_bag.embedding_dim, embedding_bag.mode, nsize, es,
+                   per_row_scale, embedding_bag.weight)
+
+    def forward(self, input, offsets=None, per_sample_weights=None):
+        if input.dim() == 2:
+            offsets = torch.arange(0, input.numel(), input.size(1), dtype=torch.long)
+            input = input.reshape(-1)
+        assert offsets is not None, "offsets are required for 1D input"
+        output = posit_embedding_bag(self.weight, input, offsets, self.nsize, self.es, self.row_scale,
+                                     per_sample_weights, self.mode)
+
+        def grad_rows(grad):
+            lengths = torch.diff(offsets, append=torch.tensor([input.numel()]))
+            rows = grad.repeat_interleave(lengths, dim=0)
+            if per_sample_weights is not None:
+                rows = rows * per_sample_weights.unsqueeze(1)
+            if self.mode == "mean":
+                rows = rows / lengths.clamp(min=1).repeat_interleave(lengths).unsqueeze(1)
+            return rows
+
+        return self._track(output, input, grad_rows)
+
+    def extra_repr(self):
+        return super(PositEmbeddingBag, self).extra_repr() + ", mode={}".format(self.mode)
@@ -0,0 +1,58 @@
+__all__ = ["posit_saved_tensors"]
+import torch
+from qtorch import Posit
+from qtorch.quant import posit_pack_exact, posit_unpack
+
+
+class posit_saved_tensors(torch.autograd.graph.saved_tensors_hooks):
+    """
+    Context manager storing the tensors autograd saves for backward as packed posit bits.
+    A saved tensor is packed only if every element is representable in one of `numbers`
+    (e.g. the output of a posit quantizer or of posit_tanh), so backward sees exactly the
+    same values; anything else is kept in single precision. Packed tensors are decoded
+    when backward first accesses them.
+
+    Args:
+        - :attr: `numbers` (Posit or list of Posit) : formats tried in order, nsize <= 16
+        - :attr: `scale` (float) : the scale the values were quantized with, since posit precision
+          tapers with magnitude a rescaled posit value is in general not representable any more
+        - :attr: `min_numel` (int) : tensors with fewer elements are kept as they are
+
+    Example:
+        >>> with posit_saved_tensors([Posit(8, 1), Posit(16, 0)]):
+        ...     loss = model(x).sum()
+        >>> loss.backward()
+    """
+
+    def __init__(self, numbers, scale=1.0, min_numel=1024):
+        numbers = [numbers] if isinstance(numbers, Posit) else list(numbers)
+        for number in numbers:
+            assert isinstance(number, Posit), "saved tensors can only be packed into posit formats"
+            assert number.nsize <= 16, "packed posit storage only supports nsize <= 16"
+        self.numbers = numbers
+        self.scale = scale
+        self.min_numel = min_numel
+        super(posit_saved_tensors, self).__init__(self._pack, self._unpack)
+
+    def _packable(self, x):
+        if x.dtype != torch.float32 or x.is_cuda or not x.is_contiguous():
+            return False
+        if x.numel() < self.min_numel:
+            return False
+        # parameters stay referenced by the model, a packed copy would only add memory
+        return not (x.requires_grad and x.is_leaf)
+
+    def _pack(self, x):
+        if not self._packable(x):
+            return x
+        for number in self.numbers:
+            bits, exact = posit_pack_exact(x, number.nsize, number.es, self.scale)
+            if exact:
+                return (bits, number.nsize, number.es, self.scale)
+        return x
+
+    def _unpack(self, packed):
+        if isinstance(packed, torch.Tensor):
+            return packed
+        bits, nsize, es, scale = packed
+        return posit_unpack(bits, nsize, es, scale)
@@ -3,9 +3,34 @@ from .quant_module import *
 
 __all__ = [
     "fixed_point_quantize",
+    "PackedFixedPoint",
+    "fixed_point_pack",
+    "fixed_point_unpack",
+    "fixed_point_matmul",
     "block_quantize",
     "float_quantize",
+    "float_pack",
+    "float_unpack",
     "posit_quantize",
+    "posit_pack",
+    "posit_unpack",
+    "posit_unpack_sum",
+    "posit_add",
+    "posit_sub",
+    "posit_mul",
+    "posit_div",
+    "posit_fma",
+    "posit_sqrt",
+    "posit_sum",
+    "posit_mean",
+    "posit_dot",
+    "accumulate_matmul",
+    "accumulate_conv2d",
+    "mx_quantize",
+    "mx_unpack",
+    "transcode",
+    "posit_activation_forward",
+    "posit_activation_backward",
     "quantizer",
     "Quantizer",
 ]
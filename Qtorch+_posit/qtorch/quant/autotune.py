@@ -0,0 +1,146 @@
+"""
+Self-tuning dispatch between interchangeable kernel variants (e.g. single-threaded,
+multithreaded or packed round-trip implementations of the same quantizer). The first call
+for an (op, config, size bucket) times every variant that applies, and later calls run the
+fastest one. Variants must return identical results, only their speed differs.
+
+Environment:
+    - `QTORCH_KERNEL_VARIANT` : forces variants, for benchmarking: either a name used for every
+      op that has it (e.g. "parallel"), or per op, e.g. "posit_quantize=packed,configurable_table_quantize=scalar"
+    - `QTORCH_AUTOTUNE_CACHE` : JSON file keeping the winners across runs, per machine and
+      thread count (see `set_cache_file`)
+"""
+import json
+import os
+import platform
+import threading
+import time
+import torch
+
+__all__ = ["register_variant", "dispatch", "winners", "clear", "set_cache_file"]
+
+REPEATS = 3
+
+_variants = {}  # op -> {name: (fn, applies)}, in registration order
+_winners = {}  # (op, config, size bucket) -> name
+_lock = threading.Lock()
+_cache_file = os.environ.get("QTORCH_AUTOTUNE_CACHE")
+_disk = None  # winners read from the cache file, for this machine
+
+
+def register_variant(op, name, fn, applies=None):
+    """
+    Add a variant of `op`: `fn(x, *args)`, which applies to the configs for which
+    `applies(*config)` is true (all of them by default)
+    """
+    _variants.setdefault(op, {})[name] = (fn, applies or (lambda *config: True))
+
+
+def set_cache_file(path):
+    """keep the winners in the JSON file `path` (None: in memory only)"""
+    global _cache_file, _disk
+    with _lock:
+        _cache_file, _disk = path, None
+
+
+def winners():
+    """the variants chosen so far, {(op, config, size bucket): name}"""
+    return dict(_winners)
+
+
+def clear():
+    """forget the winners tuned in memory (the cache file is left as it is)"""
+    global _disk
+    with _lock:
+        _winners.clear()
+        _disk = None
+
+
+def _override(op):
+    spec = os.environ.get("QTORCH_KERNEL_VARIANT", "")
+    for item in filter(None, spec.split(",")):
+        if "=" not in item:
+            return item.strip()
+        name, value = item.split("=", 1)
+        if name.strip() == op:
+            return value.strip()
+    return None
+
+
+def _machine():
+    cpu = platform.processor() or platform.machine()
+    return "{} cpus={} threads={}".format(cpu, os.cpu_count(), torch.get_num_threads())
+
+
+def _entry(key):
+    op, config, bucket = key
+    return "{}{}@{}".format(op, list(config), bucket)
+
+
+def _read_cache():
+    try:
+        with open(_cache_file) as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return {}
+
+
+def _load(key):
+    global _disk
+    if _cache_file is None:
+        return None
+    with _lock:
+        if _disk is None:
+            _disk = _read_cache().get(_machine(), {})
+        return _disk.get(_entry(key))
+
+
+def _save(key, name):
+    if _cache_file is None:
+        return
+    with _lock:
+        cache = _read_cache()
+        cache.setdefault(_machine(), {})[_entry(key)] = name
+        tmp = "{}.{}.tmp".format(_cache_file, os.getpid())
+        with open(tmp, "w") as f:
+            json.dump(cache, f, indent=1, sort_keys=True)
+        os.replace(tmp, _cache_file)
+        if _disk is not None:
+            _disk[_entry(key)] = name
+
+
+def _tune(op, candidates, x, args):
+    """the output and name of the fastest candidate, the best of REPEATS runs each"""
+    best, best_time, out = None, float("inf"), None
+    for name in candidates:
+        fn = _variants[op][name][0]
+        elapsed = float("inf")
+        for _ in range(REPEATS):
+            start = time.perf_counter()
+            result = fn(x, *args)
+            elapsed = min(elapsed, time.perf_counter() - start)
+        if elapsed < best_time:
+            best, best_time, out = name, elapsed, result
+    return out, best
+
+
+def dispatch(op, config, x, *args):
+    """
+    Run `op` on x with its fastest variant for `config` (the hashable arguments the choice
+    depends on, e.g. (nsize, es)) and the size of x, rounded up to a power of two.
+    `args` are passed to the variant after x.
+    """
+    candidates = [name for name, (_, applies) in _variants[op].items() if applies(*config)]
+    forced = _override(op)
+    if forced is not None and forced in _variants[op]:
+        assert forced in candidates, "variant {} of {} does not apply to {}".format(forced, op, config)
+        return _variants[op][forced][0](x, *args)
+    key = (op, tuple(config), x.numel().bit_length())
+    name = _winners.get(key) or _load(key)
+    if name in candidates:
+        _winners[key] = name
+        return _variants[op][name][0](x, *args)
+    out, name = _tune(op, candidates, x, args)
+    _winners[key] = name
+    _save(key, name)
+    return out
@@ -1,7 +1,11 @@
 #include <torch/torch.h>
+#include <ATen/Parallel.h>
 #include <assert.h>
 #include <random>
 #include <tuple>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
 #include "quant_cpu.h"
 
 using namespace at;
@@ -483,119 +487,1672 @@ Tensor posit_quantize_nearest(Tensor a, int nsize, int es, float scale)
   return o;
 }
 
-fp16 compute_sigmoid(fp16 p) {
-    p ^= 0x8000;
-    return p >> 2;
+/* elements per task of the multithreaded kernels */
+#define PACK_GRAIN_SIZE 4096
+
+/* posit_quantize_nearest split over threads, one of the variants the Python side picks
+   from by timing (see qtorch.quant.autotune) */
+Tensor posit_quantize_nearest_parallel(Tensor a, int nsize, int es, float scale)
+{
+  CHECK_INPUT(a);
+  auto a_array = a.data_ptr<float>();
+  Tensor o = torch::empty_like(a);
+  auto o_array = o.data_ptr<float>();
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+
+  at::parallel_for(0, a.numel(), PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      fp16 temp = fp32tofp16(a_array[i] * scale, int32_constants, int64_constants);
+      o_array[i] = fp16tofp32(temp, int32_constants, int64_constants) / scale;
+    }
+  });
+  return o;
+}
+
+/* Packed posit storage: nsize <= 8 keeps the top byte of the left-aligned fp16
+   pattern in a uint8 tensor, nsize <= 16 keeps the whole pattern in an int16 tensor */
+Tensor posit_pack(Tensor a, int nsize, int es, float scale)
+{
+  CHECK_INPUT(a);
+  TORCH_CHECK(nsize <= 16, "packed posit storage only supports nsize <= 16");
+  auto a_array = a.data_ptr<float>();
+  int64_t size = a.numel();
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+
+  if (nsize <= 8)
+  {
+    Tensor o = torch::empty_like(a, torch::TensorOptions().dtype(torch::kUInt8));
+    auto o_array = o.data_ptr<uint8_t>();
+    at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++)
+        o_array[i] = fp32tofp16(a_array[i] * scale, int32_constants, int64_constants) >> 8;
+    });
+    return o;
+  }
+
+  Tensor o = torch::empty_like(a, torch::TensorOptions().dtype(torch::kInt16));
+  auto o_array = o.data_ptr<int16_t>();
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+      o_array[i] = fp32tofp16(a_array[i] * scale, int32_constants, int64_constants);
+  });
+  return o;
+}
+
+Tensor posit_unpack(Tensor p, int nsize, int es, float scale)
+{
+  CHECK_INPUT(p);
+  TORCH_CHECK(nsize <= 16, "packed posit storage only supports nsize <= 16");
+  auto o = torch::empty_like(p, torch::TensorOptions().dtype(torch::kFloat));
+  auto o_array = o.data_ptr<float>();
+  int64_t size = p.numel();
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+
+  if (nsize <= 8)
+  {
+    TORCH_CHECK(p.scalar_type() == torch::kUInt8, "posit(nsize <= 8) must be packed as uint8");
+    auto p_array = p.data_ptr<uint8_t>();
+    at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++)
+        o_array[i] = fp16tofp32((fp16)(p_array[i] << 8), int32_constants, int64_constants) / scale;
+    });
+    return o;
+  }
+
+  TORCH_CHECK(p.scalar_type() == torch::kInt16, "posit(nsize <= 16) must be packed as int16");
+  auto p_array = p.data_ptr<int16_t>();
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+      o_array[i] = fp16tofp32((fp16)p_array[i], int32_constants, int64_constants) / scale;
+  });
+  return o;
+}
+
+/* pack only if every value survives the round trip, e.g. activations already rounded
+   by a posit quantizer; returns the packed bits and whether the packing is exact */
+template <typename T>
+bool pack_exact_helper(float* a_array, T* o_array, int64_t size, float scale, int shift,
+                       uint32_t* int32_constants, uint64_t* int64_constants)
+{
+  std::atomic<bool> exact(true);
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end && exact.load(std::memory_order_relaxed); i++)
+    {
+      fp16 bits = fp32tofp16(a_array[i] * scale, int32_constants, int64_constants);
+      if (fp16tofp32(bits, int32_constants, int64_constants) / scale != a_array[i])
+        exact.store(false, std::memory_order_relaxed);
+      o_array[i] = (T)(bits >> shift);
+    }
+  });
+  return exact.load();
+}
+
+std::tuple<Tensor, bool> posit_pack_exact(Tensor a, int nsize, int es, float scale)
+{
+  CHECK_INPUT(a);
+  TORCH_CHECK(nsize <= 16, "packed posit storage only supports nsize <= 16");
+  int64_t size = a.numel();
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+
+  if (nsize <= 8)
+  {
+    Tensor o = torch::empty_like(a, torch::TensorOptions().dtype(torch::kUInt8));
+    bool exact = pack_exact_helper<uint8_t>(a.data_ptr<float>(), o.data_ptr<uint8_t>(), size, scale, 8,
+                                            int32_constants, int64_constants);
+    return std::make_tuple(o, exact);
+  }
+  Tensor o = torch::empty_like(a, torch::TensorOptions().dtype(torch::kInt16));
+  bool exact = pack_exact_helper<int16_t>(a.data_ptr<float>(), o.data_ptr<int16_t>(), size, scale, 0,
+                                          int32_constants, int64_constants);
+  return std::make_tuple(o, exact);
+}
+
+/* decode a [world, n] stack of packed rows, each with its own scale, and sum over
+   the rows in one pass (gradient exchange in qtorch.distributed) */
+Tensor posit_unpack_sum(Tensor p, Tensor scales, int nsize, int es)
+{
+  CHECK_INPUT(p);
+  CHECK_INPUT(scales);
+  TORCH_CHECK(nsize <= 16, "packed posit storage only supports nsize <= 16");
+  TORCH_CHECK(p.dim() == 2 && scales.numel() == p.size(0), "expected [rows, n] packed tensor and one scale per row");
+  int64_t rows = p.size(0);
+  int64_t size = p.size(1);
+  auto o = torch::empty({size}, torch::TensorOptions().dtype(torch::kFloat));
+  auto o_array = o.data_ptr<float>();
+  auto s_array = scales.data_ptr<float>();
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+
+  if (nsize <= 8)
+  {
+    TORCH_CHECK(p.scalar_type() == torch::kUInt8, "posit(nsize <= 8) must be packed as uint8");
+    auto p_array = p.data_ptr<uint8_t>();
+    at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++)
+      {
+        float acc = 0;
+        for (int64_t r = 0; r < rows; r++)
+          acc += fp16tofp32((fp16)(p_array[r * size + i] << 8), int32_constants, int64_constants) / s_array[r];
+        o_array[i] = acc;
+      }
+    });
+    return o;
+  }
+
+  TORCH_CHECK(p.scalar_type() == torch::kInt16, "posit(nsize <= 16) must be packed as int16");
+  auto p_array = p.data_ptr<int16_t>();
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      float acc = 0;
+      for (int64_t r = 0; r < rows; r++)
+        acc += fp16tofp32((fp16)p_array[r * size + i], int32_constants, int64_constants) / s_array[r];
+      o_array[i] = acc;
+    }
+  });
+  return o;
+}
+
+/* stochastic rounding between the two posits around f; posit bit patterns are
+   ordered like two's complement integers, so the other neighbour is one step away */
+fp16 fp32tofp16_stochastic(float f, float r, uint32_t* int32_constants, uint64_t* int64_constants)
+{
+  fp16 p = fp32tofp16(f, int32_constants, int64_constants);
+  float v = fp16tofp32(p, int32_constants, int64_constants);
+  if (v == f || std::isnan(f))
+    return p;
+  int16_t step = 1 << _G_POSIT_SHIFT_AMOUNT;
+  fp16 q = (fp16)((int16_t)p + (v < f ? step : -step));
+  if (q == _G_INFP) // never round into NaR past maxpos
+    return p;
+  float vq = fp16tofp32(q, int32_constants, int64_constants);
+  return (r < (f - v) / (vq - v)) ? q : p;
+}
+
+/* 256-entry decode table for nsize <= 8, indexed by the packed byte */
+void posit8_decode_table(float* table, uint32_t* int32_constants, uint64_t* int64_constants)
+{
+  for (int i = 0; i < 256; i++)
+    table[i] = fp16tofp32((fp16)(i << 8), int32_constants, int64_constants);
+}
+
+/* gather rows of a packed posit table and decode them straight into fp32 */
+template <typename T>
+void embedding_gather_helper(T* w_array, int64_t* idx_array, float* rs_array, float* o_array,
+                             int64_t n, int64_t dim, int64_t rows, const float* table,
+                             uint32_t* int32_constants, uint64_t* int64_constants)
+{
+  at::parallel_for(0, n, PACK_GRAIN_SIZE / dim + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      int64_t row = idx_array[i];
+      TORCH_CHECK(row >= 0 && row < rows, "embedding index out of range");
+      T* w_row = w_array + row * dim;
+      float* o_row = o_array + i * dim;
+      float inv_scale = rs_array ? 1.0f / rs_array[row] : 1.0f;
+      for (int64_t j = 0; j < dim; j++)
+        o_row[j] = (table ? table[(uint8_t)w_row[j]] : fp16tofp32((fp16)w_row[j], int32_constants, int64_constants)) * inv_scale;
+    }
+  });
+}
+
+Tensor posit_embedding_forward(Tensor weight, Tensor indices, Tensor row_scale, int nsize, int es)
+{
+  CHECK_INPUT(weight);
+  CHECK_INPUT(indices);
+  TORCH_CHECK(weight.dim() == 2, "packed embedding table must be 2D");
+  TORCH_CHECK(indices.scalar_type() == torch::kLong, "indices must be int64");
+  int64_t rows = weight.size(0);
+  int64_t dim = weight.size(1);
+  int64_t n = indices.numel();
+  std::vector<int64_t> out_size = indices.sizes().vec();
+  out_size.push_back(dim);
+  auto o = torch::empty(out_size, torch::TensorOptions().dtype(torch::kFloat));
+  float* rs_array = row_scale.numel() ? row_scale.data_ptr<float>() : nullptr;
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+
+  if (nsize <= 8)
+  {
+    TORCH_CHECK(weight.scalar_type() == torch::kUInt8, "posit(nsize <= 8) must be packed as uint8");
+    float table[256];
+    posit8_decode_table(table, int32_constants, int64_constants);
+    embedding_gather_helper<uint8_t>(weight.data_ptr<uint8_t>(), indices.data_ptr<int64_t>(), rs_array,
+                                     o.data_ptr<float>(), n, dim, rows, table, int32_constants, int64_constants);
+  }
+  else
+  {
+    TORCH_CHECK(weight.scalar_type() == torch::kInt16, "posit(nsize <= 16) must be packed as int16");
+    embedding_gather_helper<int16_t>(weight.data_ptr<int16_t>(), indices.data_ptr<int64_t>(), rs_array,
+                                     o.data_ptr<float>(), n, dim, rows, nullptr, int32_constants, int64_constants);
+  }
+  return o;
+}
+
+/* sum/mean pooling over bags given by offsets, decoding each gathered row on the fly */
+template <typename T>
+void embedding_bag_helper(T* w_array, int64_t* idx_array, int64_t* off_array, float* psw_array, float* rs_array,
+                          float* o_array, int64_t n, int64_t bags, int64_t dim, int64_t rows, bool mean,
+                          const float* table, uint32_t* int32_constants, uint64_t* int64_constants)
+{
+  at::parallel_for(0, bags, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++)
+    {
+      int64_t first = off_array[b];
+      int64_t last = (b + 1 < bags) ? off_array[b + 1] : n;
+      float* o_row = o_array + b * dim;
+      for (int64_t j = 0; j < dim; j++)
+        o_row[j] = 0;
+      for (int64_t k = first; k < last; k++)
+      {
+        int64_t row = idx_array[k];
+        TORCH_CHECK(row >= 0 && row < rows, "embedding index out of range");
+        T* w_row = w_array + row * dim;
+        float weight = (rs_array ? 1.0f / rs_array[row] : 1.0f) * (psw_array ? psw_array[k] : 1.0f);
+        for (int64_t j = 0; j < dim; j++)
+          o_row[j] += (table ? table[(uint8_t)w_row[j]] : fp16tofp32((fp16)w_row[j], int32_constants, int64_constants)) * weight;
+      }
+      if (mean && last > first)
+        for (int64_t j = 0; j < dim; j++)
+          o_row[j] /= (float)(last - first);
+    }
+  });
+}
+
+Tensor posit_embedding_bag_forward(Tensor weight, Tensor indices, Tensor offsets, Tensor per_sample_weights,
+                                   Tensor row_scale, bool mean, int nsize, int es)
+{
+  CHECK_INPUT(weight);
+  CHECK_INPUT(indices);
+  CHECK_INPUT(offsets);
+  TORCH_CHECK(weight.dim() == 2, "packed embedding table must be 2D");
+  TORCH_CHECK(indices.scalar_type() == torch::kLong && offsets.scalar_type() == torch::kLong, "indices and offsets must be int64");
+  int64_t rows = weight.size(0);
+  int64_t dim = weight.size(1);
+  int64_t n = indices.numel();
+  int64_t bags = offsets.numel();
+  auto o = torch::empty({bags, dim}, torch::TensorOptions().dtype(torch::kFloat));
+  float* rs_array = row_scale.numel() ? row_scale.data_ptr<float>() : nullptr;
+  float* psw_array = per_sample_weights.numel() ? per_sample_weights.data_ptr<float>() : nullptr;
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+
+  if (nsize <= 8)
+  {
+    TORCH_CHECK(weight.scalar_type() == torch::kUInt8, "posit(nsize <= 8) must be packed as uint8");
+    float table[256];
+    posit8_decode_table(table, int32_constants, int64_constants);
+    embedding_bag_helper<uint8_t>(weight.data_ptr<uint8_t>(), indices.data_ptr<int64_t>(), offsets.data_ptr<int64_t>(),
+                                  psw_array, rs_array, o.data_ptr<float>(), n, bags, dim, rows, mean, table,
+                                  int32_constants, int64_constants);
+  }
+  else
+  {
+    TORCH_CHECK(weight.scalar_type() == torch::kInt16, "posit(nsize <= 16) must be packed as int16");
+    embedding_bag_helper<int16_t>(weight.data_ptr<int16_t>(), indices.data_ptr<int64_t>(), offsets.data_ptr<int64_t>(),
+                                  psw_array, rs_array, o.data_ptr<float>(), n, bags, dim, rows, mean, nullptr,
+                                  int32_constants, int64_constants);
+  }
+  return o;
+}
+
+/* in-place SGD step on the rows of a packed table: decode, subtract lr * grad and
+   re-encode with stochastic rounding. indices must be unique (grad coalesced). */
+template <typename T>
+void embedding_update_helper(T* w_array, int64_t* idx_array, float* g_array, float* r_array, float* rs_array,
+                             int64_t n, int64_t dim, int64_t rows, float lr, int shift,
+                             uint32_t* int32_constants, uint64_t* int64_constants)
+{
+  at::parallel_for(0, n, PACK_GRAIN_SIZE / dim + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      int64_t row = idx_array[i];
+      TORCH_CHECK(row >= 0 && row < rows, "embedding index out of range");
+      T* w_row = w_array + row * dim;
+      float* g_row = g_array + i * dim;
+      float* r_row = r_array + i * dim;
+      float scale = rs_array ? rs_array[row] : 1.0f;
+      for (int64_t j = 0; j < dim; j++)
+      {
+        fp16 bits = (fp16)(w_row[j] << shift);
+        float value = fp16tofp32(bits, int32_constants, int64_constants) - lr * g_row[j] * scale;
+        bits = fp32tofp16_stochastic(value, r_row[j], int32_constants, int64_constants);
+        w_row[j] = (T)(bits >> shift);
+      }
+    }
+  });
+}
+
+void posit_embedding_sparse_update(Tensor weight, Tensor indices, Tensor grad, Tensor row_scale, float lr, int nsize, int es)
+{
+  CHECK_INPUT(weight);
+  CHECK_INPUT(indices);
+  CHECK_INPUT(grad);
+  TORCH_CHECK(weight.dim() == 2 && grad.dim() == 2 && grad.size(0) == indices.numel() && grad.size(1) == weight.size(1),
+              "expected one gradient row per index");
+  int64_t rows = weight.size(0);
+  int64_t dim = weight.size(1);
+  int64_t n = indices.numel();
+  auto r = torch::rand_like(grad);
+  float* rs_array = row_scale.numel() ? row_scale.data_ptr<float>() : nullptr;
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+
+  if (nsize <= 8)
+  {
+    TORCH_CHECK(weight.scalar_type() == torch::kUInt8, "posit(nsize <= 8) must be packed as uint8");
+    embedding_update_helper<uint8_t>(weight.data_ptr<uint8_t>(), indices.data_ptr<int64_t>(), grad.data_ptr<float>(),
+                                     r.data_ptr<float>(), rs_array, n, dim, rows, lr, 8, int32_constants, int64_constants);
+  }
+  else
+  {
+    TORCH_CHECK(weight.scalar_type() == torch::kInt16, "posit(nsize <= 16) must be packed as int16");
+    embedding_update_helper<int16_t>(weight.data_ptr<int16_t>(), indices.data_ptr<int64_t>(), grad.data_ptr<float>(),
+                                     r.data_ptr<float>(), rs_array, n, dim, rows, lr, 0, int32_constants, int64_constants);
+  }
+}
+
+/* Element-wise posit arithmetic. The result of an operation on fp32 operands is
+   computed in double together with the error double precision made (TwoSum, or the
+   fma remainder), rounded to odd to fp32 so that a lost bit still counts as sticky,
+   and then rounded once to the posit: 24 bits leave enough room for the posit's
+   rounding bits, so the two-step rounding is exact. */
+enum PositOp
+{
+  pAdd,
+  pSub,
+  pMul,
+  pDiv,
+  pFma,
+  pSqrt
+};
+
+float round_to_odd(double s, double e)
+{
+  float f = (float)s;
+  if (!std::isfinite(f)) // past fp32, posits saturate at maxpos anyway
+    return std::isfinite(s) ? std::copysign(FLT_MAX, f) : f;
+  double d = f;
+  if (d == s && e == 0)
+    return f;
+  // the exact result lies strictly between f and its neighbour on the side of s + e
+  float g = std::nextafter(f, (d != s ? s > d : e > 0) ? INFINITY : -INFINITY);
+  uint32_t f_bits;
+  FLOAT_TO_BITS(f, f_bits);
+  return (f_bits & 1) ? f : g;
+}
+
+/* s + *e is the exact result: *e is exact for sums and only its sign is kept for
+   the quotient and the square root */
+template <int OP>
+double exact_op(float x, float y, float z, double *e)
+{
+  double s, u, v;
+  switch (OP)
+  {
+  case pMul:
+    *e = 0; // 24 x 24 bit products fit in a double
+    return (double)x * y;
+  case pDiv:
+    s = (double)x / y;
+    *e = -std::fma(s, (double)y, -(double)x) / y;
+    return s;
+  case pSqrt:
+    s = std::sqrt((double)x);
+    *e = -std::fma(s, s, -(double)x);
+    return s;
+  default:
+    u = OP == pFma ? (double)x * y : (double)x;
+    v = OP == pFma ? (double)z : OP == pSub ? -(double)y : (double)y;
+    s = u + v;
+    *e = (u - (s - (s - u))) + (v - (s - u));
+    return s;
+  }
+}
+
+/* an operand: fp32 values or packed posit bits, one element broadcast to all */
+struct PositOperand
+{
+  const float *f;
+  const uint8_t *p8;
+  const int16_t *p16;
+  int64_t step;
+};
+
+PositOperand posit_operand(Tensor t, int64_t size, int nsize)
+{
+  CHECK_INPUT(t);
+  TORCH_CHECK(t.numel() == size || t.numel() == 1, "operands must have the same number of elements, or one");
+  PositOperand o = {nullptr, nullptr, nullptr, t.numel() == 1 ? 0 : 1};
+  if (t.scalar_type() == torch::kUInt8)
+  {
+    TORCH_CHECK(nsize <= 8, "uint8 packed posits need nsize <= 8");
+    o.p8 = t.data_ptr<uint8_t>();
+  }
+  else if (t.scalar_type() == torch::kInt16)
+  {
+    TORCH_CHECK(nsize > 8, "posit(nsize <= 8) must be packed as uint8");
+    o.p16 = t.data_ptr<int16_t>();
+  }
+  else
+  {
+    TORCH_CHECK(t.scalar_type() == torch::kFloat, "operands must be float or packed posit tensors");
+    o.f = t.data_ptr<float>();
+  }
+  return o;
+}
+
+inline float operand_value(const PositOperand &o, int64_t i, const float *table, float scale,
+                           uint32_t *int32_constants, uint64_t *int64_constants)
+{
+  int64_t j = i * o.step;
+  if (o.f)
+    return o.f[j];
+  if (o.p8)
+    return table[o.p8[j]] / scale;
+  return fp16tofp32((fp16)o.p16[j], int32_constants, int64_constants) / scale;
+}
+
+/* one pass: decode the operands, compute, round to posit(result * scale) and store it
+   packed like a, or as fp32 if a is fp32 */
+template <int OP>
+Tensor posit_elementwise(Tensor a, Tensor b, Tensor c, int nsize, int es, float scale)
+{
+  TORCH_CHECK(nsize <= 16, "posit arithmetic only supports nsize <= 16");
+  Tensor ref = a.numel() >= b.numel() && a.numel() >= c.numel() ? a : (b.numel() >= c.numel() ? b : c);
+  int64_t size = ref.numel();
+  PositOperand x = posit_operand(a, size, nsize);
+  PositOperand y = posit_operand(b, size, nsize);
+  PositOperand z = posit_operand(c, size, nsize);
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+  float table[256];
+  if (nsize <= 8)
+    posit8_decode_table(table, int32_constants, int64_constants);
+
+  Tensor o = torch::empty(ref.sizes(), torch::TensorOptions().dtype(a.scalar_type()));
+  uint8_t *o8 = x.p8 ? o.data_ptr<uint8_t>() : nullptr;
+  int16_t *o16 = x.p16 ? o.data_ptr<int16_t>() : nullptr;
+  float *of = x.f ? o.data_ptr<float>() : nullptr;
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      double e;
+      float xv = operand_value(x, i, table, scale, int32_constants, int64_constants);
+      float yv = OP == pSqrt ? 0 : operand_value(y, i, table, scale, int32_constants, int64_constants);
+      float zv = OP == pFma ? operand_value(z, i, table, scale, int32_constants, int64_constants) : 0;
+      double s = exact_op<OP>(xv, yv, zv, &e);
+      fp16 bits = fp32tofp16(round_to_odd(s * scale, e * scale), int32_constants, int64_constants);
+      if (o8)
+        o8[i] = bits >> 8;
+      else if (o16)
+        o16[i] = bits;
+      else
+        of[i] = fp16tofp32(bits, int32_constants, int64_constants) / scale;
+    }
+  });
+  return o;
+}
+
+Tensor posit_add(Tensor a, Tensor b, int nsize, int es, float scale)
+{
+  return posit_elementwise<pAdd>(a, b, a, nsize, es, scale);
+}
+
+Tensor posit_sub(Tensor a, Tensor b, int nsize, int es, float scale)
+{
+  return posit_elementwise<pSub>(a, b, a, nsize, es, scale);
+}
+
+Tensor posit_mul(Tensor a, Tensor b, int nsize, int es, float scale)
+{
+  return posit_elementwise<pMul>(a, b, a, nsize, es, scale);
+}
+
+Tensor posit_div(Tensor a, Tensor b, int nsize, int es, float scale)
+{
+  return posit_elementwise<pDiv>(a, b, a, nsize, es, scale);
+}
+
+/* a * b + c with a single rounding */
+Tensor posit_fma(Tensor a, Tensor b, Tensor c, int nsize, int es, float scale)
+{
+  return posit_elementwise<pFma>(a, b, c, nsize, es, scale);
+}
+
+Tensor posit_sqrt(Tensor a, int nsize, int es, float scale)
+{
+  return posit_elementwise<pSqrt>(a, a, a, nsize, es, scale);
+}
+
+/* Exact posit reductions. The quire is a two's complement fixed point number whose
+   lsb is minpos^2, with room for maxpos^2 and 63 carry bits: every posit and every
+   product of two posits is added exactly, so per-thread quires merge into the same
+   sum for any split, and the result is rounded to posit once. */
+#define QUIRE_LIMBS 9
+
+struct PositQuire
+{
+  uint64_t limb[QUIRE_LIMBS];
+  bool nar;
+};
+
+int quire_lsb(int nsize, int es) // -log2(minpos^2)
+{
+  return 2 * ((nsize - 2) << es);
+}
+
+int quire_limbs(int nsize, int es)
+{
+  return (4 * ((nsize - 2) << es) + 66 + 63) / 64;
+}
+
+/* q += m * 2^shift, or q -= m * 2^shift */
+void quire_add(PositQuire &q, int limbs, uint64_t m, int shift, bool negative)
+{
+  int k = shift >> 6, o = shift & 63;
+  uint64_t part[2] = {m << o, o ? m >> (64 - o) : 0};
+  uint64_t carry = 0;
+  for (int i = k; i < limbs && (i < k + 2 || carry); i++)
+  {
+    uint64_t x = i < k + 2 ? part[i - k] : 0;
+    unsigned __int128 t = negative ? (unsigned __int128)q.limb[i] - x - carry : (unsigned __int128)q.limb[i] + x + carry;
+    q.limb[i] = (uint64_t)t;
+    carry = (uint64_t)(t >> 64) != 0;
+  }
+}
+
+void quire_merge(PositQuire &q, const PositQuire &r, int limbs)
+{
+  uint64_t carry = 0;
+  for (int i = 0; i < limbs; i++)
+  {
+    unsigned __int128 t = (unsigned __int128)q.limb[i] + r.limb[i] + carry;
+    q.limb[i] = (uint64_t)t;
+    carry = (uint64_t)(t >> 64);
+  }
+  q.nar |= r.nar;
+}
+
+/* q * 2^-lsb / divisor rounded to odd, so that rounding it once more is exact */
+double quire_to_double(const PositQuire &q, int limbs, int lsb, uint64_t divisor)
+{
+  // magnitude, with two more limbs of fraction to divide into
+  uint64_t m[QUIRE_LIMBS + 2] = {0, 0};
+  bool negative = q.limb[limbs - 1] >> 63;
+  uint64_t carry = negative;
+  for (int i = 0; i < limbs; i++)
+  {
+    m[i + 2] = (negative ? ~q.limb[i] : q.limb[i]) + carry;
+    carry = carry && m[i + 2] == 0;
+  }
+  int n = limbs + 2;
+  bool sticky = false;
+  if (divisor > 1)
+  {
+    unsigned __int128 rem = 0;
+    for (int i = n - 1; i >= 0; i--)
+    {
+      rem = (rem << 64) | m[i];
+      m[i] = (uint64_t)(rem / divisor);
+      rem %= divisor;
+    }
+    sticky = rem != 0;
+  }
+  int top = n - 1;
+  while (top >= 0 && m[top] == 0)
+    top--;
+  if (top < 0)
+    return 0;
+  int start = std::max(64 * top + 63 - __builtin_clzll(m[top]) - 52, 0);
+  int li = start >> 6, lo = start & 63;
+  unsigned __int128 w = m[li] | (li + 1 < n ? (unsigned __int128)m[li + 1] << 64 : 0);
+  uint64_t mant = (uint64_t)(w >> lo) & ((1ULL << 53) - 1);
+  sticky |= lo && (m[li] << (64 - lo)) != 0;
+  for (int i = 0; i < li; i++)
+    sticky |= m[i] != 0;
+  double d = std::ldexp((double)(mant | sticky), start - 128 - lsb);
+  return negative ? -d : d;
+}
+
+/* posit bits of an operand, in the scaled domain the quire works in */
+inline fp16 operand_bits(const PositOperand &o, int64_t i, float scale,
+                         uint32_t *int32_constants, uint64_t *int64_constants)
+{
+  int64_t j = i * o.step;
+  if (o.f)
+    return fp32tofp16(o.f[j] * scale, int32_constants, int64_constants);
+  if (o.p8)
+    return (fp16)(o.p8[j] << 8);
+  return (fp16)o.p16[j];
+}
+
+/* a nonzero posit value as +-m * 2^e with m odd */
+inline bool posit_term(fp16 bits, const float *table, uint64_t *m, int *e,
+                       uint32_t *int32_constants, uint64_t *int64_constants)
+{
+  float v = table ? table[bits >> 8] : fp16tofp32(bits, int32_constants, int64_constants);
+  uint32_t v_bits;
+  FLOAT_TO_BITS(v, v_bits);
+  uint64_t mant = (v_bits & FLOAT_FRACTION_MASK) | FLOAT_HIDDEN_BIT_SET_MASK;
+  int tz = __builtin_ctzll(mant);
+  *m = mant >> tz;
+  *e = (int)((v_bits >> FLOAT_EXPONENT_SHIFT) & 0xFF) - SINGLE_PRECISION_BIAS - 23 + tz;
+  return v_bits >> FLOAT_SIGN_SHIFT;
+}
+
+/* sum (or dot product) of every row of [rows, n] operands, optionally divided by n */
+Tensor posit_reduce(Tensor a, Tensor b, bool dot, bool mean, int nsize, int es, float scale)
+{
+  TORCH_CHECK(nsize <= 16, "posit reductions only support nsize <= 16");
+  TORCH_CHECK(a.dim() == 2 && (!dot || b.sizes().vec() == a.sizes().vec()), "expected [rows, n] operands of the same shape");
+  int64_t rows = a.size(0);
+  int64_t n = a.size(1);
+  PositOperand x = posit_operand(a, rows * n, nsize);
+  PositOperand y = posit_operand(b, rows * n, nsize);
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+
+  generate_posit_constants(nsize, es, int32_constants, int64_constants);
+  float table[256];
+  if (nsize <= 8)
+    posit8_decode_table(table, int32_constants, int64_constants);
+  const float *t = nsize <= 8 ? table : nullptr;
+  int lsb = quire_lsb(nsize, es);
+  int limbs = quire_limbs(nsize, es);
+  TORCH_CHECK(limbs <= QUIRE_LIMBS, "the quire of this posit format needs more than ", 64 * QUIRE_LIMBS, " bits");
+
+  Tensor o = torch::empty({rows}, torch::TensorOptions().dtype(a.scalar_type()));
+  uint8_t *o8 = x.p8 ? o.data_ptr<uint8_t>() : nullptr;
+  int16_t *o16 = x.p16 ? o.data_ptr<int16_t>() : nullptr;
+  float *of = x.f ? o.data_ptr<float>() : nullptr;
+
+  auto accumulate = [&](PositQuire &q, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      uint64_t m, m2;
+      int e, e2;
+      fp16 p = operand_bits(x, i, scale, int32_constants, int64_constants);
+      fp16 p2 = dot ? operand_bits(y, i, scale, int32_constants, int64_constants) : 0;
+      if (p == _G_INFP || p2 == _G_INFP)
+        q.nar = true;
+      else if (p != 0 && !dot)
+      {
+        bool negative = posit_term(p, t, &m, &e, int32_constants, int64_constants);
+        quire_add(q, limbs, m, e + lsb, negative);
+      }
+      else if (p != 0 && p2 != 0)
+      {
+        bool negative = posit_term(p, t, &m, &e, int32_constants, int64_constants) !=
+                        posit_term(p2, t, &m2, &e2, int32_constants, int64_constants);
+        quire_add(q, limbs, m * m2, e + e2 + lsb, negative);
+      }
+    }
+  };
+  auto finish = [&](const PositQuire &q, int64_t r) {
+    fp16 bits = _G_INFP;
+    if (!q.nar && !(mean && n == 0))
+    {
+      double d = quire_to_double(q, limbs, lsb, mean ? n : 1);
+      // the dot product of scaled operands carries the scale twice
+      bits = fp32tofp16(round_to_odd(dot ? d / scale : d, 0), int32_constants, int64_constants);
+    }
+    if (o8)
+      o8[r] = bits >> 8;
+    else if (o16)
+      o16[r] = bits;
+    else
+      of[r] = fp16tofp32(bits, int32_constants, int64_constants) / scale;
+  };
+
+  if (rows == 1)
+  {
+    // one quire per thread, merged exactly
+    PositQuire zero = {};
+    PositQuire q = at::parallel_reduce(0, n, PACK_GRAIN_SIZE, zero,
+      [&](int64_t begin, int64_t end, PositQuire ident) {
+        accumulate(ident, begin, end);
+        return ident;
+      },
+      [&](PositQuire p, const PositQuire &r) {
+        quire_merge(p, r, limbs);
+        return p;
+      });
+    finish(q, 0);
+    return o;
+  }
+  at::parallel_for(0, rows, PACK_GRAIN_SIZE / (n + 1) + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++)
+    {
+      PositQuire q = {};
+      accumulate(q, r * n, (r + 1) * n);
+      finish(q, r);
+    }
+  });
+  return o;
+}
+
+Tensor posit_sum(Tensor a, int nsize, int es, float scale, bool mean)
+{
+  return posit_reduce(a, a, false, mean, nsize, es, scale);
+}
+
+Tensor posit_dot(Tensor a, Tensor b, int nsize, int es, float scale)
+{
+  return posit_reduce(a, b, true, false, nsize, es, scale);
+}
+
+/* Matmul with a low-precision accumulator: products are summed in double over each
+   chunk of k, then added to the running partial sum, which is rounded to the
+   accumulator's format. The rounding gets the exact sum (s + e) so that it is done once. */
+#define ACC_BLOCK 64
+
+struct FixedPointAccumulator
+{
+  int fl;
+  double t_min, t_max;
+  bool clamp;
+  double operator()(double s, double e) const
+  {
+    double v = std::ldexp(s, fl);
+    double r = std::nearbyint(v);
+    if (std::fabs(v - r) == 0.5 && e != 0) // not a tie once e is counted
+      r = e > 0 ? std::floor(v) + 1 : std::floor(v);
+    r = std::ldexp(r, -fl);
+    return clamp ? clamp_helper(r, t_min, t_max) : r;
+  }
+};
+
+struct FloatAccumulator
+{
+  int man_bits, exp_bits;
+  double operator()(double s, double e) const
+  {
+    if (man_bits >= 23)
+      return (float)s;
+    float f = round_to_odd(s, e);
+    unsigned int target;
+    FLOAT_TO_BITS(f, target);
+    unsigned int quantize_bits = round_bitwise(target, man_bits, rNearest);
+    quantize_bits = clip_exponent(exp_bits, man_bits, target, quantize_bits);
+    BITS_TO_FLOAT(quantize_bits, f);
+    return f;
+  }
+};
+
+struct PositAccumulator
+{
+  mutable uint32_t int32_constants[11]; // read only, the codec takes them mutable
+  mutable uint64_t int64_constants[2];
+  float scale;
+  double operator()(double s, double e) const
+  {
+    fp16 bits = fp32tofp16(round_to_odd(s * scale, e * scale), int32_constants, int64_constants);
+    return fp16tofp32(bits, int32_constants, int64_constants) / scale;
+  }
+};
+
+/* a [B, M, K] @ b [B, K, N], starting from c [B, M, N] (or zero if c is empty); a may
+   also hold a divisor of B matrices, used in turn (a weight per group of a convolution) */
+template <typename Q>
+Tensor accumulate_matmul(Tensor a, Tensor b, Tensor c, int chunk, const Q &quantize)
+{
+  CHECK_INPUT(a);
+  CHECK_INPUT(b);
+  TORCH_CHECK(a.dim() == 3 && b.dim() == 3 && a.size(2) == b.size(1), "expected [B, M, K] and [B, K, N] operands");
+  TORCH_CHECK(a.size(0) > 0 && b.size(0) % a.size(0) == 0, "the batch of a must divide the batch of b");
+  TORCH_CHECK(chunk > 0, "chunk must be positive");
+  int64_t batch = b.size(0), a_batch = a.size(0), m = a.size(1), k = a.size(2), n = b.size(2);
+  TORCH_CHECK(c.numel() == 0 || c.sizes().vec() == std::vector<int64_t>({batch, m, n}), "c must be empty or [B, M, N]");
+  CHECK_INPUT(c);
+  // rows of b^T, so that a chunk of every column is contiguous
+  Tensor bt = b.transpose(1, 2).contiguous();
+  const float *a_array = a.data_ptr<float>();
+  const float *b_array = bt.data_ptr<float>();
+  const float *c_array = c.numel() ? c.data_ptr<float>() : nullptr;
+  Tensor o = torch::empty({batch, m, n});
+  float *o_array = o.data_ptr<float>();
+
+  // a task is one row of a times a block of columns of b
+  int64_t blocks = (n + ACC_BLOCK - 1) / ACC_BLOCK;
+  int64_t grain = PACK_GRAIN_SIZE / (k * ACC_BLOCK + 1) + 1;
+  at::parallel_for(0, batch * m * blocks, grain, [&](int64_t begin, int64_t end) {
+    double acc[ACC_BLOCK];
+    for (int64_t t = begin; t < end; t++)
+    {
+      int64_t row = t / blocks; // batch * m + i
+      int64_t j0 = (t % blocks) * ACC_BLOCK, j1 = std::min(j0 + ACC_BLOCK, n);
+      const float *a_row = a_array + ((row / m) % a_batch * m + row % m) * k;
+      const float *b_rows = b_array + (row / m) * n * k;
+      for (int64_t j = j0; j < j1; j++)
+        acc[j - j0] = c_array ? c_array[row * n + j] : 0;
+      for (int64_t k0 = 0; k0 < k; k0 += chunk)
+      {
+        int64_t k1 = std::min(k0 + chunk, k);
+        for (int64_t j = j0; j < j1; j++)
+        {
+          const float *b_row = b_rows + j * k;
+          double s = 0;
+          for (int64_t l = k0; l < k1; l++)
+            s += (double)a_row[l] * b_row[l];
+          double u = acc[j - j0];
+          double v = u + s;
+          double e = (u - (v - (v - u))) + (s - (v - u));
+          acc[j - j0] = quantize(v, e);
+        }
+      }
+      for (int64_t j = j0; j < j1; j++)
+        o_array[row * n + j] = acc[j - j0];
+    }
+  });
+  return o;
+}
+
+Tensor fixed_point_accumulate_matmul(Tensor a, Tensor b, Tensor c, int chunk, int wl, int fl, bool clamp, bool symmetric)
+{
+  float t_min, t_max;
+  fixed_min_max(wl, fl, symmetric, &t_min, &t_max);
+  FixedPointAccumulator quantize = {fl, t_min, t_max, clamp};
+  return accumulate_matmul(a, b, c, chunk, quantize);
+}
+
+Tensor float_accumulate_matmul(Tensor a, Tensor b, Tensor c, int chunk, int man_bits, int exp_bits)
+{
+  FloatAccumulator quantize = {man_bits, exp_bits};
+  return accumulate_matmul(a, b, c, chunk, quantize);
+}
+
+Tensor posit_accumulate_matmul(Tensor a, Tensor b, Tensor c, int chunk, int nsize, int es, float scale)
+{
+  TORCH_CHECK(nsize <= 16, "posit accumulators only support nsize <= 16");
+  PositAccumulator quantize;
+  generate_posit_constants(nsize, es, quantize.int32_constants, quantize.int64_constants);
+  quantize.scale = scale;
+  return accumulate_matmul(a, b, c, chunk, quantize);
+}
+
+/* Microscaling (MX) blocks: every block_size consecutive elements along the last dim
+   share a power-of-two scale, stored as an 8-bit biased exponent (E8M0, 255 = NaN), and
+   each element is stored as a payload code of at most 8 bits. The scale puts the
+   block's largest magnitude at the element format's largest power of two. */
+#define MX_SCALE_BIAS 127
+#define MX_SCALE_NAN 255
+
+/* signed integer payload of wl bits with fl fraction bits (MXINT8 is wl=8, fl=6) */
+struct MXFixedPoint
+{
+  int wl, fl;
+  double lo, hi;
+  int bits() const { return wl; }
+  int emax() const { return wl - fl - 2; }
+  uint8_t encode(double v) const
+  {
+    double r = clamp_helper(std::nearbyint(std::ldexp(v, fl)), lo, hi);
+    return (uint8_t)((int)r & ((1 << wl) - 1));
+  }
+  float decode(uint8_t c) const
+  {
+    int i = c >= (1 << (wl - 1)) ? (int)c - (1 << wl) : c;
+    return std::ldexp((float)i, -fl);
+  }
+};
+
+/* sign, exp and man bits with subnormals and the OCP conventions: E5M2 keeps IEEE
+   infinities and NaNs, E4M3 only the NaN with every other bit set, and the narrower
+   formats use every code for a finite value. Encoding rounds to nearest even and
+   saturates at the largest finite value. */
+struct Minifloat
+{
+  int exp, man, bias, max_exponent;
+  double max_value;
+  Minifloat(int exp_bits, int man_bits) : exp(exp_bits), man(man_bits)
+  {
+    bias = (1 << (exp - 1)) - 1;
+    max_exponent = ieee() ? bias : (1 << exp) - 1 - bias;
+    max_value = std::ldexp(2.0 - std::ldexp(nan_code_only() ? 2.0 : 1.0, -man), max_exponent);
+  }
+  bool ieee() const { return exp == 5 && man == 2; }
+  bool nan_code_only() const { return exp == 4 && man == 3; }
+  int bits() const { return 1 + exp + man; }
+  int emax() const { return max_exponent; }
+  uint8_t encode(double v) const
+  {
+    uint8_t sign = std::signbit(v) ? 1 << (exp + man) : 0;
+    double a = std::fabs(v);
+    if (std::isnan(v))
+      return sign | (uint8_t)((1 << (exp + man)) - 1);
+    int e = a > 0 ? std::max(std::ilogb(a), 1 - bias) : 1 - bias;
+    double r = std::min(std::ldexp(std::nearbyint(std::ldexp(a, man - e)), e - man), max_value);
+    if (r == 0) // underflow keeps the sign, -0 has a code of its own
+      return sign;
+    e = std::ilogb(r);
+    if (e < 1 - bias) // subnormal
+      return sign | (uint8_t)std::ldexp(r, bias - 1 + man);
+    return sign | (uint8_t)((e + bias) << man) | (uint8_t)(std::ldexp(r, man - e) - (1 << man));
+  }
+  float decode(uint8_t c) const
+  {
+    int e = (c >> man) & ((1 << exp) - 1);
+    int m = c & ((1 << man) - 1);
+    float sign = (c >> (exp + man)) & 1 ? -1.0f : 1.0f;
+    if ((ieee() && e == (1 << exp) - 1) || (nan_code_only() && e == (1 << exp) - 1 && m == (1 << man) - 1))
+      return ieee() && m == 0 ? sign * INFINITY : NAN;
+    if (e == 0)
+      return sign * std::ldexp((float)m, 1 - bias - man);
+    return sign * std::ldexp((float)(m + (1 << man)), e - bias - man);
+  }
+};
+
+/* posit(nsize <= 8, es) payload, right-aligned; blocks are scaled into [1, 2), where
+   posits are the most accurate */
+struct MXPosit
+{
+  int nsize;
+  mutable uint32_t int32_constants[11]; // read only, the codec takes them mutable
+  mutable uint64_t int64_constants[2];
+  int bits() const { return nsize; }
+  int emax() const { return 0; }
+  uint8_t encode(double v) const
+  {
+    return fp32tofp16((float)v, int32_constants, int64_constants) >> (16 - nsize);
+  }
+  float decode(uint8_t c) const
+  {
+    return fp16tofp32((fp16)(c << (16 - nsize)), int32_constants, int64_constants);
+  }
+};
+
+/* one pass over each block: shared exponent, payload codes (two per byte for payloads of
+   4 bits or less) and the decoded fake-quantized values */
+template <typename E>
+std::tuple<Tensor, Tensor, Tensor> mx_quantize(Tensor a, int block_size, const E &element)
+{
+  CHECK_INPUT(a);
+  TORCH_CHECK(a.dim() > 0 && a.scalar_type() == torch::kFloat, "expected a float tensor");
+  TORCH_CHECK(block_size > 0 && block_size % 2 == 0, "block_size must be even");
+  int64_t n = a.size(-1);
+  int64_t rows = n ? a.numel() / n : 0;
+  int64_t blocks = (n + block_size - 1) / block_size;
+  int per_byte = element.bits() <= 4 ? 2 : 1;
+  int64_t row_bytes = (n + per_byte - 1) / per_byte;
+  std::vector<int64_t> shape = a.sizes().vec();
+  float table[256];
+  for (int c = 0; c < 256; c++)
+    table[c] = c < (1 << element.bits()) ? element.decode(c) : 0;
+
+  Tensor o = torch::empty(a.sizes());
+  shape.back() = row_bytes;
+  Tensor payload = torch::zeros(shape, torch::TensorOptions().dtype(torch::kUInt8));
+  shape.back() = blocks;
+  Tensor scales = torch::empty(shape, torch::TensorOptions().dtype(torch::kUInt8));
+  const float *a_array = a.data_ptr<float>();
+  float *o_array = o.data_ptr<float>();
+  uint8_t *p_array = payload.data_ptr<uint8_t>();
+  uint8_t *s_array = scales.data_ptr<uint8_t>();
+  at::parallel_for(0, rows * blocks, PACK_GRAIN_SIZE / block_size + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; t++)
+    {
+      int64_t r = t / blocks;
+      int64_t j0 = (t % blocks) * block_size, j1 = std::min(j0 + block_size, n);
+      const float *x = a_array + r * n;
+      float amax = 0;
+      bool finite = true;
+      for (int64_t j = j0; j < j1; j++)
+      {
+        finite &= std::isfinite(x[j]);
+        amax = std::max(amax, std::fabs(x[j]));
+      }
+      int s = !finite ? MX_SCALE_NAN : amax == 0 ? 0 : clamp_helper(std::ilogb(amax) - element.emax() + MX_SCALE_BIAS, 0, MX_SCALE_NAN - 1);
+      s_array[t] = s;
+      for (int64_t j = j0; j < j1; j++)
+      {
+        uint8_t code = finite ? element.encode(std::ldexp((double)x[j], MX_SCALE_BIAS - s)) : 0;
+        o_array[r * n + j] = finite ? std::ldexp((double)table[code], s - MX_SCALE_BIAS) : NAN;
+        p_array[r * row_bytes + j / per_byte] |= code << (per_byte == 2 ? 4 * (j & 1) : 0);
+      }
+    }
+  });
+  return std::make_tuple(o, payload, scales);
 }
 
-Tensor posit_sigmoid(Tensor a, int nsize, int es, float scale)
+template <typename E>
+Tensor mx_unpack(Tensor payload, Tensor scales, int block_size, int64_t n, const E &element)
 {
-  auto a_array = a.data_ptr<float>();
-  auto o = torch::zeros_like(a);
-  auto o_array = o.data_ptr<float>();
-  int size = a.numel();
-  uint32_t	int32_constants[ 11 ];
-  uint64_t	int64_constants[ 2 ];
-  //only works on nsize = 8 or 16
-  generate_posit_constants(nsize, 0, int32_constants, int64_constants);
+  CHECK_INPUT(payload);
+  CHECK_INPUT(scales);
+  TORCH_CHECK(payload.scalar_type() == torch::kUInt8 && scales.scalar_type() == torch::kUInt8, "expected uint8 payload and scales");
+  TORCH_CHECK(block_size > 0 && block_size % 2 == 0, "block_size must be even");
+  int64_t blocks = (n + block_size - 1) / block_size;
+  int per_byte = element.bits() <= 4 ? 2 : 1;
+  int64_t row_bytes = (n + per_byte - 1) / per_byte;
+  TORCH_CHECK(payload.dim() > 0 && payload.size(-1) == row_bytes && scales.sizes().vec().back() == blocks,
+              "payload and scales do not match n and block_size");
+  int64_t rows = row_bytes ? payload.numel() / row_bytes : 0;
+  TORCH_CHECK(scales.numel() == rows * blocks, "payload and scales must have the same rows");
+  float table[256];
+  for (int c = 0; c < 256; c++)
+    table[c] = c < (1 << element.bits()) ? element.decode(c) : 0;
+
+  std::vector<int64_t> shape = payload.sizes().vec();
+  shape.back() = n;
+  Tensor o = torch::empty(shape);
+  const uint8_t *p_array = payload.data_ptr<uint8_t>();
+  const uint8_t *s_array = scales.data_ptr<uint8_t>();
+  float *o_array = o.data_ptr<float>();
+  int mask = per_byte == 2 ? 0xF : 0xFF;
+  at::parallel_for(0, rows * blocks, PACK_GRAIN_SIZE / block_size + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; t++)
+    {
+      int64_t r = t / blocks;
+      int64_t j0 = (t % blocks) * block_size, j1 = std::min(j0 + block_size, n);
+      int s = s_array[t];
+      for (int64_t j = j0; j < j1; j++)
+      {
+        int code = (p_array[r * row_bytes + j / per_byte] >> (per_byte == 2 ? 4 * (j & 1) : 0)) & mask;
+        o_array[r * n + j] = s == MX_SCALE_NAN ? NAN : std::ldexp((double)table[code], s - MX_SCALE_BIAS);
+      }
+    }
+  });
+  return o;
+}
 
+MXFixedPoint mx_fixed_point(int wl, int fl, bool symmetric)
+{
+  TORCH_CHECK(wl >= 2 && wl <= 8, "MX integer payloads must have 2 to 8 bits");
+  float t_min, t_max;
+  fixed_min_max(wl, fl, symmetric, &t_min, &t_max);
+  MXFixedPoint element = {wl, fl, std::ldexp((double)t_min, fl), std::ldexp((double)t_max, fl)};
+  return element;
+}
 
-  for (int64_t i = 0; i < size; i++)
-  {
-    float temp_input = a_array[i];//*scale;
+Minifloat mx_float(int man_bits, int exp_bits)
+{
+  TORCH_CHECK(exp_bits >= 2 && man_bits >= 1 && 1 + exp_bits + man_bits <= 8, "MX float payloads must have at most 8 bits");
+  return Minifloat(exp_bits, man_bits);
+}
 
-    fp16 temp = fp32tofp16(temp_input, int32_constants, int64_constants);
+MXPosit mx_posit(int nsize, int es)
+{
+  TORCH_CHECK(nsize >= 3 && nsize <= 8, "MX posit payloads must have 3 to 8 bits");
+  MXPosit element;
+  element.nsize = nsize;
+  generate_posit_constants(nsize, es, element.int32_constants, element.int64_constants);
+  return element;
+}
 
-    temp = compute_sigmoid (temp);
+std::tuple<Tensor, Tensor, Tensor> fixed_point_mx_quantize(Tensor a, int block_size, int wl, int fl, bool symmetric)
+{
+  return mx_quantize(a, block_size, mx_fixed_point(wl, fl, symmetric));
+}
 
-    temp_input = fp16tofp32(temp, int32_constants, int64_constants);
+Tensor fixed_point_mx_unpack(Tensor payload, Tensor scales, int block_size, int64_t n, int wl, int fl)
+{
+  return mx_unpack(payload, scales, block_size, n, mx_fixed_point(wl, fl, false));
+}
+
+std::tuple<Tensor, Tensor, Tensor> float_mx_quantize(Tensor a, int block_size, int man_bits, int exp_bits)
+{
+  return mx_quantize(a, block_size, mx_float(man_bits, exp_bits));
+}
 
-    o_array[i] = temp_input;///scale;
+Tensor float_mx_unpack(Tensor payload, Tensor scales, int block_size, int64_t n, int man_bits, int exp_bits)
+{
+  return mx_unpack(payload, scales, block_size, n, mx_float(man_bits, exp_bits));
+}
 
-  }
+std::tuple<Tensor, Tensor, Tensor> posit_mx_quantize(Tensor a, int block_size, int nsize, int es)
+{
+  return mx_quantize(a, block_size, mx_posit(nsize, es));
+}
+
+Tensor posit_mx_unpack(Tensor payload, Tensor scales, int block_size, int64_t n, int nsize, int es)
+{
+  return mx_unpack(payload, scales, block_size, n, mx_posit(nsize, es));
+}
+
+/* FP8 E4M3 and E5M2 (OCP conventions, see Minifloat) with subnormals: finite values
+   saturate at the largest finite value (448 and 57344), infinities too in E4M3, which
+   has none, and NaN stays NaN. Encoding works on the fp32 bits without branches, so
+   the nearest loop vectorizes; decoding is a 256-entry table. */
+struct FP8Format
+{
+  int man, bias;
+  uint32_t max_code, inf_code, nan_code;
+};
+
+FP8Format fp8_format(int man_bits, int exp_bits)
+{
+  TORCH_CHECK((exp_bits == 4 && man_bits == 3) || (exp_bits == 5 && man_bits == 2), "FP8 is E4M3 or E5M2");
+  if (exp_bits == 4)
+    return {3, 7, 0x7E, 0x7E, 0x7F};
+  return {2, 15, 0x7B, 0x7C, 0x7F};
+}
+
+/* r in [0, 1) rounds stochastically, r < 0 to nearest even */
+inline uint8_t fp8_encode(float f, float r, const FP8Format &fmt)
+{
+  uint32_t u;
+  FLOAT_TO_BITS(f, u);
+  uint32_t a = u & 0x7FFFFFFF;
+  int e = std::max((int)(a >> 23), 1) - SINGLE_PRECISION_BIAS;
+  uint32_t mant = (a & 0x7FFFFF) | ((uint32_t)(a >= 0x800000) << 23);
+  // bits dropped from the 24-bit significand: more below the smallest normal
+  int shift = std::min(23 - fmt.man + std::max(1 - fmt.bias - e, 0), 31);
+  uint32_t add = r < 0 ? (1u << (shift - 1)) - 1 + ((mant >> shift) & 1) : (uint32_t)std::ldexp(r, shift);
+  // a carry out of the significand moves on to the next exponent
+  uint32_t code = (((uint32_t)std::max(e + fmt.bias, 1) - 1) << fmt.man) + ((mant + add) >> shift);
+  code = std::min(code, fmt.max_code);
+  code = a > 0x7F800000 ? fmt.nan_code : a == 0x7F800000 ? fmt.inf_code : code;
+  return (uint8_t)(code | (u >> 31 << 7));
+}
+
+void fp8_decode_table(float *table, int man_bits, int exp_bits)
+{
+  Minifloat element(exp_bits, man_bits);
+  for (int c = 0; c < 256; c++)
+    table[c] = element.decode(c);
+}
+
+/* codes of a (uint8, same shape), or their values if decode */
+Tensor fp8_helper(Tensor a, int man_bits, int exp_bits, bool stochastic, bool decode)
+{
+  CHECK_INPUT(a);
+  FP8Format fmt = fp8_format(man_bits, exp_bits);
+  float table[256];
+  fp8_decode_table(table, man_bits, exp_bits);
+  const float *a_array = a.data_ptr<float>();
+  int64_t size = a.numel();
+  Tensor r = stochastic ? torch::rand_like(a) : a;
+  const float *r_array = stochastic ? r.data_ptr<float>() : nullptr;
+  Tensor o = decode ? torch::empty_like(a) : torch::empty_like(a, torch::TensorOptions().dtype(torch::kUInt8));
+  float *of = decode ? o.data_ptr<float>() : nullptr;
+  uint8_t *o8 = decode ? nullptr : o.data_ptr<uint8_t>();
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    if (r_array)
+    {
+      for (int64_t i = begin; i < end; i++)
+      {
+        uint8_t code = fp8_encode(a_array[i], r_array[i], fmt);
+        if (of)
+          of[i] = table[code];
+        else
+          o8[i] = code;
+      }
+    }
+    else if (of)
+    {
+      for (int64_t i = begin; i < end; i++)
+        of[i] = table[fp8_encode(a_array[i], -1, fmt)];
+    }
+    else
+    {
+      for (int64_t i = begin; i < end; i++)
+        o8[i] = fp8_encode(a_array[i], -1, fmt);
+    }
+  });
+  return o;
+}
+
+Tensor fp8_quantize(Tensor a, int man_bits, int exp_bits, bool stochastic)
+{
+  return fp8_helper(a, man_bits, exp_bits, stochastic, true);
+}
+
+Tensor fp8_pack(Tensor a, int man_bits, int exp_bits, bool stochastic)
+{
+  return fp8_helper(a, man_bits, exp_bits, stochastic, false);
+}
 
+Tensor fp8_unpack(Tensor p, int man_bits, int exp_bits)
+{
+  CHECK_INPUT(p);
+  TORCH_CHECK(p.scalar_type() == torch::kUInt8, "FP8 codes must be uint8");
+  fp8_format(man_bits, exp_bits);
+  float table[256];
+  fp8_decode_table(table, man_bits, exp_bits);
+  const uint8_t *p_array = p.data_ptr<uint8_t>();
+  Tensor o = torch::empty_like(p, torch::TensorOptions().dtype(torch::kFloat));
+  float *o_array = o.data_ptr<float>();
+  at::parallel_for(0, p.numel(), PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+      o_array[i] = table[p_array[i]];
+  });
   return o;
 }
 
+/* Fixed point storage: a (wl, fl) number is the integer x * 2^fl, stored as int8 for
+   wl <= 8 and int16 for wl <= 16 (the fractional length is kept by the caller).
+   Rounding and clamping are those of fixed_point_quantize; NaN is stored as 0. */
+inline ScalarType fixed_point_dtype(int wl)
+{
+  TORCH_CHECK(wl >= 2 && wl <= 16, "packed fixed point supports 2 <= wl <= 16");
+  return wl <= 8 ? torch::kInt8 : torch::kInt16;
+}
 
-Tensor posit_tanh(Tensor a, int nsize, int es, float scale)
+template <typename T>
+void fixed_point_encode(const float *a_array, const float *r_array, T *o_array, int64_t size,
+                        int fl, float t_min, float t_max)
 {
-  auto a_array = a.data_ptr<float>();
-  auto o = torch::zeros_like(a);
-  auto o_array = o.data_ptr<float>();
-  int size = a.numel();
-  uint32_t	int32_constants[ 11 ];
-  uint64_t	int64_constants[ 2 ];
-  //only works on nsize = 8 or 16
-  generate_posit_constants(nsize, 0, int32_constants, int64_constants);
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      float v = clamp_helper(round(a_array[i], r_array ? r_array[i] : 0.5f, -fl), t_min, t_max);
+      o_array[i] = std::isnan(v) ? 0 : (T)std::ldexp(v, fl);
+    }
+  });
+}
 
+template <typename T>
+void fixed_point_decode(const T *p_array, float *o_array, int64_t size, int fl)
+{
+  float step = std::ldexp(1.0f, -fl);
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+      o_array[i] = p_array[i] * step;
+  });
+}
 
-  for (int64_t i = 0; i < size; i++)
-  {
-    float temp_input = a_array[i];//*scale;
-    //tanh(x)=2g(2x)−1
-    fp16 temp = fp32tofp16(2*temp_input, int32_constants, int64_constants);
+Tensor fixed_point_pack(Tensor a, int wl, int fl, bool symmetric, bool stochastic)
+{
+  CHECK_INPUT(a);
+  ScalarType dtype = fixed_point_dtype(wl);
+  float t_min, t_max;
+  fixed_min_max(wl, fl, symmetric, &t_min, &t_max);
+  Tensor r = stochastic ? torch::rand_like(a) : a;
+  const float *a_array = a.data_ptr<float>();
+  const float *r_array = stochastic ? r.data_ptr<float>() : nullptr;
+  Tensor o = torch::empty_like(a, torch::TensorOptions().dtype(dtype));
+  if (dtype == torch::kInt8)
+    fixed_point_encode(a_array, r_array, o.data_ptr<int8_t>(), a.numel(), fl, t_min, t_max);
+  else
+    fixed_point_encode(a_array, r_array, o.data_ptr<int16_t>(), a.numel(), fl, t_min, t_max);
+  return o;
+}
 
-    temp = compute_sigmoid (temp);
+Tensor fixed_point_unpack(Tensor p, int fl)
+{
+  CHECK_INPUT(p);
+  Tensor o = torch::empty_like(p, torch::TensorOptions().dtype(torch::kFloat));
+  if (p.scalar_type() == torch::kInt8)
+    fixed_point_decode(p.data_ptr<int8_t>(), o.data_ptr<float>(), p.numel(), fl);
+  else if (p.scalar_type() == torch::kInt16)
+    fixed_point_decode(p.data_ptr<int16_t>(), o.data_ptr<float>(), p.numel(), fl);
+  else
+    TORCH_CHECK(false, "packed fixed point must be int8 or int16");
+  return o;
+}
 
-    temp_input = fp16tofp32(temp, int32_constants, int64_constants);
+/* the integer v with shift more fractional bits, rounded to nearest even (or shifted
+   left if shift < 0) and saturated to [lo, hi] */
+inline int64_t fixed_point_requantize(int64_t v, int shift, int64_t lo, int64_t hi)
+{
+  if (shift <= 0)
+    return clamp_helper(clamp_helper(v, lo, hi) * ((int64_t)1 << -shift), lo, hi);
+  int64_t q = v >> shift; // floor
+  int64_t rem = v - q * ((int64_t)1 << shift), half = (int64_t)1 << (shift - 1);
+  q += rem > half || (rem == half && (q & 1));
+  return clamp_helper(q, lo, hi);
+}
 
-    temp_input = temp_input * 2 - 1 ;
+/* integer GEMM a [M, K] @ b^T [N, K]: the products are summed exactly in Acc, and the
+   epilogue adds the bias and requantizes; a task is one row times a block of columns */
+template <typename T, typename Acc, typename O>
+void fixed_point_gemm(const T *a, const T *bt, const int64_t *bias, O *o, int64_t m, int64_t k, int64_t n,
+                      int shift, int64_t lo, int64_t hi)
+{
+  int64_t blocks = (n + ACC_BLOCK - 1) / ACC_BLOCK;
+  int64_t grain = PACK_GRAIN_SIZE / (k * ACC_BLOCK + 1) + 1;
+  at::parallel_for(0, m * blocks, grain, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; t++)
+    {
+      int64_t i = t / blocks;
+      int64_t j0 = (t % blocks) * ACC_BLOCK, j1 = std::min(j0 + ACC_BLOCK, n);
+      const T *a_row = a + i * k;
+      for (int64_t j = j0; j < j1; j++)
+      {
+        const T *b_row = bt + j * k;
+        Acc s = 0;
+        for (int64_t l = 0; l < k; l++)
+          s += (Acc)a_row[l] * b_row[l];
+        int64_t v = (int64_t)s + (bias ? bias[j] : 0);
+        o[i * n + j] = (O)fixed_point_requantize(v, shift, lo, hi);
+      }
+    }
+  });
+}
+
+template <typename T, typename Acc>
+void fixed_point_gemm(Tensor a, Tensor bt, const int64_t *bias, Tensor o, int shift, int64_t lo, int64_t hi)
+{
+  int64_t m = a.size(0), k = a.size(1), n = bt.size(0);
+  if (o.scalar_type() == torch::kInt8)
+    fixed_point_gemm<T, Acc>(a.data_ptr<T>(), bt.data_ptr<T>(), bias, o.data_ptr<int8_t>(), m, k, n, shift, lo, hi);
+  else
+    fixed_point_gemm<T, Acc>(a.data_ptr<T>(), bt.data_ptr<T>(), bias, o.data_ptr<int16_t>(), m, k, n, shift, lo, hi);
+}
+
+/* a [M, K] @ b [K, N] on packed fixed point, both int8 or both int16, whose products have
+   fl_in fractional bits; bias is fp32 [N] or empty. The int8 products are accumulated
+   in int32 (exact for K < 2^17), the int16 ones in int64; the result is (wl, fl). */
+Tensor fixed_point_matmul(Tensor a, Tensor b, Tensor bias, int fl_in, int wl, int fl, bool symmetric)
+{
+  CHECK_INPUT(a);
+  CHECK_INPUT(b);
+  CHECK_INPUT(bias);
+  TORCH_CHECK(a.dim() == 2 && b.dim() == 2 && a.size(1) == b.size(0), "expected [M, K] and [K, N] operands");
+  TORCH_CHECK(a.scalar_type() == b.scalar_type() && (a.scalar_type() == torch::kInt8 || a.scalar_type() == torch::kInt16),
+              "operands must both be int8 or both int16");
+  int64_t m = a.size(0), k = a.size(1), n = b.size(1);
+  TORCH_CHECK(a.scalar_type() == torch::kInt16 || k < (1 << 17), "int8 operands support K < 2^17");
+  TORCH_CHECK(bias.numel() == 0 || bias.numel() == n, "bias must be empty or [N]");
+  int shift = fl_in - fl;
+  TORCH_CHECK(shift >= -32 && shift <= 62, "the output fractional length is too far from the products'");
+  Tensor o = torch::empty({m, n}, torch::TensorOptions().dtype(fixed_point_dtype(wl)));
+  int64_t lo = -((int64_t)1 << (wl - 1)) + symmetric, hi = ((int64_t)1 << (wl - 1)) - 1;
+
+  // the bias at the products' fractional length
+  std::vector<int64_t> bias_int(bias.numel());
+  const float *bias_array = bias.numel() ? bias.data_ptr<float>() : nullptr;
+  for (int64_t j = 0; j < bias.numel(); j++)
+    bias_int[j] = std::llrint(std::ldexp((double)bias_array[j], fl_in));
+  const int64_t *bias_ptr = bias.numel() ? bias_int.data() : nullptr;
+
+  // rows of b^T, so that every column is contiguous
+  Tensor bt = b.transpose(0, 1).contiguous();
+  if (a.scalar_type() == torch::kInt8)
+    fixed_point_gemm<int8_t, int32_t>(a, bt, bias_ptr, o, shift, lo, hi);
+  else
+    fixed_point_gemm<int16_t, int64_t>(a, bt, bias_ptr, o, shift, lo, hi);
+  return o;
+}
+
+/* Packed-to-packed transcoding between posit (nsize <= 16), FP8, bf16 and fixed point
+   (wl <= 16), in their packed storage (bf16 as its int16 bits). Every code is decoded to
+   the fp32 value it stands for, which is exact, and encoded once (to nearest), so the
+   result is that of unpacking and packing again without the fp32 tensor in between.
+   Sources of 8 bits, and large ones of 16 bits, go through a table of the result of
+   every code; small 16-bit sources are converted one by one. */
+#define TRANSCODE_POSIT 0
+#define TRANSCODE_FLOAT 1
+#define TRANSCODE_FIXED 2
+
+struct PackedFormat
+{
+  int kind, p1, p2; // posit (nsize, es), float (man_bits, exp_bits) or fixed point (wl, fl)
+  float scale;      // posits stand for posit(x * scale)
+  mutable uint32_t int32_constants[11]; // read only, the codec takes them mutable
+  mutable uint64_t int64_constants[2];
+  FP8Format fp8;
+  float fp8_table[256];
+  float t_min, t_max;
 
-    o_array[i] = temp_input;///scale;
+  PackedFormat(int kind, int p1, int p2, float scale, bool symmetric) : kind(kind), p1(p1), p2(p2), scale(scale)
+  {
+    if (kind == TRANSCODE_POSIT)
+    {
+      TORCH_CHECK(p1 <= 16, "packed posit storage only supports nsize <= 16");
+      generate_posit_constants(p1, p2, int32_constants, int64_constants);
+    }
+    else if (kind == TRANSCODE_FLOAT)
+    {
+      TORCH_CHECK(!bf16() || p1 == 7, "packed floating point is FP8 E4M3/E5M2 or bf16");
+      if (!bf16())
+      {
+        fp8 = fp8_format(p1, p2);
+        fp8_decode_table(fp8_table, p1, p2);
+      }
+    }
+    else
+    {
+      TORCH_CHECK(kind == TRANSCODE_FIXED, "unknown packed format");
+      fixed_point_dtype(p1);
+      fixed_min_max(p1, p2, symmetric, &t_min, &t_max);
+    }
+  }
+  bool bf16() const { return kind == TRANSCODE_FLOAT && p2 == 8; }
+  ScalarType dtype() const
+  {
+    if (kind == TRANSCODE_POSIT)
+      return p1 <= 8 ? torch::kUInt8 : torch::kInt16;
+    if (kind == TRANSCODE_FLOAT)
+      return bf16() ? torch::kInt16 : torch::kUInt8;
+    return fixed_point_dtype(p1);
+  }
+  /* c holds the stored bits, zero-extended */
+  float decode(uint32_t c) const
+  {
+    float f;
+    if (kind == TRANSCODE_POSIT)
+      return fp16tofp32((fp16)(p1 <= 8 ? c << 8 : c), int32_constants, int64_constants) / scale;
+    if (kind == TRANSCODE_FLOAT && bf16())
+    {
+      c <<= 16;
+      BITS_TO_FLOAT(c, f);
+      return f;
+    }
+    if (kind == TRANSCODE_FLOAT)
+      return fp8_table[c];
+    int v = p1 <= 8 ? (int8_t)c : (int16_t)c;
+    return std::ldexp((float)v, -p2);
+  }
+  uint32_t encode(float f) const
+  {
+    if (kind == TRANSCODE_POSIT)
+      return fp32tofp16(f * scale, int32_constants, int64_constants) >> (p1 <= 8 ? 8 : 0);
+    if (kind == TRANSCODE_FLOAT && bf16())
+    {
+      uint32_t u;
+      FLOAT_TO_BITS(f, u);
+      if ((u & 0x7FFFFFFF) > 0x7F800000) // NaN stays (quiet) NaN
+        return (u >> 16) | 0x40;
+      return (u + 0x7FFF + ((u >> 16) & 1)) >> 16; // nearest even
+    }
+    if (kind == TRANSCODE_FLOAT)
+      return fp8_encode(f, -1, fp8);
+    float v = clamp_helper(round(f, 0.5f, -p2), t_min, t_max);
+    return std::isnan(v) ? 0 : (uint32_t)(int)std::ldexp(v, p2);
+  }
+};
 
+template <typename S, typename D>
+void transcode_helper(const S *p_array, D *o_array, int64_t size, const PackedFormat &src, const PackedFormat &dst)
+{
+  typedef typename std::make_unsigned<S>::type U;
+  int64_t codes = (int64_t)1 << (8 * sizeof(S));
+  if (sizeof(S) == 1 || size >= codes)
+  {
+    std::vector<D> table(codes);
+    at::parallel_for(0, codes, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++)
+        table[c] = (D)dst.encode(src.decode(c));
+    });
+    at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++)
+        o_array[i] = table[(U)p_array[i]];
+    });
+    return;
   }
+  at::parallel_for(0, size, PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+      o_array[i] = (D)dst.encode(src.decode((U)p_array[i]));
+  });
+}
+
+template <typename S>
+void transcode_helper(const S *p_array, Tensor o, const PackedFormat &src, const PackedFormat &dst)
+{
+  if (o.scalar_type() == torch::kUInt8)
+    transcode_helper(p_array, o.data_ptr<uint8_t>(), o.numel(), src, dst);
+  else if (o.scalar_type() == torch::kInt8)
+    transcode_helper(p_array, o.data_ptr<int8_t>(), o.numel(), src, dst);
+  else
+    transcode_helper(p_array, o.data_ptr<int16_t>(), o.numel(), src, dst);
+}
 
+Tensor transcode(Tensor p, int src_kind, int src_p1, int src_p2, float src_scale,
+                 int dst_kind, int dst_p1, int dst_p2, float dst_scale, bool dst_symmetric)
+{
+  CHECK_INPUT(p);
+  PackedFormat src(src_kind, src_p1, src_p2, src_scale, false);
+  PackedFormat dst(dst_kind, dst_p1, dst_p2, dst_scale, dst_symmetric);
+  TORCH_CHECK(p.scalar_type() == src.dtype(), "the packed tensor does not match its format's storage type");
+  Tensor o = torch::empty_like(p, torch::TensorOptions().dtype(dst.dtype()));
+  if (p.scalar_type() == torch::kUInt8)
+    transcode_helper(p.data_ptr<uint8_t>(), o, src, dst);
+  else if (p.scalar_type() == torch::kInt8)
+    transcode_helper(p.data_ptr<int8_t>(), o, src, dst);
+  else
+    transcode_helper(p.data_ptr<int16_t>(), o, src, dst);
   return o;
 }
 
+fp16 compute_sigmoid(fp16 p) {
+    p ^= 0x8000;
+    return p >> 2;
+}
 
-/* // Deprecated, use new enhanced version with only add/substract below
-Tensor posit_tanh_enhanced(Tensor a, int nsize, int es, float scale)
+/* Posit sigmoid and tanh: sigmoid is (x XOR 0x8000) >> 2 on the posit(nsize, 0) bits,
+   and tanh(x) = 2 sigmoid(2x) - 1. The forward kernels also return the sigmoid's posit
+   bits (int16), from which the backward kernels recompute the output exactly, and
+   compute grad * y (1 - y) for sigmoid and grad * (1 - y^2) for tanh in one pass. */
+#define ACT_SIGMOID 0
+#define ACT_TANH 1
+#define ACT_TANH_ENHANCED 2
+
+template <int OP>
+inline fp16 posit_activation_bits(float x, uint32_t* int32_constants, uint64_t* int64_constants)
+{
+  return compute_sigmoid(fp32tofp16(OP == ACT_SIGMOID ? x : 2 * x, int32_constants, int64_constants));
+}
+
+template <int OP>
+inline float posit_activation_output(fp16 bits, uint32_t* int32_constants, uint64_t* int64_constants)
+{
+  float temp_input = fp16tofp32(bits, int32_constants, int64_constants);
+  if (OP == ACT_SIGMOID)
+    return temp_input;
+  temp_input = temp_input * 2 - 1;
+  if (OP == ACT_TANH_ENHANCED)
+  {
+    // error correction with only add/subtract, see posit_tanh_enhanced
+    if (temp_input > 0.7583)
+      temp_input = temp_input+0.06795;
+    if (temp_input < -0.7583)
+      temp_input = temp_input-0.06795;
+    if (temp_input > 1)
+      temp_input = 1;
+    if (temp_input < -1)
+      temp_input = -1;
+  }
+  return temp_input;
+}
+
+/* the output, and the sigmoid's bits if save */
+template <int OP>
+std::tuple<Tensor, Tensor> posit_activation_forward(Tensor a, int nsize, bool save)
 {
+  CHECK_INPUT(a);
   auto a_array = a.data_ptr<float>();
-  auto o = torch::zeros_like(a);
+  Tensor o = torch::empty_like(a);
   auto o_array = o.data_ptr<float>();
-  int size = a.numel();
+  Tensor bits = save ? torch::empty_like(a, torch::TensorOptions().dtype(torch::kInt16)) : torch::empty({0});
+  int16_t *bits_array = save ? bits.data_ptr<int16_t>() : nullptr;
   uint32_t	int32_constants[ 11 ];
   uint64_t	int64_constants[ 2 ];
   //only works on nsize = 8 or 16
   generate_posit_constants(nsize, 0, int32_constants, int64_constants);
 
+  at::parallel_for(0, a.numel(), PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      fp16 temp = posit_activation_bits<OP>(a_array[i], int32_constants, int64_constants);
+      o_array[i] = posit_activation_output<OP>(temp, int32_constants, int64_constants);
+      if (bits_array)
+        bits_array[i] = temp;
+    }
+  });
+  return std::make_tuple(o, bits);
+}
 
-  for (int64_t i = 0; i < size; i++)
-  {
-    float temp_input = a_array[i];//*scale;
-    //tanh(x)=2g(2x)−1
-    fp16 temp = fp32tofp16(2*temp_input, int32_constants, int64_constants);
-
-    temp = compute_sigmoid (temp);
-
-    temp_input = fp16tofp32(temp, int32_constants, int64_constants);
-
-    temp_input = temp_input * 2 - 1 ;
-
-      if (temp_input > 0.6)
-          temp_input = temp_input*1.07;
+template <int OP>
+Tensor posit_activation_backward(Tensor grad, Tensor bits, int nsize)
+{
+  CHECK_INPUT(grad);
+  CHECK_INPUT(bits);
+  TORCH_CHECK(bits.scalar_type() == torch::kInt16 && bits.numel() == grad.numel(), "expected the int16 bits saved by the forward");
+  auto g_array = grad.data_ptr<float>();
+  auto bits_array = bits.data_ptr<int16_t>();
+  Tensor o = torch::empty_like(grad);
+  auto o_array = o.data_ptr<float>();
+  uint32_t	int32_constants[ 11 ];
+  uint64_t	int64_constants[ 2 ];
+  generate_posit_constants(nsize, 0, int32_constants, int64_constants);
 
-      if (temp_input < -0.6)
-          temp_input = temp_input*1.07;
+  at::parallel_for(0, grad.numel(), PACK_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+    {
+      float y = posit_activation_output<OP>((fp16)bits_array[i], int32_constants, int64_constants);
+      o_array[i] = OP == ACT_SIGMOID ? g_array[i] * (y * (1 - y)) : g_array[i] * (1 - y * y);
+    }
+  });
+  return o;
+}
 
-      if (temp_input > 1)
-          temp_input = 1;
-      if (temp_input < -1)
-          temp_input = -1;
+Tensor posit_sigmoid(Tensor a, int nsize, int es, float scale)
+{
+  return std::get<0>(posit_activation_forward<ACT_SIGMOID>(a, nsize, false));
+}
 
+std::tuple<Tensor, Tensor> posit_sigmoid_forward(Tensor a, int nsize)
+{
+  return posit_activation_forward<ACT_SIGMOID>(a, nsize, true);
+}
 
+Tensor posit_sigmoid_backward(Tensor grad, Tensor bits, int nsize)
+{
+  return posit_activation_backward<ACT_SIGMOID>(grad, bits, nsize);
+}
 
-      o_array[i] = temp_input;///scale;
+Tensor posit_tanh(Tensor a, int nsize, int es, float scale)
+{
+  return std::get<0>(posit_activation_forward<ACT_TANH>(a, nsize, false));
+}
 
-  }
+std::tuple<Tensor, Tensor> posit_tanh_forward(Tensor a, int nsize)
+{
+  return posit_activation_forward<ACT_TANH>(a, nsize, true);
+}
 
-  return o;
+Tensor posit_tanh_backward(Tensor grad, Tensor bits, int nsize)
+{
+  return posit_activation_backward<ACT_TANH>(grad, bits, nsize);
 }
-*/
 
+
+/* // Deprecated, use new enhanced version with only add/substract below
 Tensor posit_tanh_enhanced(Tensor a, int nsize, int es, float scale)
 {
   auto a_array = a.data_ptr<float>();
@@ -620,11 +2177,11 @@ Tensor posit_tanh_enhanced(Tensor a, int nsize, int es, float scale)
 
     temp_input = temp_input * 2 - 1 ;
 
-      if (temp_input > 0.7583)
-          temp_input = temp_input+0.06795;
+      if (temp_input > 0.6)
+          temp_input = temp_input*1.07;
 
-      if (temp_input < -0.7583)
-          temp_input = temp_input-0.06795;
+      if (temp_input < -0.6)
+          temp_input = temp_input*1.07;
 
       if (temp_input > 1)
           temp_input = 1;
@@ -639,6 +2196,23 @@ Tensor posit_tanh_enhanced(Tensor a, int nsize, int es, float scale)
 
   return o;
 }
+*/
+
+/* tanh with the error corrected by adding or subtracting a constant */
+Tensor posit_tanh_enhanced(Tensor a, int nsize, int es, float scale)
+{
+  return std::get<0>(posit_activation_forward<ACT_TANH_ENHANCED>(a, nsize, false));
+}
+
+std::tuple<Tensor, Tensor> posit_tanh_enhanced_forward(Tensor a, int nsize)
+{
+  return posit_activation_forward<ACT_TANH_ENHANCED>(a, nsize, true);
+}
+
+Tensor posit_tanh_enhanced_backward(Tensor grad, Tensor bits, int nsize)
+{
+  return posit_activation_backward<ACT_TANH_ENHANCED>(grad, bits, nsize);
+}
 
 
 float new_format_quantize_nearest(float input){
@@ -813,6 +2387,24 @@ Tensor configurable_table_quantize(Tensor a, Tensor lookup_table, float scale)
   return o;
 }
 
+Tensor configurable_table_quantize_parallel(Tensor a, Tensor lookup_table, float scale)
+{
+  CHECK_INPUT(a);
+  CHECK_INPUT(lookup_table);
+  auto a_array = a.data_ptr<float>();
+  Tensor o = torch::empty_like(a);
+  auto o_array = o.data_ptr<float>();
+  int table_size = lookup_table.numel();
+  auto constants = lookup_table.data_ptr<float>();
+  int64_t grain = PACK_GRAIN_SIZE / (table_size + 1) + 1;
+
+  at::parallel_for(0, a.numel(), grain, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++)
+      o_array[i] = configurable_table_quantize_nearest(a_array[i] * scale, constants, table_size) / scale;
+  });
+  return o;
+}
+
 Tensor configurable_table_quantize_rounding_hint(Tensor a, Tensor lookup_table, Tensor rounding_hint, float scale)
 {
   auto a_array = a.data_ptr<float>();
@@ -850,12 +2442,51 @@ PYBIND11_MODULE(TORCH_EXTENSION_NAME, m)
   m.def("block_quantize_nearest", &block_quantize_nearest, "Block Floating Point Number Nearest Neighbor Quantization (CPU)");
   m.def("float_quantize_nearest", &float_quantize_nearest, "Low-Bitwidth Floating Point Number Nearest Neighbor Quantization (CPU)");
   m.def("posit_quantize_nearest", &posit_quantize_nearest, "Low-Bitwidth Posit Quantization (CPU)");
+  m.def("posit_quantize_nearest_parallel", &posit_quantize_nearest_parallel, "Low-Bitwidth Posit Quantization, Multithreaded (CPU)");
+  m.def("posit_pack", &posit_pack, "Encode to Packed Posit Bits (CPU)");
+  m.def("posit_pack_exact", &posit_pack_exact, "Encode to Packed Posit Bits, Reporting Whether the Encoding is Lossless (CPU)");
+  m.def("posit_unpack", &posit_unpack, "Decode Packed Posit Bits (CPU)", py::call_guard<py::gil_scoped_release>());
+  m.def("posit_unpack_sum", &posit_unpack_sum, "Decode and Sum Rows of Packed Posit Bits (CPU)");
+  m.def("posit_embedding_forward", &posit_embedding_forward, "Packed Posit Embedding Gather-Decode (CPU)");
+  m.def("posit_embedding_bag_forward", &posit_embedding_bag_forward, "Packed Posit EmbeddingBag Gather-Decode-Pool (CPU)");
+  m.def("posit_embedding_sparse_update", &posit_embedding_sparse_update, "Packed Posit Embedding Sparse SGD Update with Stochastic Rounding (CPU)");
+  m.def("posit_add", &posit_add, "Posit Addition, Rounded Once (CPU)");
+  m.def("posit_sub", &posit_sub, "Posit Subtraction, Rounded Once (CPU)");
+  m.def("posit_mul", &posit_mul, "Posit Multiplication, Rounded Once (CPU)");
+  m.def("posit_div", &posit_div, "Posit Division, Rounded Once (CPU)");
+  m.def("posit_fma", &posit_fma, "Posit Fused Multiply-Add, Rounded Once (CPU)");
+  m.def("posit_sqrt", &posit_sqrt, "Posit Square Root, Rounded Once (CPU)");
+  m.def("posit_sum", &posit_sum, "Exact Quire Sum (or Mean) of the Rows of a Posit Tensor (CPU)");
+  m.def("posit_dot", &posit_dot, "Exact Quire Dot Product of the Rows of two Posit Tensors (CPU)");
+  m.def("fixed_point_accumulate_matmul", &fixed_point_accumulate_matmul, "Matmul with a Fixed Point Accumulator Rounded every Chunk of K (CPU)");
+  m.def("float_accumulate_matmul", &float_accumulate_matmul, "Matmul with a Low-Bitwidth Floating Point Accumulator Rounded every Chunk of K (CPU)");
+  m.def("posit_accumulate_matmul", &posit_accumulate_matmul, "Matmul with a Posit Accumulator Rounded every Chunk of K (CPU)");
+  m.def("fixed_point_mx_quantize", &fixed_point_mx_quantize, "MX Block Quantization with Integer Payloads, Fake-Quantized and Packed (CPU)");
+  m.def("fixed_point_mx_unpack", &fixed_point_mx_unpack, "Decode MX Blocks with Integer Payloads (CPU)");
+  m.def("float_mx_quantize", &float_mx_quantize, "MX Block Quantization with Low-Bitwidth Floating Point Payloads, Fake-Quantized and Packed (CPU)");
+  m.def("float_mx_unpack", &float_mx_unpack, "Decode MX Blocks with Low-Bitwidth Floating Point Payloads (CPU)");
+  m.def("posit_mx_quantize", &posit_mx_quantize, "MX Block Quantization with Posit Payloads, Fake-Quantized and Packed (CPU)");
+  m.def("posit_mx_unpack", &posit_mx_unpack, "Decode MX Blocks with Posit Payloads (CPU)");
+  m.def("fixed_point_pack", &fixed_point_pack, "Encode to Packed int8/int16 Fixed Point (CPU)");
+  m.def("fixed_point_unpack", &fixed_point_unpack, "Decode Packed int8/int16 Fixed Point (CPU)");
+  m.def("fixed_point_matmul", &fixed_point_matmul, "Integer GEMM on Packed Fixed Point with a Requantizing Epilogue (CPU)");
+  m.def("transcode", &transcode, "Packed-to-Packed Transcoding between Posit, FP8, bf16 and Fixed Point (CPU)");
+  m.def("fp8_quantize", &fp8_quantize, "FP8 E4M3/E5M2 Quantization with Subnormals and Saturation (CPU)");
+  m.def("fp8_pack", &fp8_pack, "Encode to Packed FP8 E4M3/E5M2 Codes (CPU)");
+  m.def("fp8_unpack", &fp8_unpack, "Decode Packed FP8 E4M3/E5M2 Codes (CPU)");
   m.def("posit_sigmoid", &posit_sigmoid, "Low-Bitwidth Posit Sigmoid (CPU)");
+  m.def("posit_sigmoid_forward", &posit_sigmoid_forward, "Low-Bitwidth Posit Sigmoid Returning the Bits to Save for Backward (CPU)");
+  m.def("posit_sigmoid_backward", &posit_sigmoid_backward, "Fused Gradient of the Low-Bitwidth Posit Sigmoid from its Saved Bits (CPU)");
   m.def("posit_tanh", &posit_tanh, "Low-Bitwidth Posit Tanh (CPU)");
+  m.def("posit_tanh_forward", &posit_tanh_forward, "Low-Bitwidth Posit Tanh Returning the Bits to Save for Backward (CPU)");
+  m.def("posit_tanh_backward", &posit_tanh_backward, "Fused Gradient of the Low-Bitwidth Posit Tanh from its Saved Bits (CPU)");
   m.def("posit_tanh_enhanced", &posit_tanh_enhanced, "Low-Bitwidth Posit Tanh (CPU)");
+  m.def("posit_tanh_enhanced_forward", &posit_tanh_enhanced_forward, "Low-Bitwidth Posit Tanh with Error Correction Returning the Bits to Save for Backward (CPU)");
+  m.def("posit_tanh_enhanced_backward", &posit_tanh_enhanced_backward, "Fused Gradient of the Low-Bitwidth Posit Tanh with Error Correction from its Saved Bits (CPU)");
   m.def("new_format_quantize", &new_format_quantize, "New table-lookup Format (CPU)");
   m.def("act_format_quantize", &act_format_quantize, "New table-lookup Format (Activation CPU)");
   m.def("configurable_table_quantize", &configurable_table_quantize, "Configurable table-lookup Format (CPU)");
+  m.def("configurable_table_quantize_parallel", &configurable_table_quantize_parallel, "Configurable table-lookup Format, Multithreaded (CPU)");
   m.def("configurable_table_quantize_rounding_hint", &configurable_table_quantize_rounding_hint, "Configurable table-lookup Format with hints for rounding for every interval (CPU)");
 //  m.def("posit_tanh_enhanced2", &posit_tanh_enhanced2, "Low-Bitwidth Posit Tanh (CPU)");
 }
@@ -22,12 +22,52 @@ std::tuple<at::Tensor, at::Tensor> fixed_point_quantize_stochastic_mask(at::Tens
 at::Tensor block_quantize_stochastic(at::Tensor a, int wl, int dim);
 at::Tensor float_quantize_stochastic(at::Tensor a, int man_bits, int exp_bits);
 at::Tensor posit_quantize_nearest(at::Tensor a, int nsize, int es, float scale);
+at::Tensor posit_quantize_nearest_parallel(at::Tensor a, int nsize, int es, float scale);
+at::Tensor posit_pack(at::Tensor a, int nsize, int es, float scale);
+std::tuple<at::Tensor, bool> posit_pack_exact(at::Tensor a, int nsize, int es, float scale);
+at::Tensor posit_unpack(at::Tensor p, int nsize, int es, float scale);
+at::Tensor posit_unpack_sum(at::Tensor p, at::Tensor scales, int nsize, int es);
+at::Tensor posit_embedding_forward(at::Tensor weight, at::Tensor indices, at::Tensor row_scale, int nsize, int es);
+at::Tensor posit_embedding_bag_forward(at::Tensor weight, at::Tensor indices, at::Tensor offsets, at::Tensor per_sample_weights, at::Tensor row_scale, bool mean, int nsize, int es);
+void posit_embedding_sparse_update(at::Tensor weight, at::Tensor indices, at::Tensor grad, at::Tensor row_scale, float lr, int nsize, int es);
+at::Tensor posit_add(at::Tensor a, at::Tensor b, int nsize, int es, float scale);
+at::Tensor posit_sub(at::Tensor a, at::Tensor b, int nsize, int es, float scale);
+at::Tensor posit_mul(at::Tensor a, at::Tensor b, int nsize, int es, float scale);
+at::Tensor posit_div(at::Tensor a, at::Tensor b, int nsize, int es, float scale);
+at::Tensor posit_fma(at::Tensor a, at::Tensor b, at::Tensor c, int nsize, int es, float scale);
+at::Tensor posit_sqrt(at::Tensor a, int nsize, int es, float scale);
+at::Tensor posit_sum(at::Tensor a, int nsize, int es, float scale, bool mean);
+at::Tensor posit_dot(at::Tensor a, at::Tensor b, int nsize, int es, float scale);
+at::Tensor fixed_point_accumulate_matmul(at::Tensor a, at::Tensor b, at::Tensor c, int chunk, int wl, int fl, bool clamp, bool symmetric);
+at::Tensor float_accumulate_matmul(at::Tensor a, at::Tensor b, at::Tensor c, int chunk, int man_bits, int exp_bits);
+at::Tensor posit_accumulate_matmul(at::Tensor a, at::Tensor b, at::Tensor c, int chunk, int nsize, int es, float scale);
+std::tuple<at::Tensor, at::Tensor, at::Tensor> fixed_point_mx_quantize(at::Tensor a, int block_size, int wl, int fl, bool symmetric);
+at::Tensor fixed_point_mx_unpack(at::Tensor payload, at::Tensor scales, int block_size, int64_t n, int wl, int fl);
+std::tuple<at::Tensor, at::Tensor, at::Tensor> float_mx_quantize(at::Tensor a, int block_size, int man_bits, int exp_bits);
+at::Tensor float_mx_unpack(at::Tensor payload, at::Tensor scales, int block_size, int64_t n, int man_bits, int exp_bits);
+std::tuple<at::Tensor, at::Tensor, at::Tensor> posit_mx_quantize(at::Tensor a, int block_size, int nsize, int es);
+at::Tensor posit_mx_unpack(at::Tensor payload, at::Tensor scales, int block_size, int64_t n, int nsize, int es);
+at::Tensor fp8_quantize(at::Tensor a, int man_bits, int exp_bits, bool stochastic);
+at::Tensor fp8_pack(at::Tensor a, int man_bits, int exp_bits, bool stochastic);
+at::Tensor fp8_unpack(at::Tensor p, int man_bits, int exp_bits);
+at::Tensor fixed_point_pack(at::Tensor a, int wl, int fl, bool symmetric, bool stochastic);
+at::Tensor fixed_point_unpack(at::Tensor p, int fl);
+at::Tensor fixed_point_matmul(at::Tensor a, at::Tensor b, at::Tensor bias, int fl_in, int wl, int fl, bool symmetric);
+at::Tensor transcode(at::Tensor p, int src_kind, int src_p1, int src_p2, float src_scale,
+                     int dst_kind, int dst_p1, int dst_p2, float dst_scale, bool dst_symmetric);
 at::Tensor posit_sigmoid(at::Tensor a, int nsize, int es, float scale);
 at::Tensor posit_tanh(at::Tensor a, int nsize, int es, float scale);
 at::Tensor posit_tanh_enhanced(at::Tensor a, int nsize, int es, float scale);
+std::tuple<at::Tensor, at::Tensor> posit_sigmoid_forward(at::Tensor a, int nsize);
+at::Tensor posit_sigmoid_backward(at::Tensor grad, at::Tensor bits, int nsize);
+std::tuple<at::Tensor, at::Tensor> posit_tanh_forward(at::Tensor a, int nsize);
+at::Tensor posit_tanh_backward(at::Tensor grad, at::Tensor bits, int nsize);
+std::tuple<at::Tensor, at::Tensor> posit_tanh_enhanced_forward(at::Tensor a, int nsize);
+at::Tensor posit_tanh_enhanced_backward(at::Tensor grad, at::Tensor bits, int nsize);
 at::Tensor new_format_quantize(at::Tensor a, float scale);
 at::Tensor act_format_quantize(at::Tensor a, float scale);
 at::Tensor configurable_table_quantize(at::Tensor a, at::Tensor lookup_table, float scale);
+at::Tensor configurable_table_quantize_parallel(at::Tensor a, at::Tensor lookup_table, float scale);
 at::Tensor configurable_table_quantize_rounding_hint(at::Tensor a, at::Tensor lookup_table, at::Tensor rounding_hint, float scale);
 
 #include <stdint.h>
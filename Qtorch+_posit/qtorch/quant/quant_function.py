@@ -3,6 +3,8 @@ from qtorch import Number, FixedPoint, BlockFloatingPoint, FloatingPoint, Posit
 import torch.nn as nn
 import torch.nn.functional as F
 import numpy as np
+from collections import namedtuple
+from . import autotune
 from torch.utils.cpp_extension import load
 import os
 
@@ -51,7 +53,7 @@ if torch.cuda.is_available():
 else:
     quant_cuda = quant_cpu
 
-__all__ = ["fixed_point_quantize", "block_quantize", "float_quantize", "quantizer", "posit_quantize", "posit_sigmoid", "posit_tanh", "posit_tanh_enhanced", "new_format_quantize", "act_format_quantize", "configurable_table_quantize", "configurable_table_quantize_rounding_hint", "configurable_table_quantize_geomean"]
+__all__ = ["fixed_point_quantize", "PackedFixedPoint", "fixed_point_pack", "fixed_point_unpack", "fixed_point_matmul", "block_quantize", "float_quantize", "float_pack", "float_unpack", "quantizer", "posit_quantize", "posit_pack", "posit_pack_exact", "posit_unpack", "posit_unpack_sum", "posit_embedding", "posit_embedding_bag", "posit_embedding_sparse_update", "posit_add", "posit_sub", "posit_mul", "posit_div", "posit_fma", "posit_sqrt", "posit_sum", "posit_mean", "posit_dot", "accumulate_matmul", "accumulate_conv2d", "mx_quantize", "mx_unpack", "transcode", "posit_sigmoid", "posit_tanh", "posit_tanh_enhanced", "posit_activation_forward", "posit_activation_backward", "new_format_quantize", "act_format_quantize", "configurable_table_quantize", "configurable_table_quantize_rounding_hint", "configurable_table_quantize_geomean"]
 
 
 def assert_wl_fl(wl, fl, stage=""):
@@ -69,6 +71,27 @@ def get_module(x):
     return quant_module
 
 
+def get_cpu_module(x):
+    assert not x.is_cuda, "this operation is only implemented for CPU tensors"
+    if quant_cpu is None:
+        raise ValueError("No valid quantization module found")
+    return quant_cpu
+
+
+# interchangeable CPU kernels, all giving the same result
+autotune.register_variant("posit_quantize", "scalar",
+                          lambda x, nsize, es, scale: get_cpu_module(x).posit_quantize_nearest(x, nsize, es, scale))
+autotune.register_variant("posit_quantize", "parallel",
+                          lambda x, nsize, es, scale: get_cpu_module(x).posit_quantize_nearest_parallel(x, nsize, es, scale))
+autotune.register_variant("posit_quantize", "packed",
+                          lambda x, nsize, es, scale: get_cpu_module(x).posit_unpack(
+                              get_cpu_module(x).posit_pack(x, nsize, es, scale), nsize, es, scale))
+autotune.register_variant("configurable_table_quantize", "scalar",
+                          lambda x, table, scale: get_cpu_module(x).configurable_table_quantize(x, table, scale))
+autotune.register_variant("configurable_table_quantize", "parallel",
+                          lambda x, table, scale: get_cpu_module(x).configurable_table_quantize_parallel(x, table, scale))
+
+
 def quantizer(
     forward_number=None,
     backward_number=None,
@@ -117,7 +140,7 @@ def quantizer(
                     x, forward_number.man, forward_number.exp
                 )
             elif type(forward_number) == Posit:
-                forward_quant = lambda x, quant_module: quant_module.posit_quantize_nearest(
+                forward_quant = lambda x, quant_module: posit_quantize(
                     x, forward_number.nsize, forward_number.es, forward_number.scale
                 )
         elif forward_rounding == "stochastic":
@@ -134,7 +157,7 @@ def quantizer(
                     x, forward_number.man, forward_number.exp
                 )
             elif type(forward_number) == Posit:
-                forward_quant = lambda x, quant_module: quant_module.posit_quantize_nearest(
+                forward_quant = lambda x, quant_module: posit_quantize(
                     x, forward_number.nsize, forward_number.es, forward_number.scale
                 )
         else:
@@ -171,7 +194,7 @@ def quantizer(
                 a, backward_number.man, backward_number.exp
             )
         elif type(backward_number) == Posit:
-            backward_quant = lambda a, quant_module: quant_module.posit_quantize_nearest(
+            backward_quant = lambda a, quant_module: posit_quantize(
                 a, backward_number.nsize, backward_number.es, backward_number.scale
             )
         else:
@@ -191,7 +214,7 @@ def quantizer(
                 a, backward_number.man, backward_number.exp
             )
         elif type(backward_number) == Posit:
-            backward_quant = lambda a, quant_module: quant_module.posit_quantize_nearest(
+            backward_quant = lambda a, quant_module: posit_quantize(
                 a, backward_number.nsize, backward_number.es, backward_number.scale
             )
         else:
@@ -291,6 +314,68 @@ def fixed_point_quantize(x, wl, fl, clamp=True, symmetric=False, rounding="stoch
     return out
 
 
+# a fixed point tensor stored as the integers x * 2^fl: int8 for wl <= 8, int16 for wl <= 16
+PackedFixedPoint = namedtuple("PackedFixedPoint", ["data", "wl", "fl"])
+
+
+def fixed_point_pack(x, wl, fl, symmetric=False, rounding="nearest"):
+    """
+    Quantize a single precision tensor to Fixed Point stored as integers (CPU, multithreaded),
+    with the same rounding and clamping as `fixed_point_quantize`. NaN is stored as 0.
+
+    Args:
+        - :param: `x` (torch.Tensor) : the single precision number to be quantized
+        - :param: `wl` (int) : word length, at most 16
+        - :param: `fl` (int) : fractional length
+        - :param: `symmetric` (bool, optional) : discard the minimum representable number
+        - :param: `rounding` (string) : rounding mode, \"stochastic\" or \"nearest\" (default: \"nearest\")
+
+    Returns:
+        - a `PackedFixedPoint(data, wl, fl)`, data being the int8 (wl <= 8) or int16 tensor x * 2^fl
+    """
+    assert rounding in ["stochastic", "nearest"]
+    assert_wl_fl(wl, fl)
+    quant_module = get_cpu_module(x)
+    data = quant_module.fixed_point_pack(x.float().contiguous(), wl, fl, symmetric, rounding == "stochastic")
+    return PackedFixedPoint(data, wl, fl)
+
+
+def fixed_point_unpack(p):
+    """
+    Decode a `PackedFixedPoint` to fp32
+    """
+    quant_module = get_cpu_module(p.data)
+    return quant_module.fixed_point_unpack(p.data.contiguous(), p.fl)
+
+
+def fixed_point_matmul(a, b, out, bias=None):
+    """
+    Integer matrix product of packed Fixed Point operands (CPU, blocked and multithreaded): the
+    int8 products are accumulated exactly in int32 (int16 ones in int64), then the epilogue adds
+    the bias and requantizes to `out`, rounding to nearest even and saturating. The result is
+    `fixed_point_quantize(a @ b + bias, out.wl, out.fl, rounding="nearest")` computed on integers.
+
+    Args:
+        - :attr: `a` (PackedFixedPoint) : [..., K]
+        - :attr: `b` (PackedFixedPoint) : [K, N]; an int8 operand is widened if the other is int16
+        - :attr: `out` (qtorch.FixedPoint) : output format, wl at most 16
+        - :attr: `bias` (torch.Tensor) : fp32 [N], rounded to the products' fractional length
+
+    Returns:
+        - a `PackedFixedPoint`, [..., N]
+    """
+    assert type(out) == FixedPoint, "out must be a FixedPoint format"
+    assert b.data.dim() == 2 and a.data.shape[-1] == b.data.shape[0], "expected [..., K] and [K, N] operands"
+    quant_module = get_cpu_module(a.data)
+    x, w = a.data, b.data
+    if x.dtype != w.dtype:
+        x, w = x.to(torch.int16), w.to(torch.int16)
+    bias = torch.empty(0) if bias is None else bias.float().contiguous()
+    data = quant_module.fixed_point_matmul(x.reshape(-1, x.shape[-1]).contiguous(), w.contiguous(), bias,
+                                           a.fl + b.fl, out.wl, out.fl, out.symmetric)
+    return PackedFixedPoint(data.view(*a.data.shape[:-1], w.shape[1]), out.wl, out.fl)
+
+
 def block_quantize(x, wl, dim=-1, rounding="stochastic"):
     """
     Quantize a single precision Floating Point into low-precision Block Floating Point
@@ -315,7 +400,7 @@ def block_quantize(x, wl, dim=-1, rounding="stochastic"):
     return out
 
 
-def float_quantize(x, exp, man, rounding="stochastic"):
+def float_quantize(x, exp, man, rounding="stochastic", fp8=False):
     """
     Quantize a single precision Floating Point into low-precision Floating Point
 
@@ -324,12 +409,17 @@ def float_quantize(x, exp, man, rounding="stochastic"):
         - :attr: `exp` (int) : number of bits allocated for exponent
         - :attr: `man` (int) : number of bits allocated for mantissa, not counting the virtual bit
         - :attr: `rounding` (string) : rounding mode, \"stochastic\" or \"nearest\"
+        - :attr: `fp8` (bool) : FP8 E4M3 (exp=4, man=3) or E5M2 (exp=5, man=2) as specified, with
+          subnormals and saturation at the largest finite value, on CPU (see `float_pack`)
 
     Returns:
         - a quantized low-precision floating point number (torch.Tensor)
     """
     assert isinstance(x, torch.Tensor), "x is not a single precision Floating Point Tensor"
     assert rounding in ["stochastic", "nearest"], "invalid rounding mode, {}".format(rounding)
+    if fp8:
+        quant_module = get_cpu_module(x)
+        return quant_module.fp8_quantize(x.float().contiguous(), man, exp, rounding == "stochastic")
     quant_module = get_module(x)
     if rounding == "nearest":
         out = quant_module.float_quantize_nearest(x.contiguous(), man, exp)
@@ -339,6 +429,35 @@ def float_quantize(x, exp, man, rounding="stochastic"):
         out = x
     return out
 
+def float_pack(x, exp, man, rounding="nearest"):
+    """
+    Encode fp32 values to packed FP8 codes (CPU, multithreaded): E4M3 (exp=4, man=3) or E5M2
+    (exp=5, man=2), OCP conventions. Values are rounded with subnormals and saturate at the
+    largest finite value (448 and 57344); infinities saturate in E4M3, which has none, and
+    NaN stays NaN.
+
+    Args:
+        - :attr: `x` (torch.Tensor) : the single precision number(torch.Tensor) to be encoded
+        - :attr: `exp`, `man` (int) : the FP8 format
+        - :attr: `rounding` (string) : rounding mode, \"stochastic\" or \"nearest\" (even)
+
+    Returns:
+        - the FP8 codes, like x (torch.uint8 tensor)
+    """
+    assert rounding in ["stochastic", "nearest"], "invalid rounding mode, {}".format(rounding)
+    quant_module = get_cpu_module(x)
+    return quant_module.fp8_pack(x.float().contiguous(), man, exp, rounding == "stochastic")
+
+
+def float_unpack(p, exp, man):
+    """
+    Decode packed FP8 codes from `float_pack` to fp32 through a 256-entry table
+    """
+    assert p.dtype == torch.uint8, "packed FP8 codes must be uint8"
+    quant_module = get_cpu_module(p)
+    return quant_module.fp8_unpack(p.contiguous(), man, exp)
+
+
 def posit_quantize(x, nsize, es, scale = 1.0, rounding="nearest"):
     """
     Quantize a single precision Floating Point into low-precision Floating Point
@@ -357,6 +476,10 @@ def posit_quantize(x, nsize, es, scale = 1.0, rounding="nearest"):
     assert isinstance(x, torch.Tensor), "x is not a single precision Floating Point Tensor"
     assert rounding in ["stochastic", "nearest"], "invalid rounding mode, {}".format(rounding)
     quant_module = get_module(x)
+    if not x.is_cuda:
+        assert 16 >= nsize > 0, "posit quantization on CPU only supports nsize <= 16"
+        # CPU variants are picked by timing (see qtorch.quant.autotune), nearest rounding as below
+        return autotune.dispatch("posit_quantize", (nsize, es), x.contiguous(), nsize, es, scale)
     if rounding == "nearest":
         out = quant_module.posit_quantize_nearest(x.contiguous(), nsize, es, scale)
     elif rounding == "stochastic":
@@ -365,6 +488,458 @@ def posit_quantize(x, nsize, es, scale = 1.0, rounding="nearest"):
         out = x
     return out
 
+def posit_pack(x, nsize, es, scale=1.0):
+    """
+    Encode a single precision tensor into packed posit bit patterns (round to nearest)
+
+    Args:
+        - :attr: `x` (torch.Tensor) : the single precision number(torch.Tensor) to be encoded
+        - :attr: `nsize` (int) : number of bits allocated for the posit format, at most 16
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `scale` (float) : values are encoded as posit(x * scale)
+
+    Returns:
+        - the posit bits (torch.Tensor), torch.uint8 for nsize <= 8 and torch.int16 (left-aligned) for nsize <= 16
+    """
+    assert isinstance(x, torch.Tensor), "x is not a single precision Floating Point Tensor"
+    assert 16 >= nsize > 0, "packed posit storage only supports nsize <= 16"
+    quant_module = get_cpu_module(x)
+    return quant_module.posit_pack(x.contiguous(), nsize, es, scale)
+
+
+def posit_pack_exact(x, nsize, es, scale=1.0):
+    """
+    Encode a single precision tensor into packed posit bit patterns, reporting whether
+    every value is representable so that unpacking gives back exactly `x`
+
+    Args:
+        - :attr: `x` (torch.Tensor) : the single precision number(torch.Tensor) to be encoded
+        - :attr: `nsize` (int) : number of bits allocated for the posit format, at most 16
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `scale` (float) : values are encoded as posit(x * scale)
+
+    Returns:
+        - a tuple (bits, exact); the bits are only meaningful when exact is True
+    """
+    assert isinstance(x, torch.Tensor), "x is not a single precision Floating Point Tensor"
+    assert 16 >= nsize > 0, "packed posit storage only supports nsize <= 16"
+    quant_module = get_cpu_module(x)
+    return quant_module.posit_pack_exact(x.contiguous(), nsize, es, scale)
+
+
+def posit_unpack(p, nsize, es, scale=1.0):
+    """
+    Decode packed posit bit patterns produced by `posit_pack` back to single precision
+
+    Args:
+        - :attr: `p` (torch.Tensor) : packed posit bits, torch.uint8 for nsize <= 8 and torch.int16 for nsize <= 16
+        - :attr: `nsize` (int) : number of bits allocated for the posit format
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `scale` (float) : the scale used when packing, decoded values are divided by it
+
+    Returns:
+        - the decoded single precision tensor (torch.Tensor)
+    """
+    assert isinstance(p, torch.Tensor), "p is not a packed posit Tensor"
+    assert 16 >= nsize > 0, "packed posit storage only supports nsize <= 16"
+    quant_module = get_cpu_module(p)
+    return quant_module.posit_unpack(p.contiguous(), nsize, es, scale)
+
+
+def posit_unpack_sum(p, scales, nsize, es):
+    """
+    Decode the rows of a [rows, n] packed posit tensor, each row divided by its own scale,
+    and sum them in a single pass
+
+    Args:
+        - :attr: `p` (torch.Tensor) : packed posit bits of shape [rows, n]
+        - :attr: `scales` (torch.Tensor) : float tensor with one packing scale per row
+        - :attr: `nsize` (int) : number of bits allocated for the posit format
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+
+    Returns:
+        - the single precision sum over rows, shape [n] (torch.Tensor)
+    """
+    assert isinstance(p, torch.Tensor) and p.dim() == 2, "p must be a [rows, n] packed posit Tensor"
+    assert scales.numel() == p.size(0), "one scale per row is required"
+    quant_module = get_cpu_module(p)
+    return quant_module.posit_unpack_sum(p.contiguous(), scales.float().contiguous(), nsize, es)
+
+def posit_embedding(weight, indices, nsize, es, row_scale=None):
+    """
+    Gather rows of a packed posit embedding table and decode them to single precision in one pass
+
+    Args:
+        - :attr: `weight` (torch.Tensor) : [num_embeddings, embedding_dim] packed posit table (see `posit_pack`)
+        - :attr: `indices` (torch.Tensor) : int64 tensor of row indices, any shape
+        - :attr: `nsize` (int) : number of bits allocated for the posit format
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `row_scale` (torch.Tensor, optional) : float tensor with the packing scale of every row
+
+    Returns:
+        - the decoded rows, shape indices.shape + [embedding_dim] (torch.Tensor)
+    """
+    quant_module = get_cpu_module(weight)
+    row_scale = torch.empty(0) if row_scale is None else row_scale.float().contiguous()
+    return quant_module.posit_embedding_forward(weight.contiguous(), indices.long().contiguous(), row_scale, nsize, es)
+
+
+def posit_embedding_bag(weight, indices, offsets, nsize, es, row_scale=None, per_sample_weights=None, mode="mean"):
+    """
+    Gather, decode and pool bags of rows of a packed posit embedding table in one pass
+
+    Args:
+        - :attr: `weight` (torch.Tensor) : [num_embeddings, embedding_dim] packed posit table (see `posit_pack`)
+        - :attr: `indices` (torch.Tensor) : 1D int64 tensor of row indices of all bags
+        - :attr: `offsets` (torch.Tensor) : 1D int64 tensor with the start of every bag in `indices`
+        - :attr: `row_scale` (torch.Tensor, optional) : float tensor with the packing scale of every row
+        - :attr: `per_sample_weights` (torch.Tensor, optional) : float weight of every index, only with mode \"sum\"
+        - :attr: `mode` (string) : \"sum\" or \"mean\"
+
+    Returns:
+        - the pooled rows, shape [num_bags, embedding_dim] (torch.Tensor)
+    """
+    assert mode in ["sum", "mean"], "invalid pooling mode {}".format(mode)
+    assert per_sample_weights is None or mode == "sum", "per_sample_weights only supported with mode sum"
+    quant_module = get_cpu_module(weight)
+    row_scale = torch.empty(0) if row_scale is None else row_scale.float().contiguous()
+    per_sample_weights = torch.empty(0) if per_sample_weights is None else per_sample_weights.float().contiguous()
+    return quant_module.posit_embedding_bag_forward(
+        weight.contiguous(), indices.long().contiguous(), offsets.long().contiguous(), per_sample_weights, row_scale,
+        mode == "mean", nsize, es
+    )
+
+
+def posit_embedding_sparse_update(weight, indices, grad, lr, nsize, es, row_scale=None):
+    """
+    In-place SGD step on rows of a packed posit embedding table. Every updated row is decoded,
+    moved by -lr * grad and stochastically rounded back into packed posit form.
+
+    Args:
+        - :attr: `weight` (torch.Tensor) : [num_embeddings, embedding_dim] packed posit table, updated in place
+        - :attr: `indices` (torch.Tensor) : 1D int64 tensor of row indices, duplicates are summed
+        - :attr: `grad` (torch.Tensor) : [len(indices), embedding_dim] gradient rows
+        - :attr: `lr` (float) : learning rate
+        - :attr: `row_scale` (torch.Tensor, optional) : float tensor with the packing scale of every row
+    """
+    assert weight.is_contiguous(), "packed table must be contiguous to be updated in place"
+    quant_module = get_cpu_module(weight)
+    unique, inverse = torch.unique(indices.long(), return_inverse=True)
+    coalesced = torch.zeros(unique.numel(), grad.size(-1)).index_add_(0, inverse, grad.reshape(-1, grad.size(-1)).float())
+    row_scale = torch.empty(0) if row_scale is None else row_scale.float().contiguous()
+    quant_module.posit_embedding_sparse_update(weight, unique, coalesced, row_scale, lr, nsize, es)
+
+def _posit_arith(name, operands, nsize, es, scale):
+    """
+    Run one of the element-wise posit ops on broadcast operands. Operands are fp32 values
+    (other floating dtypes and Python numbers are converted) or packed posit bits; one
+    element is broadcast by the kernel, other shapes are expanded here.
+    """
+    assert 16 >= nsize > 0, "posit arithmetic only supports nsize <= 16"
+    tensors = [x if isinstance(x, torch.Tensor) else torch.tensor(float(x)) for x in operands]
+    tensors = [x if x.dtype in (torch.uint8, torch.int16) else x.float() for x in tensors]
+    shape = torch.broadcast_shapes(*(x.shape for x in tensors))
+    tensors = [x.reshape(1) if x.numel() == 1 else x.expand(shape).contiguous() for x in tensors]
+    quant_module = get_cpu_module(tensors[0])
+    return getattr(quant_module, name)(*tensors, nsize, es, scale).view(shape)
+
+
+def posit_add(a, b, nsize, es, scale=1.0):
+    """
+    Add element-wise and round each sum to posit once, as posit hardware does. This is
+    `posit_quantize(a + b)` without the intermediate fp32 rounding or the second pass.
+
+    Args:
+        - :attr: `a`, `b` (torch.Tensor or number) : fp32 operands, used as they are (round them
+          with `posit_quantize` first to emulate posit inputs), or packed posit bits from `posit_pack`
+          with the same nsize, es and scale. Shapes broadcast.
+        - :attr: `nsize` (int) : number of bits allocated for the posit format, at most 16
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `scale` (float) : results are rounded as posit(result * scale) / scale
+
+    Returns:
+        - packed posit bits if `a` is packed, otherwise the fp32 posit values (torch.Tensor)
+    """
+    return _posit_arith("posit_add", (a, b), nsize, es, scale)
+
+
+def posit_sub(a, b, nsize, es, scale=1.0):
+    """
+    Subtract element-wise (a - b) and round each difference to posit once, see `posit_add`
+    """
+    return _posit_arith("posit_sub", (a, b), nsize, es, scale)
+
+
+def posit_mul(a, b, nsize, es, scale=1.0):
+    """
+    Multiply element-wise and round each product to posit once, see `posit_add`
+    """
+    return _posit_arith("posit_mul", (a, b), nsize, es, scale)
+
+
+def posit_div(a, b, nsize, es, scale=1.0):
+    """
+    Divide element-wise (a / b) and round each quotient to posit once, see `posit_add`;
+    division by zero gives NaR
+    """
+    return _posit_arith("posit_div", (a, b), nsize, es, scale)
+
+
+def posit_fma(a, b, c, nsize, es, scale=1.0):
+    """
+    Fused multiply-add a * b + c element-wise, with a single rounding to posit, see `posit_add`
+    """
+    return _posit_arith("posit_fma", (a, b, c), nsize, es, scale)
+
+
+def posit_sqrt(a, nsize, es, scale=1.0):
+    """
+    Square root element-wise, rounded to posit once, see `posit_add`; negative values give NaR
+    """
+    return _posit_arith("posit_sqrt", (a,), nsize, es, scale)
+
+
+def _posit_rows(x, dim):
+    """
+    Move the reduced dimensions of `x` last and flatten it to [rows, n]; returns the rows and
+    the shape of the result with the reduced dimensions removed
+    """
+    dims = list(range(x.dim())) if dim is None else [d % x.dim() for d in ((dim,) if isinstance(dim, int) else dim)]
+    kept = [d for d in range(x.dim()) if d not in dims]
+    n = int(np.prod([x.shape[d] for d in dims]))
+    shape = [x.shape[d] for d in kept]
+    return x.permute(kept + dims).reshape(int(np.prod(shape)), n).contiguous(), shape, dims
+
+
+def _posit_reduce(name, operands, nsize, es, dim, keepdim, scale, *extra):
+    """
+    Run one of the quire reductions over `dim` (all dimensions if None). Operands are fp32
+    values, rounded to posit on the way in, or packed posit bits.
+    """
+    assert 16 >= nsize > 0, "posit reductions only support nsize <= 16"
+    tensors = [x if x.dtype in (torch.uint8, torch.int16) else x.float() for x in operands]
+    shape = torch.broadcast_shapes(*(x.shape for x in tensors))
+    rows = [_posit_rows(x.expand(shape), dim) for x in tensors]
+    quant_module = get_cpu_module(tensors[0])
+    out = getattr(quant_module, name)(*(r[0] for r in rows), nsize, es, scale, *extra).view(rows[0][1])
+    if keepdim:
+        for d in sorted(rows[0][2]):
+            out = out.unsqueeze(d)
+    return out
+
+
+def posit_sum(x, nsize, es, dim=None, keepdim=False, scale=1.0, mean=False):
+    """
+    Sum in a quire: every element is accumulated exactly, with no rounding however many there
+    are, and the sum is rounded to posit once at the end. The result does not depend on the
+    order of the elements or on how the work is split across threads.
+
+    Args:
+        - :attr: `x` (torch.Tensor) : fp32 values, rounded to posit first, or packed posit bits
+          from `posit_pack` with the same nsize, es and scale
+        - :attr: `nsize` (int) : number of bits allocated for the posit format, at most 16
+        - :attr: `es` (int) : number of bits allocated for es field (exponent)
+        - :attr: `dim` (int or tuple of ints) : dimensions to reduce, all of them if None
+        - :attr: `keepdim` (bool) : keep the reduced dimensions with size 1
+        - :attr: `scale` (float) : values are taken as posit(x * scale) / scale
+        - :attr: `mean` (bool) : divide the exact sum by the number of elements before rounding
+
+    Returns:
+        - packed posit bits if `x` is packed, otherwise the fp32 posit values (torch.Tensor);
+          NaR (-inf when unpacked) if any element is NaR
+    """
+    return _posit_reduce("posit_sum", (x,), nsize, es, dim, keepdim, scale, mean)
+
+
+def posit_mean(x, nsize, es, dim=None, keepdim=False, scale=1.0):
+    """
+    Mean in a quire, rounded to posit once, see `posit_sum`; the mean of no elements is NaR
+    """
+    return posit_sum(x, nsize, es, dim, keepdim, scale, mean=True)
+
+
+def posit_dot(a, b, nsize, es, dim=None, keepdim=False, scale=1.0):
+    """
+    Dot product in a quire: the products are accumulated exactly and the sum of
+    products is rounded to posit once, see `posit_sum`. Shapes broadcast, and `dim` indexes the
+    broadcast shape. The products carry the scale twice and are divided by it once, which
+    is exact only if it is a power of two.
+    """
+    return _posit_reduce("posit_dot", (a, b), nsize, es, dim, keepdim, scale)
+
+
+def _accumulate_bmm(a, b, c, acc, chunk):
+    """[B, M, K] @ [B, K, N] with the accumulator format `acc`, starting from c (or zero)"""
+    quant_module = get_cpu_module(a)
+    a, b = a.float().contiguous(), b.float().contiguous()
+    c = torch.empty(0) if c is None else c.float().contiguous()
+    if type(acc) == FixedPoint:
+        return quant_module.fixed_point_accumulate_matmul(a, b, c, chunk, acc.wl, acc.fl, acc.clamp, acc.symmetric)
+    elif type(acc) == FloatingPoint:
+        return quant_module.float_accumulate_matmul(a, b, c, chunk, acc.man, acc.exp)
+    elif type(acc) == Posit:
+        return quant_module.posit_accumulate_matmul(a, b, c, chunk, acc.nsize, acc.es, acc.scale)
+    raise ValueError("unsupported accumulator format {}".format(acc))
+
+
+def accumulate_matmul(a, b, acc, chunk=1, bias=None):
+    """
+    Matrix product with a low-precision accumulator, as on an accelerator: the products are
+    summed over every `chunk` consecutive values of k, and the running partial sum is rounded
+    to `acc` after each chunk. chunk=1 rounds after every multiply-accumulate; chunk >= K
+    rounds once. Products within a chunk are summed in double precision, and each rounding
+    is done once on the exact sum of the partial sum and the chunk.
+
+    Args:
+        - :attr: `a` (torch.Tensor) : [..., M, K] CPU tensor
+        - :attr: `b` (torch.Tensor) : [..., K, N] CPU tensor, batch dimensions broadcast
+        - :attr: `acc` (qtorch.Number) : accumulator format, `Posit`, `FloatingPoint` or `FixedPoint`
+        - :attr: `chunk` (int) : number of products summed between two roundings
+        - :attr: `bias` (torch.Tensor) : initial value of the accumulator, broadcast to the output
+
+    Returns:
+        - the fp32 result, [..., M, N] (torch.Tensor)
+    """
+    assert a.dim() >= 2 and b.dim() >= 2, "accumulate_matmul expects matrices"
+    batch = torch.broadcast_shapes(a.shape[:-2], b.shape[:-2])
+    m, n = a.shape[-2], b.shape[-1]
+    a = a.expand(*batch, *a.shape[-2:]).reshape(-1, m, a.shape[-1])
+    b = b.expand(*batch, *b.shape[-2:]).reshape(-1, b.shape[-2], n)
+    c = None if bias is None else bias.expand(*batch, m, n).reshape(-1, m, n)
+    return _accumulate_bmm(a, b, c, acc, chunk).view(*batch, m, n)
+
+
+def accumulate_conv2d(x, weight, acc, chunk=1, bias=None, stride=1, padding=0, dilation=1, groups=1):
+    """
+    2D convolution with a low-precision accumulator, see `accumulate_matmul`. The reduction
+    runs over (input channel, kernel row, kernel column) in that order, per group, and the
+    bias is the initial value of the accumulator.
+
+    Args:
+        - :attr: `x` (torch.Tensor) : [N, C, H, W] CPU tensor
+        - :attr: `weight` (torch.Tensor) : [O, C / groups, kH, kW]
+        - the other arguments as in `accumulate_matmul` and `torch.nn.functional.conv2d`
+
+    Returns:
+        - the fp32 result, [N, O, H', W'] (torch.Tensor)
+    """
+    batch, channels, height, width = x.shape
+    out_channels, _, kh, kw = weight.shape
+    pair = lambda v: (v, v) if isinstance(v, int) else tuple(v)
+    stride, padding, dilation = pair(stride), pair(padding), pair(dilation)
+    out_h = (height + 2 * padding[0] - dilation[0] * (kh - 1) - 1) // stride[0] + 1
+    out_w = (width + 2 * padding[1] - dilation[1] * (kw - 1) - 1) // stride[1] + 1
+    # [N, C * kH * kW, L] columns, split by group: [N * groups, C / groups * kH * kW, L]
+    cols = F.unfold(x, (kh, kw), dilation=dilation, padding=padding, stride=stride)
+    cols = cols.view(batch * groups, -1, out_h * out_w)
+    # one weight matrix per group, used in turn over the batch
+    w = weight.reshape(groups, out_channels // groups, -1)
+    c = None
+    if bias is not None:
+        c = bias.view(1, groups, out_channels // groups, 1).expand(batch, -1, -1, out_h * out_w)
+        c = c.reshape(batch * groups, out_channels // groups, out_h * out_w)
+    out = _accumulate_bmm(w, cols, c, acc, chunk)
+    return out.view(batch, out_channels, out_h, out_w)
+
+
+def _mx_bits(element):
+    if type(element) == FixedPoint:
+        return element.wl
+    elif type(element) == FloatingPoint:
+        return 1 + element.exp + element.man
+    elif type(element) == Posit:
+        return element.nsize
+    raise ValueError("unsupported MX element format {}".format(element))
+
+
+def mx_quantize(x, element, block_size=32):
+    """
+    Microscaling (MX) block quantization: every `block_size` consecutive elements along the
+    last dim share a power-of-two scale, stored as an 8-bit exponent, and each element is
+    stored in `element` relative to it. Blocks holding inf or NaN decode to NaN.
+
+    Args:
+        - :attr: `x` (torch.Tensor) : fp32 CPU tensor
+        - :attr: `element` (qtorch.Number) : element format of at most 8 bits:
+          `FixedPoint(wl, fl)` for integers (MXINT8 is FixedPoint(8, 6, symmetric=True)),
+          `FloatingPoint(exp, man)` with subnormals (FP8 E4M3/E5M2, FP6 E2M3/E3M2, FP4 E2M1),
+          rounded to nearest even and saturated, or `Posit(nsize, es)`
+        - :attr: `block_size` (int) : elements per shared scale, 16, 32 or 64 (any even size works)
+
+    Returns:
+        - the fake-quantized fp32 values, like x
+        - the element codes (uint8 tensor), two per byte (low nibble first) for elements of
+          at most 4 bits
+        - the block scales, biased by 127 (uint8 tensor, [..., ceil(n / block_size)])
+    """
+    _mx_bits(element)
+    quant_module = get_cpu_module(x)
+    x = x.float().contiguous()
+    if type(element) == FixedPoint:
+        return quant_module.fixed_point_mx_quantize(x, block_size, element.wl, element.fl, element.symmetric)
+    elif type(element) == FloatingPoint:
+        return quant_module.float_mx_quantize(x, block_size, element.man, element.exp)
+    return quant_module.posit_mx_quantize(x, block_size, element.nsize, element.es)
+
+
+def mx_unpack(payload, scales, element, block_size=32, n=None):
+    """
+    Decode the packed output of `mx_quantize`. `n` is the size of the last dim, needed only
+    when it is odd and two elements share a byte.
+    """
+    per_byte = 2 if _mx_bits(element) <= 4 else 1
+    n = payload.shape[-1] * per_byte if n is None else n
+    quant_module = get_cpu_module(payload)
+    payload, scales = payload.contiguous(), scales.contiguous()
+    if type(element) == FixedPoint:
+        return quant_module.fixed_point_mx_unpack(payload, scales, block_size, n, element.wl, element.fl)
+    elif type(element) == FloatingPoint:
+        return quant_module.float_mx_unpack(payload, scales, block_size, n, element.man, element.exp)
+    return quant_module.posit_mx_unpack(payload, scales, block_size, n, element.nsize, element.es)
+
+
+def _packed_format(fmt):
+    """(kind, p1, p2, scale, symmetric) of a packed storage format, as the transcoding kernel takes it"""
+    if type(fmt) == Posit:
+        return 0, fmt.nsize, fmt.es, fmt.scale, False
+    elif type(fmt) == FloatingPoint:
+        return 1, fmt.man, fmt.exp, 1.0, False
+    elif type(fmt) == FixedPoint:
+        return 2, fmt.wl, fmt.fl, 1.0, fmt.symmetric
+    raise ValueError("unsupported packed format {}".format(fmt))
+
+
+def transcode(p, src, dst):
+    """
+    Convert packed values from one storage format to another without going through an fp32
+    tensor (CPU, multithreaded): each value is rounded to nearest in `dst` once, exactly as
+    unpacking and packing again would. 8-bit sources, and large 16-bit ones, go through a
+    table of the result of every code.
+
+    Args:
+        - :attr: `p` : packed values in `src`: posit bits from `posit_pack`, FP8 codes from
+          `float_pack`, a torch.bfloat16 tensor, or a `PackedFixedPoint` (or its int8/int16 data)
+        - :attr: `src`, `dst` (qtorch.Number) : `Posit(nsize <= 16, es, scale)`,
+          `FloatingPoint(exp=4, man=3)` / `FloatingPoint(exp=5, man=2)` for FP8,
+          `FloatingPoint(exp=8, man=7)` for bf16, or `FixedPoint(wl <= 16, fl)`
+
+    Returns:
+        - the values packed in `dst`: a torch.bfloat16 tensor for bf16, a `PackedFixedPoint`
+          for fixed point, else posit bits or FP8 codes as the pack functions return them
+    """
+    if isinstance(p, PackedFixedPoint):
+        p = p.data
+    if p.dtype == torch.bfloat16:
+        p = p.view(torch.int16)
+    quant_module = get_cpu_module(p)
+    out = quant_module.transcode(p.contiguous(), *_packed_format(src)[:4], *_packed_format(dst))
+    if type(dst) == FloatingPoint and dst.exp == 8:
+        return out.view(torch.bfloat16)
+    elif type(dst) == FixedPoint:
+        return PackedFixedPoint(out, dst.wl, dst.fl)
+    return out
+
+
 def posit_sigmoid(x, nsize, es=0, scale = 1.0, rounding="nearest"):
     """
     Quantize a single precision Floating Point into low-precision Floating Point
@@ -431,6 +1006,35 @@ def posit_tanh_enhanced(x, nsize, es=0, scale = 1.0, rounding="nearest"):
     out = quant_module.posit_tanh_enhanced(x.contiguous(), nsize, 0, scale)
     return out
 
+def posit_activation_forward(x, activation, nsize=16):
+    """
+    `posit_sigmoid`, `posit_tanh` or `posit_tanh_enhanced` (es = 0, CPU, multithreaded),
+    also returning what backward needs: the posit bits of the sigmoid the output is made
+    from, which give the output back exactly in half the memory of an fp32 copy
+
+    Args:
+        - :attr: `x` (torch.Tensor) : the single precision input
+        - :attr: `activation` (string) : \"sigmoid\", \"tanh\" or \"tanh_enhanced\"
+        - :attr: `nsize` (int) : 8 or 16
+
+    Returns:
+        - the output (torch.Tensor) and the bits to save (torch.int16 tensor)
+    """
+    assert activation in ["sigmoid", "tanh", "tanh_enhanced"], "invalid activation, {}".format(activation)
+    assert nsize in [8,16], "only nsize = 8 or 16 is supported, es automatically set to 0"
+    quant_module = get_cpu_module(x)
+    return getattr(quant_module, "posit_{}_forward".format(activation))(x.float().contiguous(), nsize)
+
+
+def posit_activation_backward(grad_output, saved, activation, nsize=16):
+    """
+    Gradient of the activation from the bits saved by `posit_activation_forward`, in one pass:
+    grad_output * y * (1 - y) for sigmoid, grad_output * (1 - y * y) for tanh
+    """
+    quant_module = get_cpu_module(grad_output)
+    return getattr(quant_module, "posit_{}_backward".format(activation))(grad_output.float().contiguous(), saved, nsize)
+
+
 def new_format_quantize(x, scale = 1.0, rounding="nearest"):
     """
     Quantize a single precision Floating Point into low-precision Floating Point
@@ -482,6 +1086,9 @@ def configurable_table_quantize(x, table_lookup, scale = 1.0, rounding="nearest"
     assert isinstance(x, torch.Tensor), "x is not a single precision Floating Point Tensor"
     assert rounding in ["stochastic", "nearest"], "invalid rounding mode, {}".format(rounding)
     quant_module = get_module(x)
+    if not x.is_cuda:
+        return autotune.dispatch("configurable_table_quantize", (table_lookup.numel(),), x.contiguous(),
+                                 table_lookup.contiguous(), scale)
     out = quant_module.configurable_table_quantize(x.contiguous(), table_lookup.contiguous(), scale)
     return out
 
@@ -0,0 +1,59 @@
+import torch
+import torch.nn.functional as F
+import unittest
+from qtorch import FixedPoint, FloatingPoint, Posit
+from qtorch.quant import posit_quantize, posit_dot, float_quantize
+from qtorch.quant import accumulate_matmul, accumulate_conv2d
+
+
+class TestAccumulate(unittest.TestCase):
+    """
+    invariant: the partial sum is rounded to the accumulator format after every chunk of
+    products, so a wide enough format reproduces the fp32 result and chunk=1 matches a
+    sequence of rounded multiply-accumulates
+    """
+
+    def test_wide_accumulator(self):
+        a = posit_quantize(torch.randn(3, 17, 40), 8, 1)
+        b = posit_quantize(torch.randn(40, 9), 8, 1)
+        expected = torch.matmul(a.double(), b.double()).float()
+        for acc in [FloatingPoint(exp=8, man=23), FixedPoint(wl=40, fl=24)]:
+            out = accumulate_matmul(a, b, acc, chunk=40)
+            self.assertEqual(out.shape, (3, 17, 9))
+            self.assertTrue(torch.equal(out, expected))
+        # one rounding of the exact sum, as in a quire
+        out = accumulate_matmul(a, b, Posit(16, 1), chunk=40)
+        self.assertTrue(torch.equal(out, posit_dot(a.unsqueeze(-2), b.t(), 16, 1, dim=-1)))
+
+    def test_chunk_one(self):
+        a = float_quantize(torch.randn(5, 30), exp=5, man=4, rounding="nearest")
+        b = float_quantize(torch.randn(30, 7), exp=5, man=4, rounding="nearest")
+        out = accumulate_matmul(a, b, FloatingPoint(exp=5, man=4), chunk=1)
+        acc = torch.zeros(5, 7)
+        for k in range(30):
+            exact = acc.double() + a[:, k:k + 1].double() * b[k:k + 1, :].double()
+            acc = float_quantize(exact.float(), exp=5, man=4, rounding="nearest")
+        self.assertTrue(torch.equal(out, acc))
+
+    def test_chunk_size(self):
+        # 1 + 64 * 2^-8 needs the small terms summed before they meet the accumulator
+        a = torch.cat([torch.ones(1, 1), torch.full((1, 64), 2.0 ** -8)], 1)
+        b = torch.ones(65, 1)
+        acc = FloatingPoint(exp=5, man=4)
+        self.assertEqual(accumulate_matmul(a, b, acc, chunk=1).item(), 1.0)
+        self.assertEqual(accumulate_matmul(a, b, acc, chunk=65).item(), 1.25)
+        self.assertEqual(accumulate_matmul(a, b, FixedPoint(wl=8, fl=2), chunk=65).item(), 1.25)
+
+    def test_conv2d(self):
+        x = posit_quantize(torch.randn(2, 4, 9, 8), 8, 1)
+        w = posit_quantize(torch.randn(6, 2, 3, 3), 8, 1)
+        bias = posit_quantize(torch.randn(6), 8, 1)
+        acc = FloatingPoint(exp=8, man=23)
+        out = accumulate_conv2d(x, w, acc, chunk=1000, bias=bias, stride=(2, 1), padding=1, groups=2)
+        expected = F.conv2d(x.double(), w.double(), bias.double(), stride=(2, 1), padding=1, groups=2)
+        self.assertEqual(out.shape, expected.shape)
+        self.assertTrue(torch.equal(out, expected.float()))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,85 @@
+import os
+import time
+import json
+import tempfile
+import torch
+import unittest
+from qtorch.quant import autotune, posit_quantize, configurable_table_quantize
+
+
+def sleeper(seconds):
+    def variant(x, *args):
+        time.sleep(seconds)
+        return x + 1
+    return variant
+
+
+class TestAutotune(unittest.TestCase):
+    """
+    invariant: the first call for an (op, config, size bucket) runs the fastest variant and
+    remembers it, overrides win, and every registered variant gives the same result
+    """
+
+    def setUp(self):
+        autotune.register_variant("toy", "slow", sleeper(0.02))
+        autotune.register_variant("toy", "fast", sleeper(0.0))
+        autotune.register_variant("toy", "small_only", sleeper(0.01), applies=lambda n: n < 4)
+        autotune.clear()
+        os.environ.pop("QTORCH_KERNEL_VARIANT", None)
+
+    def tearDown(self):
+        os.environ.pop("QTORCH_KERNEL_VARIANT", None)
+        autotune.set_cache_file(None)
+
+    def test_picks_fastest(self):
+        x = torch.zeros(10)
+        self.assertTrue(torch.equal(autotune.dispatch("toy", (8,), x), x + 1))
+        self.assertEqual(autotune.winners(), {("toy", (8,), 4): "fast"})
+        # a different size bucket is tuned separately
+        autotune.dispatch("toy", (8,), torch.zeros(1000))
+        self.assertEqual(len(autotune.winners()), 2)
+
+    def test_override(self):
+        os.environ["QTORCH_KERNEL_VARIANT"] = "toy=slow"
+        start = time.perf_counter()
+        autotune.dispatch("toy", (2,), torch.zeros(3))
+        self.assertGreater(time.perf_counter() - start, 0.015)
+        self.assertEqual(autotune.winners(), {})
+        os.environ["QTORCH_KERNEL_VARIANT"] = "small_only"
+        with self.assertRaises(AssertionError):
+            autotune.dispatch("toy", (8,), torch.zeros(3))
+
+    def test_disk_cache(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "autotune.json")
+            autotune.set_cache_file(path)
+            autotune.dispatch("toy", (8,), torch.zeros(10))
+            entries = list(json.load(open(path)).values())[0]
+            self.assertEqual(entries, {"toy[8]@4": "fast"})
+            # a fresh process would read the winner back instead of timing again
+            autotune.clear()
+            machines = list(json.load(open(path)))
+            with open(path, "w") as f:
+                json.dump({machine: {"toy[8]@4": "slow"} for machine in machines}, f)
+            start = time.perf_counter()
+            autotune.dispatch("toy", (8,), torch.zeros(10))
+            self.assertLess(time.perf_counter() - start, 0.05)
+            self.assertEqual(autotune.winners(), {("toy", (8,), 4): "slow"})
+
+    def test_variants_agree(self):
+        x = torch.randn(50000) * 100
+        for nsize, es in [(8, 1), (12, 1), (16, 2)]:
+            expected = posit_quantize(x, nsize, es, scale=0.5)
+            for variant in ["scalar", "parallel", "packed"]:
+                os.environ["QTORCH_KERNEL_VARIANT"] = variant
+                self.assertTrue(torch.equal(posit_quantize(x, nsize, es, scale=0.5), expected))
+            os.environ.pop("QTORCH_KERNEL_VARIANT")
+        table = torch.tensor([0.0, 0.25, 0.5, 1.0, 2.0, 4.0])
+        expected = configurable_table_quantize(x, table, 2.0)
+        for variant in ["scalar", "parallel"]:
+            os.environ["QTORCH_KERNEL_VARIANT"] = variant
+            self.assertTrue(torch.equal(configurable_table_quantize(x, table, 2.0), expected))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,56 @@
+import os
+import tempfile
+import torch
+import unittest
+from qtorch import Posit, PositEmbedding, save_posit_checkpoint, load_posit_checkpoint
+from qtorch.quant import posit_quantize
+
+
+class TestCheckpoint(unittest.TestCase):
+    """
+    invariant: a posit checkpoint loads back bit-identical tensors and packs representable ones
+    """
+
+    def setUp(self):
+        self.dir = tempfile.mkdtemp()
+        self.path = os.path.join(self.dir, "model.qtp")
+
+    def test_round_trip(self):
+        state = {
+            "fc.weight": posit_quantize(torch.randn(64, 32), 8, 1),
+            "fc.bias": posit_quantize(torch.randn(64), 16, 1),
+            "bn.running_mean": torch.randn(64),
+            "bn.num_batches_tracked": torch.tensor(7),
+        }
+        save_posit_checkpoint(state, self.path, [Posit(8, 1), Posit(16, 1)])
+        with load_posit_checkpoint(self.path) as ckpt:
+            self.assertEqual(ckpt.entries["fc.weight"]["nsize"], 8)
+            self.assertEqual(ckpt.entries["fc.bias"]["nsize"], 16)
+            self.assertEqual(ckpt.entries["bn.running_mean"]["format"], "raw")
+            loaded = ckpt.state_dict()
+            for name, tensor in state.items():
+                self.assertEqual(loaded[name].dtype, tensor.dtype)
+                self.assertTrue(torch.equal(loaded[name], tensor))
+            del loaded
+        self.assertLess(os.path.getsize(self.path), 64 * 32 + 64 * 2 + 64 * 4 + 8 + 4096)
+
+    def test_packed_embedding(self):
+        weight = posit_quantize(torch.randn(100, 16), 8, 1, scale=4.0)
+        save_posit_checkpoint({"emb.weight": weight}, self.path, Posit(8, 1, scale=4.0))
+        ckpt = load_posit_checkpoint(self.path)
+        emb = PositEmbedding.from_packed(*ckpt.packed("emb.weight"))
+        indices = torch.randint(0, 100, (5, 3))
+        self.assertTrue(torch.equal(emb(indices), weight[indices]))
+
+    def test_close_with_live_view(self):
+        save_posit_checkpoint({"bias": torch.randn(8)}, self.path, Posit(8, 1))
+        ckpt = load_posit_checkpoint(self.path)
+        bias = ckpt["bias"]
+        with self.assertRaisesRegex(BufferError, "clone"):
+            ckpt.close()
+        bias = bias.clone()
+        ckpt.close()
+
+
+if __name__ == "__main__":
+    unittest.main()
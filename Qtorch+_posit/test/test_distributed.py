@@ -0,0 +1,84 @@
+import os
+import tempfile
+import torch
+import torch.distributed as dist
+import torch.multiprocessing as mp
+import unittest
+from torch.nn.parallel import DistributedDataParallel
+from qtorch.quant import posit_pack, posit_unpack, posit_quantize
+from qtorch.distributed import PositCompressionState, posit_compress_hook
+
+def make_model():
+    torch.manual_seed(0)
+    return torch.nn.Sequential(torch.nn.Linear(32, 64), torch.nn.ReLU(), torch.nn.Linear(64, 4))
+
+
+def count_sent(sent, world_size):
+    """wrap the collectives of the hook to add up the bytes this rank sends"""
+    all_to_all_single, all_gather = dist.all_to_all_single, dist.all_gather
+
+    def counted_all_to_all_single(output, input, *args, **kwargs):
+        # the shard a rank owns stays local
+        sent[0] += input.numel() * input.element_size() * (world_size - 1) // world_size
+        return all_to_all_single(output, input, *args, **kwargs)
+
+    def counted_all_gather(tensors, tensor, *args, **kwargs):
+        sent[0] += tensor.numel() * tensor.element_size() * (world_size - 1)
+        return all_gather(tensors, tensor, *args, **kwargs)
+
+    dist.all_to_all_single, dist.all_gather = counted_all_to_all_single, counted_all_gather
+
+
+def run_ddp(rank, world_size, init_file, result_file, nsize, error_feedback):
+    dist.init_process_group("gloo", init_method="file://" + init_file, rank=rank, world_size=world_size)
+    reference = DistributedDataParallel(make_model())
+    compressed = DistributedDataParallel(make_model())
+    compressed.register_comm_hook(PositCompressionState(nsize=nsize, es=2, error_feedback=error_feedback),
+                                  posit_compress_hook)
+
+    torch.manual_seed(rank + 1)
+    x = torch.randn(16, 32)
+    reference(x).pow(2).sum().backward()
+    sent = [0]
+    count_sent(sent, world_size)
+    compressed(x).pow(2).sum().backward()
+
+    if rank == 0:
+        grads = [(p.grad, q.grad) for p, q in zip(reference.parameters(), compressed.parameters())]
+        torch.save((grads, sent[0]), result_file)
+    dist.barrier()
+    dist.destroy_process_group()
+
+
+class TestDistributed(unittest.TestCase):
+    """
+    invariant: the posit compression hook averages gradients across ranks up to posit rounding,
+    sending 2x (posit16) to 4x (posit8) less than an fp32 all-reduce at any world size
+    """
+
+    def test_pack_roundtrip(self):
+        a = torch.randn(1000)
+        for nsize, es in [(8, 1), (8, 2), (16, 1), (6, 2)]:
+            packed = posit_pack(a, nsize, es, scale=4.0)
+            self.assertEqual(packed.dtype, torch.uint8 if nsize <= 8 else torch.int16)
+            unpacked = posit_unpack(packed, nsize, es, scale=4.0)
+            quantized = posit_quantize(a, nsize, es, scale=4.0)
+            self.assertTrue(torch.equal(unpacked, quantized))
+
+    def test_compress_hook(self):
+        n = sum(p.numel() for p in make_model().parameters())
+        for world_size, nsize, error_feedback in [(2, 8, False), (2, 16, True), (4, 8, True), (4, 16, False)]:
+            with tempfile.TemporaryDirectory() as tmp:
+                init_file = os.path.join(tmp, "init")
+                result_file = os.path.join(tmp, "grads.pt")
+                mp.spawn(run_ddp, args=(world_size, init_file, result_file, nsize, error_feedback), nprocs=world_size)
+                grads, sent = torch.load(result_file)
+                for ref, comp in grads:
+                    rel = ((ref - comp).norm() / ref.norm()).item()
+                    self.assertLess(rel, 0.1 if nsize == 8 else 1e-2)
+                # a ring fp32 all-reduce sends about 8 * n bytes per rank, at any world size
+                self.assertLess(sent, 8 * n * (nsize // 8) / 4)
+
+
+if __name__ == "__main__":
+    unittest.main()
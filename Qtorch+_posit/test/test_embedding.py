@@ -0,0 +1,54 @@
+import torch
+import unittest
+from qtorch import PositEmbedding, PositEmbeddingBag
+from qtorch.quant import posit_quantize
+
+
+class TestEmbedding(unittest.TestCase):
+    """
+    invariant: packed posit embeddings return the posit-rounded rows of the fp32 table
+    """
+
+    def test_embedding_lookup(self):
+        for nsize, es in [(8, 1), (16, 1)]:
+            dense = torch.nn.Embedding(100, 16)
+            emb = PositEmbedding.from_embedding(dense, nsize=nsize, es=es, per_row_scale=False)
+            self.assertEqual(emb.weight.element_size(), 1 if nsize == 8 else 2)
+            indices = torch.randint(0, 100, (4, 7))
+            expected = posit_quantize(dense.weight.detach(), nsize, es)[indices]
+            self.assertTrue(torch.equal(emb(indices), expected))
+
+    def test_row_scale(self):
+        weight = torch.randn(50, 8) * torch.logspace(-6, 2, 50).unsqueeze(1)
+        emb = PositEmbedding(50, 8, nsize=8, es=1, weight=weight)
+        rel = ((emb.dequantize() - weight).norm(dim=1) / weight.norm(dim=1)).max().item()
+        self.assertLess(rel, 0.05)
+
+    def test_embedding_bag(self):
+        dense = torch.nn.EmbeddingBag(100, 16, mode="mean")
+        emb = PositEmbeddingBag.from_embedding_bag(dense, nsize=16, es=1)
+        indices = torch.randint(0, 100, (10,))
+        offsets = torch.tensor([0, 3, 3, 7])
+        expected = torch.nn.functional.embedding_bag(indices, emb.dequantize(), offsets, mode="mean")
+        self.assertTrue(torch.allclose(emb(indices, offsets), expected, atol=1e-6))
+
+    def test_sparse_update(self):
+        weight = torch.zeros(10, 4)
+        emb = PositEmbedding(10, 4, nsize=16, es=1, per_row_scale=False, weight=weight)
+        indices = torch.tensor([1, 3, 1])
+        emb(indices).sum().backward()
+        emb.step(lr=0.5)
+        updated = emb.dequantize()
+        self.assertTrue(torch.equal(updated[1], torch.full((4,), -1.0)))
+        self.assertTrue(torch.equal(updated[3], torch.full((4,), -0.5)))
+        self.assertTrue(torch.equal(updated[0], torch.zeros(4)))
+
+    def test_stochastic_rounding_unbiased(self):
+        emb = PositEmbedding(1, 1000, nsize=8, es=1, per_row_scale=False, weight=torch.ones(1, 1000))
+        emb(torch.tensor([0])).sum().backward()
+        emb.step(lr=0.01)
+        self.assertAlmostEqual(emb.dequantize().mean().item(), 0.99, delta=0.005)
+
+
+if __name__ == "__main__":
+    unittest.main()
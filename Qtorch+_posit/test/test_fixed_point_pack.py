@@ -0,0 +1,49 @@
+import torch
+import unittest
+from qtorch import FixedPoint
+from qtorch.quant import fixed_point_quantize, fixed_point_pack, fixed_point_unpack, fixed_point_matmul
+
+
+class TestFixedPointPack(unittest.TestCase):
+    """
+    invariant: packed fixed point holds the integers of fixed_point_quantize, and the integer
+    GEMM equals the exact product requantized to the output format
+    """
+
+    def test_roundtrip(self):
+        x = torch.randn(1000) * 10
+        for wl, fl, dtype in [(8, 4, torch.int8), (4, 1, torch.int8), (12, 6, torch.int16), (16, 10, torch.int16)]:
+            for symmetric in [False, True]:
+                p = fixed_point_pack(x, wl, fl, symmetric=symmetric)
+                self.assertEqual(p.data.dtype, dtype)
+                self.assertEqual((p.wl, p.fl), (wl, fl))
+                expected = fixed_point_quantize(x, wl, fl, symmetric=symmetric, rounding="nearest")
+                self.assertTrue(torch.equal(fixed_point_unpack(p), expected))
+
+    def test_stochastic(self):
+        p = fixed_point_pack(torch.full((100000,), 0.3), 8, 2, rounding="stochastic")
+        self.assertEqual(set(p.data.tolist()), {1, 2})
+        self.assertAlmostEqual(fixed_point_unpack(p).mean().item(), 0.3, places=2)
+
+    def test_matmul(self):
+        a = fixed_point_pack(torch.randn(3, 5, 70), 8, 5)
+        b = fixed_point_pack(torch.randn(70, 33) / 8, 8, 7)
+        bias = fixed_point_quantize(torch.randn(33), 16, 12, rounding="nearest")
+        exact = fixed_point_unpack(a).double() @ fixed_point_unpack(b).double() + bias.double()
+        for out in [FixedPoint(8, 3), FixedPoint(16, 10), FixedPoint(16, 14, symmetric=True)]:
+            c = fixed_point_matmul(a, b, out, bias=bias)
+            self.assertEqual(c.data.shape, (3, 5, 33))
+            self.assertEqual(c.fl, out.fl)
+            expected = fixed_point_quantize(exact.float(), out.wl, out.fl, symmetric=out.symmetric, rounding="nearest")
+            self.assertTrue(torch.equal(fixed_point_unpack(c), expected))
+
+    def test_mixed_widths(self):
+        a = fixed_point_pack(torch.randn(4, 9), 16, 12)
+        b = fixed_point_pack(torch.randn(9, 2), 6, 3)
+        c = fixed_point_matmul(a, b, FixedPoint(16, 8))
+        exact = fixed_point_unpack(a).double() @ fixed_point_unpack(b).double()
+        self.assertTrue(torch.equal(fixed_point_unpack(c), fixed_point_quantize(exact.float(), 16, 8, rounding="nearest")))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,54 @@
+import torch
+import unittest
+from qtorch.quant import float_quantize, float_pack, float_unpack
+
+
+def fp8_values(exp, man):
+    """every finite FP8 value, decoded by hand"""
+    bias = 2 ** (exp - 1) - 1
+    values = []
+    for e in range(2 ** exp):
+        for m in range(2 ** man):
+            if (exp == 5 and e == 31) or (exp == 4 and e == 15 and m == 7):
+                continue
+            values.append(m * 2.0 ** (1 - bias - man) if e == 0 else (1 + m / 2 ** man) * 2.0 ** (e - bias))
+    return torch.tensor(values)
+
+
+class TestFP8(unittest.TestCase):
+    """
+    invariant: FP8 codes decode to the OCP E4M3/E5M2 values, and encoding rounds to the
+    nearest of them (ties to even), saturating at the largest finite value
+    """
+
+    def test_decode_table(self):
+        for exp, man, top in [(4, 3, 448.0), (5, 2, 57344.0)]:
+            values = float_unpack(torch.arange(128, dtype=torch.uint8), exp, man)
+            finite = values[torch.isfinite(values)]
+            self.assertTrue(torch.equal(finite, fp8_values(exp, man)))
+            self.assertEqual(finite.max().item(), top)
+            self.assertTrue(torch.equal(float_pack(finite, exp, man), torch.arange(finite.numel(), dtype=torch.uint8)))
+
+    def test_nearest(self):
+        for exp, man in [(4, 3), (5, 2)]:
+            grid = fp8_values(exp, man)
+            x = torch.randn(10000) * 2.0 ** torch.randint(-20, 20, (10000,)).float()
+            q = float_quantize(x, exp, man, rounding="nearest", fp8=True)
+            self.assertTrue(torch.equal(q, float_unpack(float_pack(x, exp, man), exp, man)))
+            err = (x.abs().clamp(max=grid.max()).unsqueeze(1) - grid).abs()
+            self.assertTrue(torch.equal((q.abs() - x.abs().clamp(max=grid.max())).abs(), err.min(1).values))
+
+    def test_subnormals_and_saturation(self):
+        x = torch.tensor([2.0 ** -9, 2.0 ** -10, 3 * 2.0 ** -10, 500.0, float("inf"), -float("inf"), float("nan")])
+        self.assertEqual(float_pack(x, 4, 3).tolist(), [0x01, 0x00, 0x02, 0x7E, 0x7E, 0xFE, 0x7F])
+        self.assertEqual(float_pack(torch.tensor([60000.0, float("inf")]), 5, 2).tolist(), [0x7B, 0x7C])
+
+    def test_stochastic(self):
+        x = torch.full((100000,), 1.1)
+        q = float_quantize(x, 4, 3, rounding="stochastic", fp8=True)
+        self.assertEqual(set(q.tolist()), {1.0, 1.125})
+        self.assertAlmostEqual(q.mean().item(), 1.1, places=2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,54 @@
+import torch
+import unittest
+from qtorch import FixedPoint, FloatingPoint, Posit
+from qtorch.quant import posit_quantize, mx_quantize, mx_unpack
+
+
+class TestMX(unittest.TestCase):
+    """
+    invariant: each block is scaled by a shared power of two and its elements are rounded
+    to the element format; the packed codes decode to the fake-quantized values
+    """
+
+    def test_roundtrip(self):
+        x = torch.randn(7, 100) * torch.exp2(torch.randint(-10, 10, (7, 1)).float())
+        for element in [FixedPoint(8, 6, symmetric=True), FloatingPoint(exp=4, man=3), FloatingPoint(exp=5, man=2),
+                        FloatingPoint(exp=2, man=1), Posit(8, 1), Posit(4, 1)]:
+            for block_size in [16, 32, 64]:
+                fake, payload, scales = mx_quantize(x, element, block_size)
+                self.assertEqual(scales.shape, (7, (100 + block_size - 1) // block_size))
+                self.assertEqual(payload.dtype, torch.uint8)
+                self.assertTrue(torch.equal(mx_unpack(payload, scales, element, block_size, n=100), fake))
+
+    def test_shared_scale(self):
+        # the block maximum sets the scale: 3.0 lands in [2, 4) for MXINT8, whose largest power of two is 1
+        x = torch.tensor([[3.0, 0.75, -0.01, 0.5] * 4])
+        fake, payload, scales = mx_quantize(x, FixedPoint(8, 6, symmetric=True), 16)
+        self.assertEqual(scales.item(), 127 + 1)
+        self.assertEqual(fake[0, :4].tolist(), [3.0, 0.75, 0.0, 0.5])
+        self.assertEqual(payload[0, :4].tolist(), [96, 24, 0, 16])
+
+    def test_fp4_packing(self):
+        x = torch.tensor([[6.0, -0.5, 1.0, 100.0] + [0.0] * 12])
+        fake, payload, scales = mx_quantize(x, FloatingPoint(exp=2, man=1), 16)
+        self.assertEqual(payload.shape, (1, 8))
+        # 100 sets the scale 2^(6 - 2) and the rest is rounded in E2M1 relative to it
+        self.assertEqual(scales.item(), 127 + 4)
+        self.assertEqual(fake[0, :4].tolist(), [8.0, -0.0, 0.0, 96.0])
+        # -0.5 underflows to -0, which keeps its sign bit (-0.0 == 0.0 would not show it)
+        self.assertEqual(payload[0, 0].item() >> 4, 0x8)
+        self.assertTrue(torch.signbit(fake[0, 1]))
+
+    def test_posit_elements_and_nan(self):
+        x = torch.randn(4, 32)
+        x[2, 5] = float("nan")
+        fake, _, scales = mx_quantize(x, Posit(8, 1), 32)
+        self.assertEqual(scales[2].item(), 255)
+        self.assertTrue(torch.isnan(fake[2]).all())
+        s = torch.exp2(scales[[0, 1, 3]].float() - 127)
+        expected = posit_quantize(x[[0, 1, 3]] / s, 8, 1) * s
+        self.assertTrue(torch.equal(fake[[0, 1, 3]], expected))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,38 @@
+import torch
+import unittest
+from qtorch import PositSigmoidModule, PositTanhModule, PositTanhModuleEnhanced
+from qtorch.quant import posit_sigmoid, posit_tanh, posit_tanh_enhanced
+from qtorch.quant import posit_activation_forward, posit_activation_backward
+
+
+class TestPositActivation(unittest.TestCase):
+    """
+    invariant: the saved posit bits give the forward output back exactly, so the fused
+    backward equals the gradient computed from a saved fp32 output
+    """
+
+    def test_forward_backward(self):
+        x = torch.randn(1000) * 4
+        g = torch.randn(1000)
+        for activation, fn in [("sigmoid", posit_sigmoid), ("tanh", posit_tanh), ("tanh_enhanced", posit_tanh_enhanced)]:
+            for nsize in [8, 16]:
+                y, bits = posit_activation_forward(x, activation, nsize)
+                self.assertEqual(bits.dtype, torch.int16)
+                self.assertTrue(torch.equal(y, fn(x, nsize)))
+                expected = g * (y * (1 - y)) if activation == "sigmoid" else g * (1 - y * y)
+                self.assertTrue(torch.equal(posit_activation_backward(g, bits, activation, nsize), expected))
+
+    def test_modules(self):
+        for module, fn in [(PositSigmoidModule(), posit_sigmoid), (PositTanhModule(), posit_tanh),
+                           (PositTanhModuleEnhanced(), posit_tanh_enhanced)]:
+            x = torch.randn(16, 32, requires_grad=True)
+            y = module(x)
+            self.assertTrue(torch.equal(y, fn(x.detach(), 16)))
+            y.backward(torch.ones_like(y))
+            out = y.detach()
+            expected = out * (1 - out) if isinstance(module, PositSigmoidModule) else 1 - out * out
+            self.assertTrue(torch.equal(x.grad, expected))
+
+
+if __name__ == "__main__":
+    unittest.main()
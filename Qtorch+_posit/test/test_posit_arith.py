@@ -0,0 +1,69 @@
+import torch
+import unittest
+from qtorch.quant import posit_quantize, posit_pack, posit_unpack
+from qtorch.quant import posit_add, posit_sub, posit_mul, posit_div, posit_fma, posit_sqrt
+
+
+def all_posit8(es):
+    """every posit(8, es) value except NaR, as fp32"""
+    values = posit_unpack(torch.arange(256, dtype=torch.int16).to(torch.uint8), 8, es)
+    return values[torch.isfinite(values)]
+
+
+class TestPositArith(unittest.TestCase):
+    """
+    invariant: posit ops round the exact result once, which equals quantizing the
+    fp32 result whenever fp32 holds that result exactly
+    """
+
+    def test_exhaustive_posit8(self):
+        values = all_posit8(1)
+        a = values.repeat_interleave(values.numel())
+        b = values.repeat(values.numel())
+        for op, ref in [(posit_add, torch.add), (posit_sub, torch.sub), (posit_mul, torch.mul), (posit_div, torch.div)]:
+            exact = ref(a.double(), b.double())
+            mask = exact.float().double() == exact
+            expected = posit_quantize(exact.float(), 8, 1)
+            self.assertTrue(torch.equal(op(a, b, 8, 1)[mask], expected[mask]))
+
+    def test_single_rounding(self):
+        # 1 + 1/32 is halfway between two posit(8, 1) values, a tiny addend breaks the tie
+        x = torch.tensor([1.03125, 1.03125])
+        y = torch.tensor([2.0 ** -40, -(2.0 ** -40)])
+        self.assertEqual(posit_quantize(x + y, 8, 1).tolist(), [1.0, 1.0])
+        self.assertEqual(posit_add(x, y, 8, 1).tolist(), [1.0625, 1.0])
+        # a * b + c rounded once: the product alone would drop its 2^-24
+        a = torch.tensor([1 + 2.0 ** -12])
+        c = -(1 + 2.0 ** -11)
+        self.assertEqual(posit_add(posit_mul(a, a, 16, 1), c, 16, 1).item(), 0.0)
+        self.assertEqual(posit_fma(a, a, c, 16, 1).item(), 2.0 ** -24)
+
+    def test_sqrt(self):
+        values = all_posit8(1)
+        values = values[values >= 0]
+        expected = posit_quantize(torch.sqrt(values.double()).float(), 8, 1)
+        self.assertTrue(torch.equal(posit_sqrt(values, 8, 1), expected))
+        self.assertTrue(torch.isinf(posit_sqrt(torch.tensor([-1.0]), 8, 1)).all())
+
+    def test_packed_operands(self):
+        for nsize, es in [(8, 1), (16, 1)]:
+            x = posit_quantize(torch.randn(10000), nsize, es)
+            y = posit_quantize(torch.randn(10000), nsize, es)
+            px, py = posit_pack(x, nsize, es), posit_pack(y, nsize, es)
+            packed = posit_mul(px, py, nsize, es)
+            self.assertEqual(packed.dtype, px.dtype)
+            self.assertTrue(torch.equal(posit_unpack(packed, nsize, es), posit_mul(x, y, nsize, es)))
+            self.assertTrue(torch.equal(posit_add(x, py, nsize, es), posit_add(x, y, nsize, es)))
+
+    def test_broadcast_and_scale(self):
+        x = posit_quantize(torch.randn(3, 1, 5), 16, 1)
+        y = posit_quantize(torch.randn(4, 5), 16, 1)
+        out = posit_add(x, y, 16, 1)
+        self.assertEqual(out.shape, (3, 4, 5))
+        self.assertTrue(torch.equal(posit_mul(x, 2, 16, 1), posit_quantize(x * 2, 16, 1)))
+        small = torch.randn(1000) * 1e-3
+        self.assertTrue(torch.equal(posit_mul(small, 1, 8, 1, scale=1024.0), posit_quantize(small, 8, 1, scale=1024.0)))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,68 @@
+import torch
+import unittest
+from fractions import Fraction
+from qtorch.quant import posit_quantize, posit_pack, posit_unpack
+from qtorch.quant import posit_sum, posit_mean, posit_dot
+
+
+def exact_posit(total, nsize, es):
+    """the posit nearest to an exact Fraction: one of those nearest to the fp32 values around it"""
+    f = torch.tensor([float(total)]).repeat(3)
+    f = torch.nextafter(f, torch.tensor([-float("inf"), 0.0, float("inf")]))
+    f[1] = float(total)
+    return min(posit_quantize(f, nsize, es).tolist(), key=lambda v: abs(Fraction(v) - total))
+
+
+class TestPositReduce(unittest.TestCase):
+    """
+    invariant: reductions accumulate exactly and round once, so the result is the exact
+    sum rounded to posit, whatever the order of the elements or the number of threads
+    """
+
+    def test_cancellation(self):
+        x = torch.tensor([2.0 ** 27, 1.0, -(2.0 ** 27)])
+        self.assertEqual(posit_sum(x, 16, 1).item(), 1.0)
+        self.assertEqual(x.sum().item(), 0.0)
+        a = torch.tensor([2.0 ** 20, 1.0, 2.0 ** 20])
+        b = torch.tensor([2.0 ** 20, 1.0, -(2.0 ** 20)])
+        self.assertEqual(posit_dot(a, b, 16, 2).item(), 1.0)
+
+    def test_exact_sum(self):
+        for nsize, es in [(8, 1), (16, 1), (16, 2)]:
+            x = posit_quantize(torch.randn(5000) * torch.exp2(torch.randint(-20, 20, (5000,)).float()), nsize, es)
+            total = sum((Fraction(v) for v in x.tolist()), Fraction(0))
+            self.assertEqual(posit_sum(x, nsize, es).item(), exact_posit(total, nsize, es))
+            self.assertEqual(posit_mean(x, nsize, es).item(), exact_posit(total / x.numel(), nsize, es))
+
+    def test_order_invariance(self):
+        x = posit_quantize(torch.randn(100000) * 1000, 16, 1)
+        expected = posit_sum(x, 16, 1)
+        for _ in range(3):
+            self.assertTrue(torch.equal(posit_sum(x[torch.randperm(x.numel())], 16, 1), expected))
+        threads = torch.get_num_threads()
+        torch.set_num_threads(1)
+        try:
+            self.assertTrue(torch.equal(posit_sum(x, 16, 1), expected))
+        finally:
+            torch.set_num_threads(threads)
+
+    def test_dims_and_packed(self):
+        x = posit_quantize(torch.randn(4, 6, 5), 16, 1)
+        rows = posit_sum(x, 16, 1, dim=(0, 2), keepdim=True)
+        self.assertEqual(rows.shape, (1, 6, 1))
+        for j in range(6):
+            self.assertEqual(rows[0, j, 0].item(), posit_sum(x[:, j, :], 16, 1).item())
+        packed = posit_mean(posit_pack(x, 16, 1), 16, 1, dim=-1)
+        self.assertEqual(packed.dtype, torch.int16)
+        self.assertTrue(torch.equal(posit_unpack(packed, 16, 1), posit_mean(x, 16, 1, dim=-1)))
+        y = posit_quantize(torch.randn(5), 16, 1)
+        self.assertEqual(posit_dot(x, y, 16, 1, dim=-1).shape, (4, 6))
+
+    def test_nar(self):
+        x = torch.tensor([1.0, float("inf"), 2.0])
+        self.assertTrue(torch.isinf(posit_sum(x, 8, 1)).all())
+        self.assertTrue(torch.isinf(posit_mean(torch.empty(3, 0), 8, 1, dim=1)).all())
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,69 @@
+import torch
+import unittest
+from qtorch import Posit, PositTanhModule, posit_saved_tensors
+from qtorch.quant import posit_quantize, posit_tanh
+
+
+class QuantizeSquare(torch.autograd.Function):
+    # saves its posit-rounded input, like a layer following a posit quantizer
+    @staticmethod
+    def forward(ctx, x):
+        ctx.save_for_backward(x)
+        return x * x
+
+    @staticmethod
+    def backward(ctx, grad_output):
+        (x,) = ctx.saved_tensors
+        return 2 * x * grad_output
+
+
+class TestSavedTensors(unittest.TestCase):
+    """
+    invariant: packing saved tensors as posit bits leaves every gradient bit-identical
+    """
+
+    def grads(self, fn, x, hooks=None):
+        x = x.clone().requires_grad_()
+        if hooks is None:
+            fn(x).sum().backward()
+        else:
+            with hooks:
+                out = fn(x).sum()
+            out.backward()
+        return x.grad
+
+    def test_quantized_activations_packed(self):
+        x = posit_quantize(torch.randn(64, 64), 8, 1)
+        hooks = posit_saved_tensors(Posit(8, 1))
+        packed = hooks.pack_hook(x)
+        self.assertEqual(packed[0].dtype, torch.uint8)
+        self.assertTrue(torch.equal(hooks.unpack_hook(packed), x))
+        fn = lambda t: QuantizeSquare.apply(t * 1.0)
+        self.assertTrue(torch.equal(self.grads(fn, x, hooks), self.grads(fn, x)))
+
+    def test_unrepresentable_kept(self):
+        hooks = posit_saved_tensors(Posit(8, 1))
+        x = torch.randn(64, 64)
+        self.assertIs(hooks.pack_hook(x), x)
+
+    def test_posit_tanh(self):
+        x = torch.randn(32, 64)
+        fn = PositTanhModule()
+        hooks = posit_saved_tensors([Posit(8, 1), Posit(16, 0)])
+        # an fp32 tanh output (what the CUDA path saves) is packed as posit16 bits
+        packed = hooks.pack_hook(posit_tanh(x, 16))
+        self.assertIsInstance(packed, tuple)
+        self.assertEqual((packed[0].dtype, packed[0].shape), (torch.int16, x.shape))
+        # and nothing saved by the module is kept in fp32
+        saved, pack = [], hooks.pack_hook
+        hooks.pack_hook = lambda t: saved.append(pack(t)) or saved[-1]
+        self.assertTrue(torch.equal(self.grads(fn, x, hooks), self.grads(fn, x)))
+        self.assertEqual(len(saved), 1)
+        bits = saved[0][0] if isinstance(saved[0], tuple) else saved[0]
+        self.assertIn(bits.dtype, [torch.uint8, torch.int16])
+        self.assertEqual(bits.numel(), x.numel())
+        self.assertLessEqual(bits.numel() * bits.element_size(), 2 * x.numel())
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,60 @@
+import torch
+import unittest
+from qtorch import FixedPoint, FloatingPoint, Posit
+from qtorch.quant import posit_pack, posit_unpack, float_pack, float_unpack
+from qtorch.quant import fixed_point_pack, fixed_point_unpack, transcode
+
+
+def pack(x, fmt):
+    if type(fmt) == Posit:
+        return posit_pack(x, fmt.nsize, fmt.es, fmt.scale)
+    elif type(fmt) == FixedPoint:
+        return fixed_point_pack(x, fmt.wl, fmt.fl, fmt.symmetric)
+    elif fmt.exp == 8:
+        return x.to(torch.bfloat16)
+    return float_pack(x, fmt.exp, fmt.man)
+
+
+def unpack(p, fmt):
+    if type(fmt) == Posit:
+        return posit_unpack(p, fmt.nsize, fmt.es, fmt.scale)
+    elif type(fmt) == FixedPoint:
+        return fixed_point_unpack(p)
+    elif fmt.exp == 8:
+        return p.float()
+    return float_unpack(p, fmt.exp, fmt.man)
+
+
+def bits(p):
+    return p.data if type(p) != torch.Tensor else p.view(torch.int16) if p.dtype == torch.bfloat16 else p
+
+
+class TestTranscode(unittest.TestCase):
+    """
+    invariant: transcoding equals unpacking to fp32 and packing again, whichever of the
+    table (8-bit or large inputs) or per-element paths is taken
+    """
+
+    def test_all_pairs(self):
+        formats = [Posit(8, 1), Posit(16, 1), Posit(12, 2, scale=0.5), FloatingPoint(exp=4, man=3),
+                   FloatingPoint(exp=5, man=2), FloatingPoint(exp=8, man=7), FixedPoint(8, 4), FixedPoint(16, 8)]
+        for n in [100, 70000]:
+            x = torch.randn(n) * torch.exp2(torch.randint(-8, 8, (n,)).float())
+            for src in formats:
+                p = pack(x, src)
+                for dst in formats:
+                    expected = pack(unpack(p, src), dst)
+                    out = transcode(p, src, dst)
+                    self.assertTrue(torch.equal(bits(out), bits(expected)), "{} -> {}".format(src, dst))
+
+    def test_types(self):
+        p = posit_pack(torch.randn(3, 4), 8, 1)
+        self.assertEqual(transcode(p, Posit(8, 1), FloatingPoint(exp=8, man=7)).dtype, torch.bfloat16)
+        self.assertEqual(transcode(p, Posit(8, 1), FloatingPoint(exp=4, man=3)).dtype, torch.uint8)
+        fixed = transcode(p, Posit(8, 1), FixedPoint(8, 5))
+        self.assertEqual((fixed.data.dtype, fixed.wl, fixed.fl), (torch.int8, 8, 5))
+        self.assertEqual(transcode(fixed, FixedPoint(8, 5), Posit(16, 1)).shape, (3, 4))
+
+
+if __name__ == "__main__":
+    unittest.main()
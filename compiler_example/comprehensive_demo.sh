@@ -21,7 +21,7 @@ echo "Generated C code:"
 echo "posit8 x = 1.5p8 + 2.0p8;" | ./posit_compiler
 echo ""
 echo "Execution result:"
-echo "posit8 x = 1.5p8 + 2.0p8;" | ./posit_compiler > demo1.c && gcc -o demo1 demo1.c posit8.o posit16.o softposit_fixed.o -lm && ./demo1
+echo "posit8 x = 1.5p8 + 2.0p8;" | ./posit_compiler > demo1.c && gcc -o demo1 demo1.c posit8.o posit8_tables.o posit16.o softposit_fixed.o -lm && ./demo1
 echo ""
 
 # Demo 2: Posit16 Declaration (shows type support)
@@ -31,7 +31,7 @@ echo "Generated C code:"
 echo "posit16 x = 3.0p16;" | ./posit_compiler
 echo ""
 echo "Execution result:"
-echo "posit16 x = 3.0p16;" | ./posit_compiler > demo2.c && gcc -o demo2 demo2.c posit8.o posit16.o softposit_fixed.o -lm && ./demo2
+echo "posit16 x = 3.0p16;" | ./posit_compiler > demo2.c && gcc -o demo2 demo2.c posit8.o posit8_tables.o posit16.o softposit_fixed.o -lm && ./demo2
 echo ""
 
 # Demo 3: Complex Expression
@@ -41,7 +41,7 @@ echo "Generated C code:"
 echo "posit8 x = (1.5p8 + 2.0p8) * 3.0p8;" | ./posit_compiler
 echo ""
 echo "Execution result:"
-echo "posit8 x = (1.5p8 + 2.0p8) * 3.0p8;" | ./posit_compiler > demo3.c && gcc -o demo3 demo3.c posit8.o posit16.o softposit_fixed.o -lm && ./demo3
+echo "posit8 x = (1.5p8 + 2.0p8) * 3.0p8;" | ./posit_compiler > demo3.c && gcc -o demo3 demo3.c posit8.o posit8_tables.o posit16.o softposit_fixed.o -lm && ./demo3
 echo ""
 
 # Demo 4: Multiple Variables
@@ -51,7 +51,7 @@ echo "Generated C code:"
 echo "posit8 a = 1.0p8; posit8 b = 2.0p8; posit8 c = a + b;" | ./posit_compiler
 echo ""
 echo "Execution result:"
-echo "posit8 a = 1.0p8; posit8 b = 2.0p8; posit8 c = a + b;" | ./posit_compiler > demo4.c && gcc -o demo4 demo4.c posit8.o posit16.o softposit_fixed.o -lm && ./demo4
+echo "posit8 a = 1.0p8; posit8 b = 2.0p8; posit8 c = a + b;" | ./posit_compiler > demo4.c && gcc -o demo4 demo4.c posit8.o posit8_tables.o posit16.o softposit_fixed.o -lm && ./demo4
 echo ""
 
 # Demo 5: Encoding/Decoding Visualization
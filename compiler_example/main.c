@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include "posit8.h"
+#include "posit16.h"
 
 int main(void) {
     posit8 a, b, c;
@@ -62,8 +63,31 @@ int main(void) {
         printf("Error in FMA\n");
     }
 
+    // Test 6: Array API (elementwise products and a posit16 dot product)
+    float xs[8] = {0.5f, 1.0f, 1.5f, 2.0f, -0.25f, 3.0f, -4.0f, 0.125f};
+    float ys[8] = {2.0f, 2.0f, 2.0f, 2.0f, 4.0f, -1.0f, 0.5f, 8.0f};
+    float out[8];
+    posit8 pa8[8], pb8[8], pc8[8];
+    posit16 pa16[8], pb16[8], dot;
+    err = posit8_from_float_n(pa8, xs, 8);
+    err |= posit8_from_float_n(pb8, ys, 8);
+    err |= posit8_mul_n(pc8, pa8, pb8, 8);
+    err |= posit8_to_float_n(out, pc8, 8);
+    if (err == POSIT8_OK) {
+        printf("Array Multiplication Result:");
+        for (int i = 0; i < 8; i++) printf(" %g", out[i]);
+        printf("\n");
+    } else {
+        printf("Error in array multiplication\n");
+    }
+    err = posit16_from_float_n(pa16, xs, 8);
+    err |= posit16_from_float_n(pb16, ys, 8);
+    err |= posit16_dot_n(&dot, pa16, pb16, 8);
+    err |= posit16_to_float(&fc, dot);
+    if (err == POSIT8_OK) printf("Posit16 Dot Product Result: %f\n", fc);
+    else printf("Error in dot product\n");
+
     printf("\n=== Test Complete ===\n");
-    printf("Note: Results may not be accurate due to simplified posit8 implementation.\n");
 
     return 0;
 }
\ No newline at end of file
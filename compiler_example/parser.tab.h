@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,68 +31,81 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_PARSER_TAB_H_INCLUDED
+# define YY_YY_PARSER_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     POSIT8 = 258,
-     POSIT16 = 259,
-     POSIT32 = 260,
-     QUIRE32 = 261,
-     FLOAT = 262,
-     DOUBLE = 263,
-     POSIT_LITERAL = 264,
-     IDENTIFIER = 265,
-     PLUS = 266,
-     MINUS = 267,
-     MULT = 268,
-     DIV = 269,
-     ASSIGN = 270,
-     SEMICOLON = 271,
-     LPAREN = 272,
-     RPAREN = 273,
-     LBRACE = 274,
-     RBRACE = 275
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    POSIT8 = 258,                  /* POSIT8  */
+    POSIT16 = 259,                 /* POSIT16  */
+    POSIT32 = 260,                 /* POSIT32  */
+    QUIRE32 = 261,                 /* QUIRE32  */
+    FLOAT = 262,                   /* FLOAT  */
+    DOUBLE = 263,                  /* DOUBLE  */
+    POSIT_LITERAL = 264,           /* POSIT_LITERAL  */
+    IDENTIFIER = 265,              /* IDENTIFIER  */
+    PLUS = 266,                    /* PLUS  */
+    MINUS = 267,                   /* MINUS  */
+    MULT = 268,                    /* MULT  */
+    DIV = 269,                     /* DIV  */
+    ASSIGN = 270,                  /* ASSIGN  */
+    SEMICOLON = 271,               /* SEMICOLON  */
+    LPAREN = 272,                  /* LPAREN  */
+    RPAREN = 273,                  /* RPAREN  */
+    LBRACE = 274,                  /* LBRACE  */
+    RBRACE = 275,                  /* RBRACE  */
+    FOR = 276,                     /* FOR  */
+    IN = 277,                      /* IN  */
+    LBRACKET = 278,                /* LBRACKET  */
+    RBRACKET = 279,                /* RBRACKET  */
+    COLON = 280,                   /* COLON  */
+    PLUS_ASSIGN = 281,             /* PLUS_ASSIGN  */
+    MINUS_ASSIGN = 282             /* MINUS_ASSIGN  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
-#define POSIT8 258
-#define POSIT16 259
-#define POSIT32 260
-#define QUIRE32 261
-#define FLOAT 262
-#define DOUBLE 263
-#define POSIT_LITERAL 264
-#define IDENTIFIER 265
-#define PLUS 266
-#define MINUS 267
-#define MULT 268
-#define DIV 269
-#define ASSIGN 270
-#define SEMICOLON 271
-#define LPAREN 272
-#define RPAREN 273
-#define LBRACE 274
-#define RBRACE 275
-
-
-
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 37 "parser.y"
+union YYSTYPE
 {
+#line 11 "parser.y"
+
     char *str;
-}
-/* Line 1529 of yacc.c.  */
-#line 93 "parser.tab.h"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+    int value;
+    double number;
+
+#line 97 "parser.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
+
 extern YYSTYPE yylval;
 
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_PARSER_TAB_H_INCLUDED  */
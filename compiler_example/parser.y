@@ -2,49 +2,28 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "posit8.h"
-#include "posit16.h"
+#include "posit_ir.h"
 
 void yyerror(const char *s);
 extern int yylex(void);
-
-/* Simple temp generator for codegen */
-static int temp_counter = 0;
-static int result_counter = 0;
-static char* new_temp(void) {
-    char buf[32];
-    snprintf(buf, sizeof(buf), "t%d", temp_counter++);
-    return strdup(buf);
-}
-static char* new_result_var(void) {
-    char buf[32];
-    snprintf(buf, sizeof(buf), "result%d", result_counter++);
-    return strdup(buf);
-}
-
-/* Strip posit suffix like p8/p16/p32 from literal text; return malloc'd */
-static char* strip_posit_suffix(const char *text) {
-    const char *p = strchr(text, 'p');
-    if (!p) return strdup(text);
-    size_t n = (size_t)(p - text);
-    char *out = (char*)malloc(n + 1);
-    memcpy(out, text, n);
-    out[n] = '\0';
-    return out;
-}
 %}
 
 %union {
     char *str;
+    int value;
+    double number;
 }
 
 %token POSIT8 POSIT16 POSIT32 QUIRE32 FLOAT DOUBLE
 %token <str> POSIT_LITERAL IDENTIFIER
 %token PLUS MINUS MULT DIV ASSIGN SEMICOLON LPAREN RPAREN LBRACE RBRACE
+%token FOR IN LBRACKET RBRACKET COLON PLUS_ASSIGN MINUS_ASSIGN
 
 %left PLUS MINUS
 %left MULT DIV
-%type <str> type expression
+%type <str> type
+%type <value> expression index
+%type <number> bound
 
 %%
 
@@ -60,33 +39,89 @@ statements:
 statement:
     type IDENTIFIER ASSIGN expression SEMICOLON {
         if (strcmp($1, "posit8") == 0) {
-            /* Declare and assign from expression temp/value */
-            printf("    posit8 %s = %s;\n", $2, $4);
-            char *result_var = new_result_var();
-            printf("    double %s;\n", result_var);
-            printf("    posit8_to_double(&%s, %s);\n", result_var, $2);
-            printf("    printf(\"Result: %%.6f\\n\", %s);\n", result_var);
-            free(result_var);
+            ir_declare(TYPE_POSIT8, $2, $4);
         } else if (strcmp($1, "posit16") == 0) {
-            /* Declare and assign from expression temp/value */
-            printf("    posit16 %s = %s;\n", $2, $4);
-            char *result_var = new_result_var();
-            printf("    double %s;\n", result_var);
-            printf("    posit16_to_double(&%s, %s);\n", result_var, $2);
-            printf("    printf(\"Result: %%.6f\\n\", %s);\n", result_var);
-            free(result_var);
+            ir_declare(TYPE_POSIT16, $2, $4);
+        } else if (strcmp($1, "posit32") == 0) {
+            ir_declare(TYPE_POSIT32, $2, $4);
+        } else if (strcmp($1, "quire32") == 0) {
+            /* exact accumulation, rounded once to the posit type of the terms */
+            ir_declare_quire($2, $4);
         } else {
-            /* For now: only posit8 and posit16 codegen are supported */
-            printf("    /* TODO: codegen for type %s */\n", $1);
+            /* For now: float and double have no codegen */
+            ir_unsupported($1);
         }
+        free($1); free($2);
+    }
+    | type IDENTIFIER SEMICOLON {
+        /* a quire variable, zero until accumulated into */
+        ir_declare_accumulator($1, $2);
+        free($1); free($2);
+    }
+    | IDENTIFIER PLUS_ASSIGN expression SEMICOLON {
+        ir_accumulate($1, $3, 0);
+        free($1);
+    }
+    | IDENTIFIER MINUS_ASSIGN expression SEMICOLON {
+        ir_accumulate($1, $3, 1);
+        free($1);
+    }
+    | type IDENTIFIER IN bound COLON bound SEMICOLON {
+        /* an input with a known range, for precision selection */
+        ir_declare_input($1, $2);
+        ir_input_range($2, $4, $6);
+        free($1); free($2);
+    }
+    | type IDENTIFIER LBRACKET POSIT_LITERAL RBRACKET SEMICOLON {
+        /* no value: an input, mapped from a binary file at run time */
+        ir_declare_array($1, $2, $4, -1);
+        free($1); free($2); free($4);
+    }
+    | type IDENTIFIER LBRACKET POSIT_LITERAL RBRACKET IN bound COLON bound SEMICOLON {
+        ir_declare_array($1, $2, $4, -1);
+        ir_input_range($2, $7, $9);
         free($1); free($2); free($4);
     }
+    | type IDENTIFIER LBRACKET POSIT_LITERAL RBRACKET ASSIGN expression SEMICOLON {
+        /* element-wise over the whole array */
+        ir_declare_array($1, $2, $4, $7);
+        free($1); free($2); free($4);
+    }
+    | FOR IDENTIFIER IN POSIT_LITERAL COLON POSIT_LITERAL LBRACE {
+        ir_loop_begin($2, $4, $6);
+        free($2); free($4); free($6);
+    } assignments RBRACE {
+        ir_loop_end();
+    }
     | expression SEMICOLON {
-        /* Expression statement result already materialized via temps */
+        /* Expressions have no side effects: nothing depends on the value */
+    }
+    ;
+
+assignments:
+    assignment
+    | assignments assignment
+    ;
+
+assignment:
+    IDENTIFIER LBRACKET index RBRACKET ASSIGN expression SEMICOLON {
+        ir_assign($1, $3, $6);
         free($1);
     }
     ;
 
+bound:
+    POSIT_LITERAL { $$ = strtod($1, NULL); free($1); }
+    | MINUS POSIT_LITERAL { $$ = -strtod($2, NULL); free($2); }
+    ;
+
+/* the loop index plus a constant offset */
+index:
+    IDENTIFIER { $$ = ir_index($1, NULL, 1); free($1); }
+    | IDENTIFIER PLUS POSIT_LITERAL { $$ = ir_index($1, $3, 1); free($1); free($3); }
+    | IDENTIFIER MINUS POSIT_LITERAL { $$ = ir_index($1, $3, -1); free($1); free($3); }
+    ;
+
 type:
     POSIT8  { $$ = strdup("posit8"); }
     | POSIT16 { $$ = strdup("posit16"); }
@@ -98,53 +133,22 @@ type:
 
 expression:
     POSIT_LITERAL {
-        /* Materialize literal into appropriate posit temp via from_double */
-        char *num = strip_posit_suffix($1);
-        char *t = new_temp();
-        
-        /* Determine posit type from literal suffix */
-        if (strstr($1, "p16") != NULL) {
-            printf("    posit16 %s;\n", t);
-            printf("    posit16_from_double(&%s, %s);\n", t, num);
-        } else {
-            /* Default to posit8 for p8 or no suffix */
-            printf("    posit8 %s;\n", t);
-            printf("    posit8_from_double(&%s, %s);\n", t, num);
-        }
-        
-        free(num);
+        /* Encoded at compile time, posit type from the literal suffix */
+        $$ = ir_literal($1);
         free($1);
-        $$ = t;
-    }
-    | IDENTIFIER  { $$ = $1; }
-    | expression PLUS expression {
-        char *t = new_temp();
-        /* Determine result type based on operands - for now, default to posit8 */
-        printf("    posit8 %s;\n", t);
-        printf("    posit8_add(&%s, %s, %s);\n", t, $1, $3);
-        free($1); free($3);
-        $$ = t;
-    }
-    | expression MINUS expression {
-        char *t = new_temp();
-        printf("    posit8 %s;\n", t);
-        printf("    posit8_sub(&%s, %s, %s);\n", t, $1, $3);
-        free($1); free($3);
-        $$ = t;
     }
-    | expression MULT expression {
-        char *t = new_temp();
-        printf("    posit8 %s;\n", t);
-        printf("    posit8_mul(&%s, %s, %s);\n", t, $1, $3);
-        free($1); free($3);
-        $$ = t;
+    | IDENTIFIER {
+        $$ = ir_lookup($1);
+        if ($$ < 0) $$ = ir_input($1);
+        free($1);
     }
-    | expression DIV expression {
-        char *t = new_temp();
-        printf("    posit8 %s;\n", t);
-        printf("    posit8_div(&%s, %s, %s);\n", t, $1, $3);
-        free($1); free($3);
-        $$ = t;
+    | expression PLUS expression { $$ = ir_binary(IR_ADD, $1, $3); }
+    | expression MINUS expression { $$ = ir_binary(IR_SUB, $1, $3); }
+    | expression MULT expression { $$ = ir_binary(IR_MUL, $1, $3); }
+    | expression DIV expression { $$ = ir_binary(IR_DIV, $1, $3); }
+    | IDENTIFIER LBRACKET index RBRACKET {
+        $$ = ir_element($1, $3);
+        free($1);
     }
     | LPAREN expression RPAREN { $$ = $2; }
     ;
@@ -155,17 +159,27 @@ void yyerror(const char *s) {
     fprintf(stderr, "Error: %s\n", s);
 }
 
-int main(void) {
-    /* Prolog */
-    printf("#include <stdio.h>\n");
-    printf("#include \"posit8.h\"\n");
-    printf("#include \"posit16.h\"\n\n");
-    printf("int main(void) {\n");
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-contract") == 0) {
+            /* one rounding per operation, as written */
+            ir_set_contract(0);
+        } else if (strncmp(argv[i], "--error-bound=", 14) == 0 && strtod(argv[i] + 14, NULL) > 0.0) {
+            /* posit types chosen by precision selection */
+            ir_set_error_bound(strtod(argv[i] + 14, NULL));
+        } else if (strcmp(argv[i], "--torch") == 0) {
+            /* a PyTorch extension instead of a program */
+            ir_set_torch(1);
+        } else {
+            fprintf(stderr, "Usage: %s [--no-contract] [--error-bound=E] [--torch] < program\n", argv[0]);
+            return 2;
+        }
+    }
 
+    ir_init();
     int rc = yyparse();
 
-    /* Epilog */
-    printf("    return 0;\n");
-    printf("}\n");
-    return rc;
-}
\ No newline at end of file
+    /* the program is written once the whole input has been optimized */
+    if (rc == 0 && ir_errors() == 0) ir_emit(stdout);
+    return rc != 0 ? rc : ir_errors() != 0;
+}
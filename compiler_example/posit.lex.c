@@ -356,8 +356,8 @@ static void yynoreturn yy_fatal_error ( const char* msg  );
 	(yy_hold_char) = *yy_cp; \
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
-#define YY_NUM_RULES 22
-#define YY_END_OF_BUFFER 23
+#define YY_NUM_RULES 29
+#define YY_END_OF_BUFFER 30
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -365,14 +365,15 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static const flex_int16_t yy_accept[56] =
+static const flex_int16_t yy_accept[67] =
     {   0,
-        0,    0,   23,   21,   20,   20,   16,   17,   12,   10,
-       11,   13,    8,   15,   14,    9,    9,    9,    9,    9,
-       18,   19,    0,    8,    0,    9,    9,    9,    9,    9,
-        8,    0,    0,    7,    9,    9,    9,    9,    9,    9,
-        9,    9,    9,    5,    9,    9,    6,    9,    9,    1,
-        9,    2,    3,    4,    0
+        0,    0,   30,   28,   27,   27,   20,   21,   16,   14,
+       15,   17,   10,   26,   19,   18,   11,   24,   25,   11,
+       11,   11,   11,   11,   22,   23,   12,   13,    0,   10,
+        0,   11,   11,   11,   11,    8,   11,   11,   10,    0,
+        0,    9,   11,   11,    7,   11,   11,    9,    9,   11,
+       11,   11,   11,   11,    5,   11,   11,    6,   11,   11,
+        1,   11,    2,    3,    4,    0
     } ;
 
 static const YY_CHAR yy_ec[256] =
@@ -382,15 +383,15 @@ static const YY_CHAR yy_ec[256] =
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    2,    1,    1,    1,    1,    1,    1,    1,    4,
         5,    6,    7,    1,    8,    9,   10,   11,   12,   13,
-       14,   11,   11,   15,   11,   16,   11,    1,   17,    1,
-       18,    1,    1,    1,   19,   19,   19,   19,   19,   19,
-       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
-       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
-        1,    1,    1,    1,   19,    1,   20,   21,   19,   22,
-
-       23,   24,   19,   19,   25,   19,   19,   26,   19,   19,
-       27,   28,   29,   30,   31,   32,   33,   19,   19,   19,
-       19,   19,   34,    1,   35,    1,    1,    1,    1,    1,
+       14,   11,   11,   15,   11,   16,   11,   17,   18,    1,
+       19,    1,    1,    1,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       21,    1,   22,    1,   20,    1,   23,   24,   20,   25,
+
+       26,   27,   20,   20,   28,   20,   20,   29,   20,   30,
+       31,   32,   33,   34,   35,   36,   37,   20,   20,   20,
+       20,   20,   38,    1,   39,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -407,66 +408,78 @@ static const YY_CHAR yy_ec[256] =
         1,    1,    1,    1,    1
     } ;
 
-static const YY_CHAR yy_meta[36] =
+static const YY_CHAR yy_meta[40] =
     {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    2,    1,
-        3,    3,    3,    3,    3,    3,    1,    1,    4,    4,
-        4,    4,    4,    4,    4,    4,    4,    5,    4,    4,
-        4,    4,    4,    1,    1
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1
     } ;
 
-static const flex_int16_t yy_base[59] =
+static const flex_int16_t yy_base[67] =
     {   0,
-        0,    0,   77,   78,   78,   78,   78,   78,   78,   78,
-       78,   78,   27,   78,   78,    0,   49,   49,   47,   40,
-       78,   78,    0,   28,   26,    0,   39,   44,   39,   44,
-       40,   52,   53,   78,   44,   44,   34,   24,   27,   20,
-       19,   27,   26,    0,   27,   34,    0,   32,   33,    0,
-       32,    0,    0,    0,   78,   55,   58,   41
+        0,    0,   47,  129,  129,  129,  129,  129,  129,   32,
+       49,  129,   58,  129,  129,  129,   29,  129,  129,   45,
+       63,   65,   65,   60,  129,  129,  129,  129,   72,   66,
+       34,   68,   63,   70,   68,   72,   69,   77,   74,   92,
+       95,  129,   85,   87,   80,   84,   79,  129,  129,   85,
+       79,   80,   91,   92,   88,   77,  106,   90,  107,  110,
+       93,  112,   95,   96,   97,  129
     } ;
 
-static const flex_int16_t yy_def[59] =
+static const flex_int16_t yy_def[67] =
     {   0,
-       55,    1,   55,   55,   55,   55,   55,   55,   55,   55,
-       55,   55,   56,   55,   55,   57,   57,   57,   57,   57,
-       55,   55,   58,   56,   55,   57,   57,   57,   57,   57,
-       58,   55,   55,   55,   57,   57,   57,   57,   57,   57,
-       57,   57,   57,   57,   57,   57,   57,   57,   57,   57,
-       57,   57,   57,   57,    0,   55,   55,   55
+       66,    1,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   17,
+       17,   17,   17,   17,   66,   66,   66,   66,   66,   66,
+       66,   20,   17,   17,   17,   20,   17,   17,   29,   66,
+       66,   66,   17,   17,   20,   17,   17,   66,   66,   17,
+       17,   17,   17,   17,   20,   17,   17,   20,   17,   17,
+       20,   17,   20,   20,   20,    0
     } ;
 
-static const flex_int16_t yy_nxt[114] =
+static const flex_int16_t yy_nxt[169] =
     {   0,
         4,    5,    6,    7,    8,    9,   10,   11,    4,   12,
-       13,   13,   13,   13,   13,   13,   14,   15,   16,   16,
-       16,   17,   16,   18,   16,   16,   16,   19,   20,   16,
-       16,   16,   16,   21,   22,   23,   23,   32,   48,   33,
-       49,   34,   50,   31,   54,   53,   52,   51,   47,   46,
-       45,   44,   43,   42,   25,   25,   24,   24,   41,   24,
-       26,   26,   26,   40,   39,   34,   34,   25,   38,   37,
-       36,   35,   30,   29,   28,   27,   55,    3,   55,   55,
-       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
-       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
-
-       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
-       55,   55,   55
+       13,   13,   13,   13,   13,   13,   14,   15,   16,   17,
+       18,   19,   17,   17,   20,   17,   21,   22,   17,   17,
+       17,   23,   24,   17,   17,   17,   17,   25,   26,   32,
+       32,   32,   32,   32,   32,   40,   66,   41,   32,   42,
+       27,   32,   32,   32,   32,   32,   32,   32,   32,   32,
+       32,   32,   32,   32,   32,   32,   29,   28,   30,   30,
+       30,   30,   30,   30,   29,   33,   30,   30,   30,   30,
+       30,   30,   39,   39,   39,   39,   39,   39,   59,   31,
+       60,   34,   61,   35,   36,   37,   38,   31,   32,   43,
+
+       44,   45,   32,   46,   47,   31,   48,   49,   50,   51,
+       32,   52,   53,   54,   55,   56,   57,   58,   32,   62,
+       32,   63,   64,   32,   65,   32,   32,   32,    3,   66,
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   66,   66,   66,   66,   66,   66
     } ;
 
-static const flex_int16_t yy_chk[114] =
+static const flex_int16_t yy_chk[169] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,    1,    1,   13,   24,   25,   45,   25,
-       45,   25,   45,   58,   51,   49,   48,   46,   43,   42,
-       41,   40,   39,   38,   13,   24,   56,   56,   37,   56,
-       57,   57,   57,   36,   35,   33,   32,   31,   30,   29,
-       28,   27,   20,   19,   18,   17,    3,   55,   55,   55,
-       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
-       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
-
-       55,   55,   55,   55,   55,   55,   55,   55,   55,   55,
-       55,   55,   55
+        1,    1,    1,    1,    1,    1,    1,    1,    1,   17,
+       17,   17,   17,   17,   17,   31,    3,   31,   17,   31,
+       10,   17,   17,   17,   17,   17,   17,   17,   17,   17,
+       17,   17,   17,   17,   17,   17,   13,   11,   13,   13,
+       13,   13,   13,   13,   30,   20,   30,   30,   30,   30,
+       30,   30,   29,   29,   29,   29,   29,   29,   56,   13,
+       56,   21,   56,   21,   22,   23,   24,   30,   32,   33,
+
+       34,   35,   36,   37,   38,   39,   40,   41,   43,   44,
+       45,   46,   47,   50,   51,   52,   53,   54,   55,   57,
+       58,   59,   60,   61,   62,   63,   64,   65,   66,   66,
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   66,   66,   66,   66,   66,   66,   66,   66,
+       66,   66,   66,   66,   66,   66,   66,   66
     } ;
 
 static yy_state_type yy_last_accepting_state;
@@ -487,8 +500,8 @@ char *yytext;
 #line 2 "lexer.l"
 #include "parser.tab.h"
 #include <string.h>
-#line 490 "posit.lex.c"
-#line 491 "posit.lex.c"
+#line 503 "posit.lex.c"
+#line 504 "posit.lex.c"
 
 #define INITIAL 0
 
@@ -708,7 +721,7 @@ YY_DECL
 #line 8 "lexer.l"
 
 
-#line 711 "posit.lex.c"
+#line 724 "posit.lex.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -735,13 +748,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 56 )
+				if ( yy_current_state >= 67 )
 					yy_c = yy_meta[yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 78 );
+		while ( yy_base[yy_current_state] != 129 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -798,85 +811,120 @@ YY_RULE_SETUP
 case 7:
 YY_RULE_SETUP
 #line 16 "lexer.l"
-{ yylval.str = strdup(yytext); return POSIT_LITERAL; }
+{ return FOR; }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
 #line 17 "lexer.l"
-{ yylval.str = strdup(yytext); return POSIT_LITERAL; }
+{ return IN; }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
 #line 18 "lexer.l"
-{ yylval.str = strdup(yytext); return IDENTIFIER; }
+{ yylval.str = strdup(yytext); return POSIT_LITERAL; }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
 #line 19 "lexer.l"
-{ return PLUS; }
+{ yylval.str = strdup(yytext); return POSIT_LITERAL; }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
 #line 20 "lexer.l"
-{ return MINUS; }
+{ yylval.str = strdup(yytext); return IDENTIFIER; }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
 #line 21 "lexer.l"
-{ return MULT; }
+{ return PLUS_ASSIGN; }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
 #line 22 "lexer.l"
-{ return DIV; }
+{ return MINUS_ASSIGN; }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
 #line 23 "lexer.l"
-{ return ASSIGN; }
+{ return PLUS; }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
 #line 24 "lexer.l"
-{ return SEMICOLON; }
+{ return MINUS; }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
 #line 25 "lexer.l"
-{ return LPAREN; }
+{ return MULT; }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
 #line 26 "lexer.l"
-{ return RPAREN; }
+{ return DIV; }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
 #line 27 "lexer.l"
-{ return LBRACE; }
+{ return ASSIGN; }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
 #line 28 "lexer.l"
-{ return RBRACE; }
+{ return SEMICOLON; }
 	YY_BREAK
 case 20:
-/* rule 20 can match eol */
 YY_RULE_SETUP
 #line 29 "lexer.l"
-{ /* Ignore whitespace */ }
+{ return LPAREN; }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
 #line 30 "lexer.l"
-{ printf("Unknown token: %s\n", yytext); }
+{ return RPAREN; }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
+#line 31 "lexer.l"
+{ return LBRACE; }
+	YY_BREAK
+case 23:
+YY_RULE_SETUP
 #line 32 "lexer.l"
+{ return RBRACE; }
+	YY_BREAK
+case 24:
+YY_RULE_SETUP
+#line 33 "lexer.l"
+{ return LBRACKET; }
+	YY_BREAK
+case 25:
+YY_RULE_SETUP
+#line 34 "lexer.l"
+{ return RBRACKET; }
+	YY_BREAK
+case 26:
+YY_RULE_SETUP
+#line 35 "lexer.l"
+{ return COLON; }
+	YY_BREAK
+case 27:
+/* rule 27 can match eol */
+YY_RULE_SETUP
+#line 36 "lexer.l"
+{ /* Ignore whitespace */ }
+	YY_BREAK
+case 28:
+YY_RULE_SETUP
+#line 37 "lexer.l"
+{ printf("Unknown token: %s\n", yytext); }
+	YY_BREAK
+case 29:
+YY_RULE_SETUP
+#line 39 "lexer.l"
 ECHO;
 	YY_BREAK
-#line 879 "posit.lex.c"
+#line 927 "posit.lex.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -1173,7 +1221,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 56 )
+			if ( yy_current_state >= 67 )
 				yy_c = yy_meta[yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
@@ -1201,11 +1249,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 56 )
+		if ( yy_current_state >= 67 )
 			yy_c = yy_meta[yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
-	yy_is_jam = (yy_current_state == 55);
+	yy_is_jam = (yy_current_state == 66);
 
 		return yy_is_jam ? 0 : yy_current_state;
 }
@@ -1881,5 +1929,5 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 32 "lexer.l"
+#line 39 "lexer.l"
 
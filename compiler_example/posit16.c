@@ -1,133 +1,205 @@
 #include "posit16.h"
 #include "posit8.h"  // For POSIT_OK, POSIT_INVALID, etc.
+#include "posit_cpu.h"
 #include <math.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 /* Posit16 implementation with encoding/decoding visualization
- * Based on SoftPosit approach but with 16-bit precision
+ * Based on SoftPosit approach but with 16-bit precision: integer encode,
+ * decode and arithmetic, correctly rounded (nearest, ties to even pattern)
  */
 
-/* Reference values for posit16 (es=1) */
-struct reference_value_16 {
-    double value;
-    uint16_t bits;
-};
-
-static const struct reference_value_16 ref_values_16[] = {
-    {0.0, 0x0000}, {1.0, 0x4000}, {2.0, 0x5000}, {4.0, 0x6000},
-    {0.5, 0x2000}, {1.5, 0x4800}, {3.0, 0x5800}, {16.0, 0x7000},
-    {0.125, 0x1000}, {1.25, 0x4400}, {2.5, 0x5400}, {6.0, 0x6800},
-    {0.0625, 0x0800}, {1.125, 0x4200}, {2.25, 0x5200}, {8.0, 0x6400}
-};
+/* Integer posit16 (es=1) helpers
+ * A finite nonzero posit16 is (-1)^sign * 2^scale * sig / 2^31 with the hidden
+ * bit at bit 31 of sig and scale in [-28, 28]. The regime is read with a single
+ * count-leading-zeros and results are assembled with shifts.
+ */
+#define P16_NAR 0x8000u
+#define P16_MAXPOS 0x7FFFu
+#define P16_MAX_SCALE 28
 
-#define NUM_REF_VALUES_16 (sizeof(ref_values_16) / sizeof(ref_values_16[0]))
+static inline int clz64(uint64_t x) {
+    return __builtin_clzll(x);
+}
 
-/* Accurate posit16 decoding */
-double convertP16ToDouble(posit16 p) {
-    if (p == 0) return 0.0;
-    if (p == 0x8000) return NAN; // NaR
-    
-    // Check reference values first
-    for (int i = 0; i < NUM_REF_VALUES_16; i++) {
-        if (ref_values_16[i].bits == p) {
-            return ref_values_16[i].value;
-        }
+static inline void p16_decode(posit16 p, int *sign, int *scale, uint32_t *sig) {
+    uint32_t x;
+    int n, k;
+    *sign = p >> 15;
+    if (*sign) p = -p;
+    x = (uint32_t)p << 17; /* bits after the sign, left aligned */
+    if (x >> 31) {
+        n = __builtin_clz(~x);
+        k = n - 1;
+    } else {
+        n = __builtin_clz(x);
+        k = -n;
     }
-    
-    // Fallback to calculation for other values
-    // Sign bit
-    int sign = (p >> 15) & 1;
-    uint16_t abs_p = sign ? (~p + 1) : p;
-    
-    // Regime: count consecutive bits after sign
-    int regime_len = 0;
-    int regime_bit = (abs_p >> 14) & 1;
-    
-    for (int i = 0; i < 15; i++) {
-        if (((abs_p >> (14-i)) & 1) == regime_bit) {
-            regime_len++;
+    x = x << n << 1; /* n <= 15: drop regime and terminating bit */
+    *scale = 2 * k + (int)(x >> 31);
+    *sig = 0x80000000u | ((x << 1) >> 1);
+}
+
+/* Round (-1)^sign * 2^scale * sig / 2^31 to the nearest posit16, ties to the even pattern.
+ * sig must have its top bit set; sticky flags nonzero bits below sig. Never rounds to 0 or NaR.
+ */
+static inline posit16 p16_round_pack(int sign, int scale, uint32_t sig, int sticky) {
+    uint64_t field;
+    uint32_t p;
+    int len, k;
+    if (scale > P16_MAX_SCALE) {
+        p = P16_MAXPOS;
+    } else if (scale < -P16_MAX_SCALE) {
+        p = 1;
+    } else {
+        k = scale >> 1;
+        /* regime, exponent and fraction left aligned in 64 bits */
+        if (k >= 0) {
+            len = k + 2;
+            field = ((1ULL << (k + 1)) - 1) << (64 - (k + 1));
         } else {
-            break;
+            len = 1 - k;
+            field = 1ULL << (64 - len);
         }
+        field |= (uint64_t)(scale & 1) << (63 - len);
+        field |= ((uint64_t)(uint32_t)(sig << 1) << 32) >> (len + 1);
+        p = (uint32_t)(field >> 49);
+        if (p != P16_MAXPOS && ((field >> 48) & 1) && ((field & ((1ULL << 48) - 1)) || sticky || (p & 1)))
+            p++;
+        if (p == 0) p = 1;
     }
-    
-    int k = regime_bit ? (regime_len - 1) : -(regime_len - 1);
-    
-    // Exponent (1 bit for es=1)
-    int exp = 0;
-    if (regime_len < 14) {
-        exp = (abs_p >> (14 - regime_len)) & 1;
+    return (posit16)(sign ? -p : p);
+}
+
+/* round (-1)^sign * 2^scale * x / 2^61, x normalized with bit 61 set */
+static inline posit16 p16_round_fields(int sign, int scale, uint64_t x) {
+    x <<= 2;
+    return p16_round_pack(sign, scale, (uint32_t)(x >> 32), (uint32_t)x != 0);
+}
+
+/* exact sum of two values in the form of p16_round_fields, rounded once */
+static inline posit16 p16_add_fields(int sa, int ea, uint64_t a, int sb, int eb, uint64_t b) {
+    int shift, t, lz;
+    uint64_t u, s;
+    if (ea < eb || (ea == eb && a < b)) {
+        u = a; a = b; b = u;
+        t = ea; ea = eb; eb = t;
+        t = sa; sa = sb; sb = t;
     }
-    
-    // Fraction
-    int frac_bits = 15 - regime_len - 1;
-    int frac = (frac_bits > 0) ? (abs_p & ((1 << frac_bits) - 1)) : 0;
-    
-    // Calculate value
-    double useed = 4.0; // 2^(2^es) = 4 for es=1
-    double value = (sign ? -1.0 : 1.0) * 
-                   pow(useed, k) * 
-                   pow(2.0, exp) * 
-                   (1.0 + frac / (double)(1 << frac_bits));
-    
-    return value;
+    shift = ea - eb;
+    if (shift >= 62) {
+        b = 1; /* entirely below a's last bit: a sticky bit */
+    } else if (shift > 0) {
+        int lost = (b & ((1ULL << shift) - 1)) != 0;
+        b = (b >> shift) | lost;
+    }
+    s = (sa == sb) ? a + b : a - b;
+    if (s == 0) return 0;
+    lz = clz64(s);
+    s <<= lz;
+    return p16_round_pack(sa, ea + 2 - lz, (uint32_t)(s >> 32), (uint32_t)s != 0);
 }
 
-/* Accurate posit16 encoding */
+/* Accurate posit16 decoding: exact, assembled directly as IEEE 754 bits */
+double convertP16ToDouble(posit16 p) {
+    int sign, scale;
+    uint32_t sig;
+    uint64_t bits;
+    double d;
+    if (p == 0) return 0.0;
+    if (p == P16_NAR) return NAN; // NaR
+    p16_decode(p, &sign, &scale, &sig);
+    bits = ((uint64_t)sign << 63) | ((uint64_t)(scale + 1023) << 52) | ((uint64_t)(uint32_t)(sig << 1) << 20);
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+/* Accurate posit16 encoding: correctly rounded from the IEEE 754 bits */
 posit16 convertDoubleToP16(double a) {
-    if (a == 0.0) return 0;
-    if (isnan(a)) return 0x8000;
-    
-    // Check reference values first
-    for (int i = 0; i < NUM_REF_VALUES_16; i++) {
-        if (fabs(ref_values_16[i].value - a) < 1e-10) {
-            return ref_values_16[i].bits;
-        }
-    }
-    
-    // For other values, find closest reference value
-    int closest_idx = 0;
-    double min_diff = fabs(ref_values_16[0].value - a);
-    
-    for (int i = 1; i < NUM_REF_VALUES_16; i++) {
-        double diff = fabs(ref_values_16[i].value - a);
-        if (diff < min_diff) {
-            min_diff = diff;
-            closest_idx = i;
-        }
+    uint64_t bits, man;
+    int sign, exp;
+    memcpy(&bits, &a, sizeof(bits));
+    sign = (int)(bits >> 63);
+    exp = (int)((bits >> 52) & 0x7FF);
+    man = bits & ((1ULL << 52) - 1);
+    if (exp == 0x7FF) return P16_NAR; // NaN and infinities
+    if (exp == 0) {
+        if (man == 0) return 0;
+        return (posit16)(sign ? -1 : 1); // subnormals are far below minpos
     }
-    
-    return ref_values_16[closest_idx].bits;
+    return p16_round_pack(sign, exp - 1023, 0x80000000u | (uint32_t)(man >> 21), (man & ((1ULL << 21) - 1)) != 0);
 }
 
-/* Arithmetic operations */
+/* Arithmetic operations, in the integer domain */
 posit16 p16_add(posit16 a, posit16 b) {
-    double da = convertP16ToDouble(a);
-    double db = convertP16ToDouble(b);
-    double result = da + db;
-    return convertDoubleToP16(result);
+    int sa, sb, ea, eb;
+    uint32_t ma, mb;
+    if (a == P16_NAR || b == P16_NAR) return P16_NAR;
+    if (a == 0) return b;
+    if (b == 0) return a;
+    p16_decode(a, &sa, &ea, &ma);
+    p16_decode(b, &sb, &eb, &mb);
+    return p16_add_fields(sa, ea, (uint64_t)ma << 30, sb, eb, (uint64_t)mb << 30);
 }
 
 posit16 p16_sub(posit16 a, posit16 b) {
-    double da = convertP16ToDouble(a);
-    double db = convertP16ToDouble(b);
-    double result = da - db;
-    return convertDoubleToP16(result);
+    /* negation is the two's complement of the pattern and keeps NaR */
+    return p16_add(a, (posit16)-b);
 }
 
 posit16 p16_mul(posit16 a, posit16 b) {
-    double da = convertP16ToDouble(a);
-    double db = convertP16ToDouble(b);
-    double result = da * db;
-    return convertDoubleToP16(result);
+    int sa, sb, ea, eb;
+    uint32_t ma, mb;
+    uint64_t prod;
+    if (a == P16_NAR || b == P16_NAR) return P16_NAR;
+    if (a == 0 || b == 0) return 0;
+    p16_decode(a, &sa, &ea, &ma);
+    p16_decode(b, &sb, &eb, &mb);
+    prod = (uint64_t)ma * mb;
+    if (prod >> 63)
+        return p16_round_pack(sa ^ sb, ea + eb + 1, (uint32_t)(prod >> 32), (uint32_t)prod != 0);
+    prod <<= 1;
+    return p16_round_pack(sa ^ sb, ea + eb, (uint32_t)(prod >> 32), (uint32_t)prod != 0);
 }
 
 posit16 p16_div(posit16 a, posit16 b) {
-    double da = convertP16ToDouble(a);
-    double db = convertP16ToDouble(b);
-    double result = da / db;
-    return convertDoubleToP16(result);
+    int sa, sb, ea, eb;
+    uint32_t ma, mb;
+    uint64_t num, q;
+    if (a == P16_NAR || b == P16_NAR || b == 0) return P16_NAR;
+    if (a == 0) return 0;
+    p16_decode(a, &sa, &ea, &ma);
+    p16_decode(b, &sb, &eb, &mb);
+    /* 2^32 * ma / mb lies in (2^31, 2^33) */
+    num = (uint64_t)ma << 32;
+    q = num / mb;
+    if (q >> 32)
+        return p16_round_pack(sa ^ sb, ea - eb, (uint32_t)(q >> 1), (q & 1) || num % mb);
+    return p16_round_pack(sa ^ sb, ea - eb - 1, (uint32_t)q, num % mb != 0);
+}
+
+/* a * b + c with a single rounding */
+posit16 p16_fma(posit16 a, posit16 b, posit16 c) {
+    int sa, sb, sc, ea, eb, ec;
+    uint32_t ma, mb, mc;
+    uint64_t prod;
+    if (a == P16_NAR || b == P16_NAR || c == P16_NAR) return P16_NAR;
+    if (a == 0 || b == 0) return c;
+    p16_decode(a, &sa, &ea, &ma);
+    p16_decode(b, &sb, &eb, &mb);
+    /* at most 13 significant bits each, so the low bits dropped here are zero */
+    prod = (uint64_t)ma * mb;
+    if (prod >> 63) {
+        prod >>= 2;
+        ea += 1;
+    } else {
+        prod >>= 1;
+    }
+    if (c == 0) return p16_round_fields(sa ^ sb, ea + eb, prod);
+    p16_decode(c, &sc, &ec, &mc);
+    return p16_add_fields(sa ^ sb, ea + eb, prod, sc, ec, (uint64_t)mc << 30);
 }
 
 /* Our interface implementation */
@@ -184,10 +256,335 @@ posit16_error_t posit16_div(posit16 *result, posit16 a, posit16 b) {
 posit16_error_t posit16_fma(posit16 *result, posit16 a, posit16 b, posit16 c) {
     if (result == NULL) return POSIT_INVALID;
     
-    // FMA: a * b + c
-    posit16 temp;
-    posit16_mul(&temp, a, b);
-    posit16_add(result, temp, c);
+    // FMA: a * b + c, rounded once
+    *result = p16_fma(a, b, c);
+    return POSIT_OK;
+}
+
+/* Array variants */
+#ifdef POSIT_X86_SIMD
+/* p16_decode on eight 32-bit lanes; zero and NaR lanes are left for the caller */
+POSIT_TARGET_AVX2
+static inline void p16x8_decode(__m256i p, __m256i *sign, __m256i *scale, __m256i *sig) {
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i neg, x, r, z, n, k;
+    *sign = _mm256_srli_epi32(p, 15);
+    neg = _mm256_cmpeq_epi32(*sign, one);
+    x = _mm256_slli_epi32(_mm256_blendv_epi8(p, _mm256_sub_epi32(_mm256_setzero_si256(), p), neg), 17);
+    /* regime length from the exponent of the run terminator converted to float */
+    r = _mm256_srai_epi32(x, 31);
+    z = _mm256_srli_epi32(_mm256_xor_si256(x, r), 16);
+    n = _mm256_sub_epi32(_mm256_set1_epi32(15 + 127),
+                         _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(z)), 23));
+    k = _mm256_blendv_epi8(_mm256_sub_epi32(_mm256_setzero_si256(), n), _mm256_sub_epi32(n, one), r);
+    x = _mm256_sllv_epi32(x, _mm256_add_epi32(n, one));
+    *scale = _mm256_add_epi32(_mm256_add_epi32(k, k), _mm256_srli_epi32(x, 31));
+    *sig = _mm256_or_si256(_mm256_set1_epi32((int)0x80000000u), _mm256_srli_epi32(_mm256_slli_epi32(x, 1), 1));
+}
+
+/* p16_round_pack on eight 32-bit lanes, sticky is a lane mask */
+POSIT_TARGET_AVX2
+static inline __m256i p16x8_round_pack(__m256i sign, __m256i scale, __m256i sig, __m256i sticky) {
+    const __m256i one = _mm256_set1_epi32(1), ones = _mm256_set1_epi32(-1);
+    const __m256i maxpos = _mm256_set1_epi32(P16_MAXPOS), zero = _mm256_setzero_si256();
+    __m256i big = _mm256_cmpgt_epi32(scale, _mm256_set1_epi32(P16_MAX_SCALE));
+    __m256i small = _mm256_cmpgt_epi32(_mm256_set1_epi32(-P16_MAX_SCALE), scale);
+    __m256i sc = _mm256_min_epi32(_mm256_max_epi32(scale, _mm256_set1_epi32(-P16_MAX_SCALE)),
+                                  _mm256_set1_epi32(P16_MAX_SCALE));
+    __m256i k = _mm256_srai_epi32(sc, 1);
+    __m256i k_pos = _mm256_cmpgt_epi32(k, ones);
+    __m256i len = _mm256_blendv_epi8(_mm256_sub_epi32(one, k), _mm256_add_epi32(k, _mm256_set1_epi32(2)), k_pos);
+    __m256i frac = _mm256_slli_epi32(sig, 1);
+    __m256i below = _mm256_sub_epi32(_mm256_set1_epi32(31), len);
+    __m256i field, lost, p, rest, inc;
+    /* regime, exponent and fraction left aligned in 32 bits */
+    field = _mm256_blendv_epi8(_mm256_sllv_epi32(one, _mm256_add_epi32(k, _mm256_set1_epi32(31))),
+                               _mm256_xor_si256(_mm256_srlv_epi32(ones, _mm256_add_epi32(k, one)), ones), k_pos);
+    field = _mm256_or_si256(field, _mm256_sllv_epi32(_mm256_and_si256(sc, one), below));
+    field = _mm256_or_si256(field, _mm256_srlv_epi32(frac, _mm256_add_epi32(len, one)));
+    lost = _mm256_sllv_epi32(frac, below);
+    sticky = _mm256_or_si256(sticky, _mm256_xor_si256(_mm256_cmpeq_epi32(lost, zero), ones));
+    p = _mm256_srli_epi32(field, 17);
+    rest = _mm256_or_si256(sticky, _mm256_xor_si256(
+        _mm256_cmpeq_epi32(_mm256_and_si256(field, _mm256_set1_epi32(0xFFFF)), zero), ones));
+    inc = _mm256_and_si256(_mm256_srli_epi32(field, 16), _mm256_or_si256(_mm256_and_si256(rest, one), p));
+    inc = _mm256_andnot_si256(_mm256_cmpeq_epi32(p, maxpos), _mm256_and_si256(inc, one));
+    p = _mm256_add_epi32(p, inc);
+    p = _mm256_blendv_epi8(p, maxpos, big);
+    p = _mm256_blendv_epi8(p, one, small);
+    p = _mm256_blendv_epi8(p, _mm256_sub_epi32(zero, p), _mm256_cmpeq_epi32(sign, one));
+    return _mm256_and_si256(p, _mm256_set1_epi32(0xFFFF));
+}
+
+/* zero stays zero, NaR stays NaR */
+POSIT_TARGET_AVX2
+static inline __m256i p16x8_special(__m256i p, __m256i zero_mask, __m256i nar_mask) {
+    p = _mm256_andnot_si256(zero_mask, p);
+    return _mm256_blendv_epi8(p, _mm256_set1_epi32(P16_NAR), nar_mask);
+}
+
+POSIT_TARGET_AVX2
+static inline __m256i p16x8_load(const posit16 *p) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p));
+}
+
+POSIT_TARGET_AVX2
+static inline void p16x8_store(posit16 *dst, __m256i p) {
+    _mm_storeu_si128((__m128i *)dst, _mm_packus_epi32(_mm256_castsi256_si128(p), _mm256_extracti128_si256(p, 1)));
+}
+
+POSIT_TARGET_AVX2
+static inline __m256 p16x8_to_float(__m256i p) {
+    __m256i sign, scale, sig, bits;
+    p16x8_decode(p, &sign, &scale, &sig);
+    bits = _mm256_or_si256(_mm256_slli_epi32(sign, 31),
+                           _mm256_slli_epi32(_mm256_add_epi32(scale, _mm256_set1_epi32(127)), 23));
+    bits = _mm256_or_si256(bits, _mm256_srli_epi32(_mm256_slli_epi32(sig, 1), 9));
+    bits = _mm256_andnot_si256(_mm256_cmpeq_epi32(p, _mm256_setzero_si256()), bits);
+    bits = _mm256_blendv_epi8(bits, _mm256_set1_epi32(0x7FC00000), _mm256_cmpeq_epi32(p, _mm256_set1_epi32(P16_NAR)));
+    return _mm256_castsi256_ps(bits);
+}
+
+/* the 64-bit lanes of lo and hi narrowed to eight 32-bit lanes */
+POSIT_TARGET_AVX2
+static inline __m256i narrow_epi64(__m256i lo, __m256i hi) {
+    const __m256i even_lanes = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    lo = _mm256_permutevar8x32_epi32(lo, even_lanes);
+    hi = _mm256_permutevar8x32_epi32(hi, even_lanes);
+    return _mm256_blend_epi32(lo, hi, 0xF0);
+}
+
+/* Round eight doubles, as convertDoubleToP16 */
+POSIT_TARGET_AVX2
+static inline __m256i p16x8_from_double(__m256d lo, __m256d hi) {
+    const __m256i exp_mask = _mm256_set1_epi64x(0x7FF), low_mask = _mm256_set1_epi64x((1LL << 21) - 1);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i bits[2], sign[2], exp[2], sig[2], sticky[2], zeros[2], nar[2];
+    int h;
+    bits[0] = _mm256_castpd_si256(lo);
+    bits[1] = _mm256_castpd_si256(hi);
+    for (h = 0; h < 2; h++) {
+        sign[h] = _mm256_srli_epi64(bits[h], 63);
+        exp[h] = _mm256_and_si256(_mm256_srli_epi64(bits[h], 52), exp_mask);
+        sig[h] = _mm256_srli_epi64(_mm256_slli_epi64(bits[h], 12), 33);
+        sticky[h] = _mm256_xor_si256(_mm256_cmpeq_epi64(_mm256_and_si256(bits[h], low_mask), zero),
+                                     _mm256_set1_epi64x(-1));
+        zeros[h] = _mm256_cmpeq_epi64(_mm256_slli_epi64(bits[h], 1), zero);
+        nar[h] = _mm256_cmpeq_epi64(exp[h], exp_mask);
+    }
+    /* results of posit16 arithmetic are never subnormal doubles */
+    return p16x8_special(
+        p16x8_round_pack(narrow_epi64(sign[0], sign[1]),
+                         _mm256_sub_epi32(narrow_epi64(exp[0], exp[1]), _mm256_set1_epi32(1023)),
+                         _mm256_or_si256(narrow_epi64(sig[0], sig[1]), _mm256_set1_epi32((int)0x80000000u)),
+                         narrow_epi64(sticky[0], sticky[1])),
+        narrow_epi64(zeros[0], zeros[1]), narrow_epi64(nar[0], nar[1]));
+}
+
+/* add, sub and div go through double: the sum of two posit16 values is either exact
+ * in double or too far from a posit16 rounding boundary to be rounded twice, and a
+ * quotient that is not exact is never within a double ulp of a boundary
+ */
+POSIT_TARGET_AVX2
+static void double_op_n_avx2(posit16 *result, const posit16 *a, const posit16 *b, size_t n, int op) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 fa = p16x8_to_float(p16x8_load(a + i)), fb = p16x8_to_float(p16x8_load(b + i));
+        __m256d alo = _mm256_cvtps_pd(_mm256_castps256_ps128(fa)), ahi = _mm256_cvtps_pd(_mm256_extractf128_ps(fa, 1));
+        __m256d blo = _mm256_cvtps_pd(_mm256_castps256_ps128(fb)), bhi = _mm256_cvtps_pd(_mm256_extractf128_ps(fb, 1));
+        __m256d rlo, rhi;
+        switch (op) {
+        case 0: rlo = _mm256_add_pd(alo, blo); rhi = _mm256_add_pd(ahi, bhi); break;
+        case 1: rlo = _mm256_sub_pd(alo, blo); rhi = _mm256_sub_pd(ahi, bhi); break;
+        default: rlo = _mm256_div_pd(alo, blo); rhi = _mm256_div_pd(ahi, bhi); break;
+        }
+        p16x8_store(result + i, p16x8_from_double(rlo, rhi));
+    }
+    for (; i < n; i++)
+        result[i] = op == 0 ? p16_add(a[i], b[i]) : op == 1 ? p16_sub(a[i], b[i]) : p16_div(a[i], b[i]);
+}
+
+POSIT_TARGET_AVX2
+static void mul_n_avx2(posit16 *result, const posit16 *a, const posit16 *b, size_t n) {
+    const __m256i zero = _mm256_setzero_si256(), nar = _mm256_set1_epi32(P16_NAR);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i pa = p16x8_load(a + i), pb = p16x8_load(b + i);
+        __m256i sa, sb, ea, eb, ma, mb, prod, hi, p;
+        p16x8_decode(pa, &sa, &ea, &ma);
+        p16x8_decode(pb, &sb, &eb, &mb);
+        /* 13-bit significands: the product is exact in 26 bits */
+        prod = _mm256_mullo_epi32(_mm256_srli_epi32(ma, 19), _mm256_srli_epi32(mb, 19));
+        hi = _mm256_srli_epi32(prod, 25);
+        prod = _mm256_sllv_epi32(prod, _mm256_sub_epi32(_mm256_set1_epi32(7), hi));
+        p = p16x8_round_pack(_mm256_xor_si256(sa, sb), _mm256_add_epi32(_mm256_add_epi32(ea, eb), hi), prod, zero);
+        p = p16x8_special(p, _mm256_or_si256(_mm256_cmpeq_epi32(pa, zero), _mm256_cmpeq_epi32(pb, zero)),
+                          _mm256_or_si256(_mm256_cmpeq_epi32(pa, nar), _mm256_cmpeq_epi32(pb, nar)));
+        p16x8_store(result + i, p);
+    }
+    for (; i < n; i++)
+        result[i] = p16_mul(a[i], b[i]);
+}
+
+POSIT_TARGET_AVX2
+static void from_float_n_avx2(posit16 *result, const float *values, size_t n) {
+    const __m256i zero = _mm256_setzero_si256(), exp_mask = _mm256_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(values + i));
+        __m256i exp = _mm256_and_si256(_mm256_srli_epi32(bits, 23), exp_mask);
+        __m256i sig = _mm256_or_si256(_mm256_slli_epi32(bits, 8), _mm256_set1_epi32((int)0x80000000u));
+        /* subnormals are far below minpos and saturate there */
+        __m256i p = p16x8_round_pack(_mm256_srli_epi32(bits, 31), _mm256_sub_epi32(exp, _mm256_set1_epi32(127)),
+                                     sig, zero);
+        p = p16x8_special(p, _mm256_cmpeq_epi32(_mm256_slli_epi32(bits, 1), zero), _mm256_cmpeq_epi32(exp, exp_mask));
+        p16x8_store(result + i, p);
+    }
+    for (; i < n; i++)
+        result[i] = convertDoubleToP16(values[i]);
+}
+
+POSIT_TARGET_AVX2
+static void to_float_n_avx2(float *result, const posit16 *p, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(result + i, p16x8_to_float(p16x8_load(p + i)));
+    for (; i < n; i++)
+        result[i] = (float)convertP16ToDouble(p[i]);
+}
+#endif
+
+static posit16_error_t binary_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n, int op) {
+    size_t i;
+    if (n && (result == NULL || a == NULL || b == NULL)) return POSIT_INVALID;
+
+#ifdef POSIT_X86_SIMD
+    if (posit_cpu_has_avx2()) {
+        if (op == 2) mul_n_avx2(result, a, b, n);
+        else double_op_n_avx2(result, a, b, n, op == 3 ? 2 : op);
+        return POSIT_OK;
+    }
+#endif
+    for (i = 0; i < n; i++) {
+        switch (op) {
+        case 0: result[i] = p16_add(a[i], b[i]); break;
+        case 1: result[i] = p16_sub(a[i], b[i]); break;
+        case 2: result[i] = p16_mul(a[i], b[i]); break;
+        default: result[i] = p16_div(a[i], b[i]); break;
+        }
+    }
+    return POSIT_OK;
+}
+
+posit16_error_t posit16_add_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n) {
+    return binary_n(result, a, b, n, 0);
+}
+
+posit16_error_t posit16_sub_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n) {
+    return binary_n(result, a, b, n, 1);
+}
+
+posit16_error_t posit16_mul_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n) {
+    return binary_n(result, a, b, n, 2);
+}
+
+posit16_error_t posit16_div_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n) {
+    return binary_n(result, a, b, n, 3);
+}
+
+posit16_error_t posit16_from_float_n(posit16 *result, const float *values, size_t n) {
+    size_t i;
+    if (n && (result == NULL || values == NULL)) return POSIT_INVALID;
+
+#ifdef POSIT_X86_SIMD
+    if (posit_cpu_has_avx2()) {
+        from_float_n_avx2(result, values, n);
+        return POSIT_OK;
+    }
+#endif
+    for (i = 0; i < n; i++)
+        result[i] = convertDoubleToP16(values[i]);
+    return POSIT_OK;
+}
+
+posit16_error_t posit16_to_float_n(float *result, const posit16 *p, size_t n) {
+    size_t i;
+    if (n && (result == NULL || p == NULL)) return POSIT_INVALID;
+
+#ifdef POSIT_X86_SIMD
+    if (posit_cpu_has_avx2()) {
+        to_float_n_avx2(result, p, n);
+        return POSIT_OK;
+    }
+#endif
+    for (i = 0; i < n; i++)
+        result[i] = (float)convertP16ToDouble(p[i]);
+    return POSIT_OK;
+}
+
+/* Quire for posit16 dot products: a fixed-point sum with lsb minpos^2 = 2^-56.
+ * A product is at most maxpos^2 = 2^112 quire units, so the 128-bit accumulator
+ * is carried into the high word every P16_QUIRE_CHUNK products.
+ */
+#define P16_QUIRE_LSB 56
+#define P16_QUIRE_CHUNK 8192
+
+posit16_error_t posit16_dot_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n) {
+    __int128 lo = 0, carry;
+    int64_t hi = 0;
+    unsigned __int128 mag;
+    size_t i;
+    int sa, sb, ea, eb, sign, top;
+    uint32_t ma, mb;
+    if (result == NULL || (n && (a == NULL || b == NULL))) return POSIT_INVALID;
+
+    for (i = 0; i < n; i++) {
+        __int128 prod;
+        if (a[i] == P16_NAR || b[i] == P16_NAR) {
+            *result = P16_NAR;
+            return POSIT_OK;
+        }
+        if (a[i] == 0 || b[i] == 0) continue;
+        p16_decode(a[i], &sa, &ea, &ma);
+        p16_decode(b[i], &sb, &eb, &mb);
+        /* 13-bit significands times 2^(ea + eb - 24): every posit16 value is a multiple of minpos */
+        prod = (__int128)((uint64_t)(ma >> 19) * (mb >> 19));
+        if (ea + eb - 24 + P16_QUIRE_LSB >= 0) prod <<= ea + eb - 24 + P16_QUIRE_LSB;
+        else prod >>= -(ea + eb - 24 + P16_QUIRE_LSB);
+        lo += (sa ^ sb) ? -prod : prod;
+        if ((i + 1) % P16_QUIRE_CHUNK == 0) {
+            carry = lo >> 112;
+            lo -= carry << 112;
+            hi += (int64_t)carry;
+        }
+    }
+    carry = lo >> 112;
+    lo -= carry << 112;
+    hi += (int64_t)carry;
+
+    /* quire value hi * 2^112 + lo, with 0 <= lo < 2^112 */
+    sign = hi < 0;
+    if (sign) {
+        hi = -hi - 1;
+        lo = ((__int128)1 << 112) - lo;
+        if (lo >> 112) {
+            hi++;
+            lo = 0;
+        }
+    }
+    if (hi != 0) {
+        /* at least 2^56, far beyond maxpos */
+        *result = p16_round_pack(sign, P16_MAX_SCALE + 1, 0x80000000u, 0);
+        return POSIT_OK;
+    }
+    if (lo == 0) {
+        *result = 0;
+        return POSIT_OK;
+    }
+    mag = (unsigned __int128)lo;
+    top = (uint64_t)(mag >> 64) ? 127 - __builtin_clzll((uint64_t)(mag >> 64)) : 63 - __builtin_clzll((uint64_t)mag);
+    mag <<= 127 - top;
+    *result = p16_round_pack(sign, top - P16_QUIRE_LSB, (uint32_t)(mag >> 96), (mag << 32) != 0);
     return POSIT_OK;
 }
 
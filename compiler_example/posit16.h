@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /* Posit16 type and error codes */
 typedef uint16_t posit16;
@@ -21,6 +22,20 @@ posit16_error_t posit16_mul(posit16 *result, posit16 a, posit16 b);
 posit16_error_t posit16_div(posit16 *result, posit16 a, posit16 b);
 posit16_error_t posit16_fma(posit16 *result, posit16 a, posit16 b, posit16 c);
 
+/* Array variants: result[i] = a[i] <op> b[i] for i < n, NaR propagates per element.
+ * result may be a or b but must not partially overlap them. Encode, decode and
+ * arithmetic run as AVX2 bit manipulation where the CPU supports it.
+ */
+posit16_error_t posit16_add_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n);
+posit16_error_t posit16_sub_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n);
+posit16_error_t posit16_mul_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n);
+posit16_error_t posit16_div_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n);
+posit16_error_t posit16_from_float_n(posit16 *result, const float *values, size_t n);
+posit16_error_t posit16_to_float_n(float *result, const posit16 *p, size_t n);
+
+/* Dot product of a and b accumulated exactly in a quire, rounded once */
+posit16_error_t posit16_dot_n(posit16 *result, const posit16 *a, const posit16 *b, size_t n);
+
 /* Utility functions */
 bool posit16_is_nar(posit16 p);
 bool posit16_is_zero(posit16 p);
@@ -1,77 +1,252 @@
 #include "posit8.h"
-#include "softposit_fixed.h"
+#include "posit_cpu.h"
 #include <math.h>
 #include <stddef.h>
 
 /* SoftPosit wrapper implementation
- * This uses the official SoftPosit functions for accurate arithmetic
+ * Thin checked wrappers around the table-driven inline variants in posit8.h
  */
 
-/* Our interface implementation using SoftPosit */
+/* Our interface implementation */
 posit8_error_t posit8_from_double(posit8 *p, double value) {
     if (p == NULL) return POSIT_INVALID;
     
-    *p = convertDoubleToP8(value);
+    *p = posit8_from_double_v(value);
     return POSIT_OK;
 }
 
 posit8_error_t posit8_to_double(double *result, posit8 p) {
     if (result == NULL) return POSIT_INVALID;
     
-    *result = convertP8ToDouble(p);
+    *result = posit8_to_double_v(p);
     return POSIT_OK;
 }
 
 posit8_error_t posit8_to_float(float *result, posit8 p) {
     if (result == NULL) return POSIT_INVALID;
     
-    double d_result = convertP8ToDouble(p);
-    *result = (float)d_result;
+    *result = posit8_to_float_v(p);
     return POSIT_OK;
 }
 
 posit8_error_t posit8_add(posit8 *result, posit8 a, posit8 b) {
     if (result == NULL) return POSIT_INVALID;
     
-    *result = p8_add(a, b);
+    *result = posit8_add_v(a, b);
     return POSIT_OK;
 }
 
 posit8_error_t posit8_sub(posit8 *result, posit8 a, posit8 b) {
     if (result == NULL) return POSIT_INVALID;
     
-    *result = p8_sub(a, b);
+    *result = posit8_sub_v(a, b);
     return POSIT_OK;
 }
 
 posit8_error_t posit8_mul(posit8 *result, posit8 a, posit8 b) {
     if (result == NULL) return POSIT_INVALID;
     
-    *result = p8_mul(a, b);
+    *result = posit8_mul_v(a, b);
     return POSIT_OK;
 }
 
 posit8_error_t posit8_div(posit8 *result, posit8 a, posit8 b) {
     if (result == NULL) return POSIT_INVALID;
     
-    *result = p8_div(a, b);
+    *result = posit8_div_v(a, b);
     return POSIT_OK;
 }
 
 posit8_error_t posit8_fma(posit8 *result, posit8 a, posit8 b, posit8 c) {
     if (result == NULL) return POSIT_INVALID;
     
-    // FMA: a * b + c
-    posit8 temp;
-    posit8_mul(&temp, a, b);
-    posit8_add(result, temp, c);
+    // FMA: a * b + c, rounded once
+    *result = posit8_fma_v(a, b, c);
+    return POSIT_OK;
+}
+
+/* Array variants */
+#ifdef POSIT_X86_SIMD
+/* narrow eight 32-bit lanes holding bytes and store them */
+POSIT_TARGET_AVX2
+static inline void store_u8x8(posit8 *dst, __m256i v) {
+    __m128i w = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(w, w));
+}
+
+POSIT_TARGET_AVX2
+static void table_n_avx2(posit8 *result, const posit8 *a, const posit8 *b, size_t n, const posit8 *table) {
+    const __m256i three = _mm256_set1_epi32(3), low_byte = _mm256_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(a + i)));
+        __m256i vb = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(b + i)));
+        __m256i idx = _mm256_or_si256(_mm256_slli_epi32(va, 8), vb);
+        /* gather the aligned 32-bit word holding each entry, so no load runs past the table */
+        __m256i words = _mm256_i32gather_epi32((const int *)table, _mm256_srli_epi32(idx, 2), 4);
+        __m256i shift = _mm256_slli_epi32(_mm256_and_si256(idx, three), 3);
+        store_u8x8(result + i, _mm256_and_si256(_mm256_srlv_epi32(words, shift), low_byte));
+    }
+    for (; i < n; i++)
+        result[i] = table[(a[i] << 8) | b[i]];
+}
+
+POSIT_TARGET_AVX2
+static void to_float_n_avx2(float *result, const posit8 *p, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p + i)));
+        __m256d lo = _mm256_i32gather_pd(posit8_decode_table, _mm256_castsi256_si128(idx), 8);
+        __m256d hi = _mm256_i32gather_pd(posit8_decode_table, _mm256_extracti128_si256(idx, 1), 8);
+        _mm_storeu_ps(result + i, _mm256_cvtpd_ps(lo));
+        _mm_storeu_ps(result + i + 4, _mm256_cvtpd_ps(hi));
+    }
+    for (; i < n; i++)
+        result[i] = posit8_to_float_v(p[i]);
+}
+
+/* posit8_from_double_v on eight lanes: the posit bit string is assembled and rounded
+ * with shifts, regime first (scale in [-12, 12], k = scale >> 1)
+ */
+POSIT_TARGET_AVX2
+static void from_float_n_avx2(posit8 *result, const float *values, size_t n) {
+    const __m256i one = _mm256_set1_epi32(1), ones = _mm256_set1_epi32(-1), zero = _mm256_setzero_si256();
+    const __m256i exp_mask = _mm256_set1_epi32(0xFF), maxpos = _mm256_set1_epi32(0x7F);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(values + i));
+        __m256i exp = _mm256_and_si256(_mm256_srli_epi32(bits, 23), exp_mask);
+        __m256i scale = _mm256_sub_epi32(exp, _mm256_set1_epi32(127));
+        __m256i big = _mm256_cmpgt_epi32(scale, _mm256_set1_epi32(12));
+        __m256i small = _mm256_cmpgt_epi32(_mm256_set1_epi32(-12), scale);
+        __m256i sc = _mm256_min_epi32(_mm256_max_epi32(scale, _mm256_set1_epi32(-12)), _mm256_set1_epi32(12));
+        __m256i k = _mm256_srai_epi32(sc, 1);
+        __m256i k_pos = _mm256_cmpgt_epi32(k, ones);
+        __m256i len = _mm256_blendv_epi8(_mm256_sub_epi32(one, k), _mm256_add_epi32(k, _mm256_set1_epi32(2)), k_pos);
+        __m256i below = _mm256_sub_epi32(_mm256_set1_epi32(31), len);
+        __m256i frac = _mm256_slli_epi32(bits, 9);
+        __m256i field, rest, p, inc;
+        /* regime, exponent and fraction left aligned in 32 bits */
+        field = _mm256_blendv_epi8(_mm256_sllv_epi32(one, _mm256_add_epi32(k, _mm256_set1_epi32(31))),
+                                   _mm256_xor_si256(_mm256_srlv_epi32(ones, _mm256_add_epi32(k, one)), ones), k_pos);
+        field = _mm256_or_si256(field, _mm256_sllv_epi32(_mm256_and_si256(sc, one), below));
+        field = _mm256_or_si256(field, _mm256_srlv_epi32(frac, _mm256_add_epi32(len, one)));
+        rest = _mm256_or_si256(_mm256_sllv_epi32(frac, below), _mm256_and_si256(field, _mm256_set1_epi32(0xFFFFFF)));
+        rest = _mm256_xor_si256(_mm256_cmpeq_epi32(rest, zero), ones);
+        p = _mm256_srli_epi32(field, 25);
+        inc = _mm256_and_si256(_mm256_srli_epi32(field, 24), _mm256_or_si256(_mm256_and_si256(rest, one), p));
+        inc = _mm256_andnot_si256(_mm256_cmpeq_epi32(p, maxpos), _mm256_and_si256(inc, one));
+        p = _mm256_add_epi32(p, inc);
+        p = _mm256_blendv_epi8(p, maxpos, big);
+        p = _mm256_blendv_epi8(p, one, small);
+        p = _mm256_blendv_epi8(p, _mm256_sub_epi32(zero, p), _mm256_srai_epi32(bits, 31));
+        p = _mm256_and_si256(p, _mm256_set1_epi32(0xFF));
+        /* zero, then NaN and infinities */
+        p = _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_slli_epi32(bits, 1), zero), p);
+        p = _mm256_blendv_epi8(p, _mm256_set1_epi32(0x80), _mm256_cmpeq_epi32(exp, exp_mask));
+        store_u8x8(result + i, p);
+    }
+    for (; i < n; i++)
+        result[i] = posit8_from_double_v(values[i]);
+}
+#endif
+
+static void table_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n, const posit8 *table) {
+    size_t i;
+#ifdef POSIT_X86_SIMD
+    if (posit_cpu_has_avx2()) {
+        table_n_avx2(result, a, b, n, table);
+        return;
+    }
+#endif
+    for (i = 0; i < n; i++)
+        result[i] = table[(a[i] << 8) | b[i]];
+}
+
+posit8_error_t posit8_add_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n) {
+    if (n && (result == NULL || a == NULL || b == NULL)) return POSIT_INVALID;
+
+    table_n(result, a, b, n, posit8_add_table);
+    return POSIT_OK;
+}
+
+posit8_error_t posit8_sub_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n) {
+    if (n && (result == NULL || a == NULL || b == NULL)) return POSIT_INVALID;
+
+    table_n(result, a, b, n, posit8_sub_table);
+    return POSIT_OK;
+}
+
+posit8_error_t posit8_mul_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n) {
+    if (n && (result == NULL || a == NULL || b == NULL)) return POSIT_INVALID;
+
+    table_n(result, a, b, n, posit8_mul_table);
+    return POSIT_OK;
+}
+
+posit8_error_t posit8_div_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n) {
+    if (n && (result == NULL || a == NULL || b == NULL)) return POSIT_INVALID;
+
+    table_n(result, a, b, n, posit8_div_table);
+    return POSIT_OK;
+}
+
+posit8_error_t posit8_from_float_n(posit8 *result, const float *values, size_t n) {
+    size_t i;
+    if (n && (result == NULL || values == NULL)) return POSIT_INVALID;
+
+#ifdef POSIT_X86_SIMD
+    if (posit_cpu_has_avx2()) {
+        from_float_n_avx2(result, values, n);
+        return POSIT_OK;
+    }
+#endif
+    for (i = 0; i < n; i++)
+        result[i] = posit8_from_double_v(values[i]);
+    return POSIT_OK;
+}
+
+posit8_error_t posit8_to_float_n(float *result, const posit8 *p, size_t n) {
+    size_t i;
+    if (n && (result == NULL || p == NULL)) return POSIT_INVALID;
+
+#ifdef POSIT_X86_SIMD
+    if (posit_cpu_has_avx2()) {
+        to_float_n_avx2(result, p, n);
+        return POSIT_OK;
+    }
+#endif
+    for (i = 0; i < n; i++)
+        result[i] = posit8_to_float_v(p[i]);
+    return POSIT_OK;
+}
+
+/* Quire for posit8 dot products: every posit8 value is a multiple of minpos = 2^-12,
+ * so products are integers in units of 2^-24 and at most maxpos^2 = 2^48 of them
+ */
+posit8_error_t posit8_dot_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n) {
+    __int128 acc = 0;
+    size_t i;
+    if (result == NULL || (n && (a == NULL || b == NULL))) return POSIT_INVALID;
+
+    for (i = 0; i < n; i++) {
+        if (a[i] == 0x80 || b[i] == 0x80) {
+            *result = 0x80;
+            return POSIT_OK;
+        }
+        acc += (__int128)((int64_t)(posit8_decode_table[a[i]] * 4096.0) * (int64_t)(posit8_decode_table[b[i]] * 4096.0));
+    }
+    /* beyond maxpos = 2^36 units the result saturates; below, the sum is exact in double */
+    if (acc >= ((__int128)1 << 37)) acc = (__int128)1 << 37;
+    if (acc <= -((__int128)1 << 37)) acc = -((__int128)1 << 37);
+    *result = posit8_from_double_v(ldexp((double)(int64_t)acc, -24));
     return POSIT_OK;
 }
 
 bool posit8_is_nar(posit8 p) {
-    return p8_isNaR(p);
+    return p == 0x80;
 }
 
 bool posit8_is_zero(posit8 p) {
-    return p8_isZero(p);
+    return p == 0;
 }
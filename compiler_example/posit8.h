@@ -3,9 +3,10 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /* SoftPosit wrapper for our compiler
- * This provides the interface our compiler expects
+ * This provides the interface our compiler expects (posit8 with es=1)
  */
 
 typedef uint8_t posit8;
@@ -30,8 +31,65 @@ posit8_error_t posit8_mul(posit8 *result, posit8 a, posit8 b);
 posit8_error_t posit8_div(posit8 *result, posit8 a, posit8 b);
 posit8_error_t posit8_fma(posit8 *result, posit8 a, posit8 b, posit8 c);
 
+/* Array variants: result[i] = a[i] <op> b[i] for i < n, NaR propagates per element.
+ * result may be a or b but must not partially overlap them. Gathers from the
+ * lookup tables with AVX2 where the CPU supports it, scalar loops otherwise.
+ */
+posit8_error_t posit8_add_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n);
+posit8_error_t posit8_sub_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n);
+posit8_error_t posit8_mul_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n);
+posit8_error_t posit8_div_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n);
+posit8_error_t posit8_from_float_n(posit8 *result, const float *values, size_t n);
+posit8_error_t posit8_to_float_n(float *result, const posit8 *p, size_t n);
+
+/* Dot product of a and b accumulated exactly in a quire, rounded once */
+posit8_error_t posit8_dot_n(posit8 *result, const posit8 *a, const posit8 *b, size_t n);
+
 /* Utility functions */
 bool posit8_is_nar(posit8 p);
 bool posit8_is_zero(posit8 p);
 
+/* Lookup tables generated at build time by posit8_gen (posit8_tables.c)
+ * - posit8_decode_table: value of every pattern, NAN for NaR
+ * - posit8_encode_bounds: rounding boundary between positive patterns p and p + 1
+ *   at index p - 1 (the value of the 9-bit pattern 2p + 1)
+ * - posit8_<op>_table: correctly rounded result of a <op> b at index (a << 8) | b
+ */
+extern const double posit8_decode_table[256];
+extern const double posit8_encode_bounds[126];
+extern const posit8 posit8_add_table[65536];
+extern const posit8 posit8_sub_table[65536];
+extern const posit8 posit8_mul_table[65536];
+extern const posit8 posit8_div_table[65536];
+
+/* Inline value-returning variants for generated code and hot loops:
+ * no out-parameters or error codes, NaR propagates as a value.
+ */
+static inline posit8 posit8_add_v(posit8 a, posit8 b) { return posit8_add_table[(a << 8) | b]; }
+static inline posit8 posit8_sub_v(posit8 a, posit8 b) { return posit8_sub_table[(a << 8) | b]; }
+static inline posit8 posit8_mul_v(posit8 a, posit8 b) { return posit8_mul_table[(a << 8) | b]; }
+static inline posit8 posit8_div_v(posit8 a, posit8 b) { return posit8_div_table[(a << 8) | b]; }
+static inline double posit8_to_double_v(posit8 p) { return posit8_decode_table[p]; }
+static inline float posit8_to_float_v(posit8 p) { return (float)posit8_decode_table[p]; }
+
+/* Round to nearest posit8, ties to the even pattern, by binary search over the boundaries */
+static inline posit8 posit8_from_double_v(double x) {
+    double ax = x < 0 ? -x : x;
+    int lo = 1, hi = 127, mid;
+    if (ax - ax != 0) return 0x80; /* NaN and infinities */
+    if (ax == 0) return 0;
+    while (lo < hi) {
+        mid = (lo + hi) >> 1;
+        if (ax <= posit8_encode_bounds[mid - 1]) hi = mid;
+        else lo = mid + 1;
+    }
+    if (lo < 127 && ax == posit8_encode_bounds[lo - 1] && (lo & 1)) lo++;
+    return (posit8)(x < 0 ? -lo : lo);
+}
+
+/* a * b + c with a single rounding: the exact result always fits in a double */
+static inline posit8 posit8_fma_v(posit8 a, posit8 b, posit8 c) {
+    return posit8_from_double_v(posit8_decode_table[a] * posit8_decode_table[b] + posit8_decode_table[c]);
+}
+
 #endif /* POSIT8_SOFTPOSIT_WRAPPER_H */
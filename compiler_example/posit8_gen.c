@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+/* posit8 table generator
+ * Run at build time (see Makefile) to emit posit8_tables.c: the decode table,
+ * the rounding boundaries used by the encoder, and the 256x256 result tables
+ * for add, sub, mul and div. Every entry is correctly rounded (round to
+ * nearest, ties to the even pattern, no rounding to zero or NaR).
+ *
+ * posit8 uses es=1 throughout the compiler runtime.
+ */
+
+#define ES 1
+
+/* Value of an nbits posit pattern (es=1); NaR decodes to NAN */
+static double decode(uint32_t p, int nbits) {
+    uint32_t mask = (1u << nbits) - 1;
+    int sign, k, n, e, fbits;
+    uint32_t body, frac;
+    if (p == 0) return 0.0;
+    if (p == 1u << (nbits - 1)) return NAN;
+    sign = (p >> (nbits - 1)) & 1;
+    if (sign) p = (-p) & mask;
+    /* bits after the sign, left aligned in 32 bits */
+    body = p << (33 - nbits);
+    n = (body >> 31) ? __builtin_clz(~body) : __builtin_clz(body);
+    if (n > nbits - 1) n = nbits - 1;
+    k = (body >> 31) ? n - 1 : -n;
+    /* skip regime and its terminating bit */
+    fbits = nbits - 1 - n - 1;
+    body = (n + 1 >= 32) ? 0 : body << (n + 1);
+    /* truncated exponent bits are zero, as are the padding bits of body */
+    e = (int)(body >> (32 - ES));
+    fbits = fbits > ES ? fbits - ES : 0;
+    frac = fbits ? (body << ES) >> (32 - fbits) : 0;
+    return (sign ? -1.0 : 1.0) * ldexp(1.0 + ldexp((double)frac, -fbits), k * (1 << ES) + e);
+}
+
+/* Correctly rounded posit8 for a double, by rounding the posit bit string */
+static uint8_t encode(double x) {
+    const int max_scale = 6 << ES;
+    int sign, scale, k, e, len;
+    uint64_t field, sig, rest;
+    uint32_t p;
+    double m;
+    if (isnan(x) || isinf(x)) return 0x80;
+    if (x == 0.0) return 0;
+    sign = x < 0;
+    m = frexp(fabs(x), &scale);
+    scale -= 1;
+    if (scale > max_scale) {
+        p = 0x7F;
+    } else if (scale < -max_scale) {
+        p = 1;
+    } else {
+        /* fraction bits of the significand, left aligned */
+        sig = (uint64_t)ldexp(m * 2.0 - 1.0, 63) << 1;
+        k = scale >> ES;
+        e = scale & ((1 << ES) - 1);
+        if (k >= 0) {
+            len = k + 2;
+            field = ((1ULL << (k + 1)) - 1) << (64 - (k + 1));
+        } else {
+            len = 1 - k;
+            field = 1ULL << (64 - len);
+        }
+        field |= (uint64_t)e << (64 - len - ES);
+        field |= sig >> (len + ES);
+        rest = sig << (64 - len - ES);
+        p = (uint32_t)(field >> 57);
+        if (p != 0x7F && ((field >> 56) & 1) && ((field & ((1ULL << 56) - 1)) || rest || (p & 1)))
+            p++;
+        if (p == 0) p = 1;
+    }
+    return (uint8_t)(sign ? -p : p);
+}
+
+/* Rounding boundary between positive patterns p and p + 1: the 9-bit pattern 2p + 1 */
+static double bound(int p) {
+    return decode(2u * p + 1, 9);
+}
+
+/* Encoder as used by the runtime: binary search over the boundaries */
+static uint8_t encode_bounds(double x) {
+    double ax = fabs(x);
+    int lo = 1, hi = 127, mid;
+    if (isnan(x) || isinf(x)) return 0x80;
+    if (ax == 0.0) return 0;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (ax <= bound(mid)) hi = mid;
+        else lo = mid + 1;
+    }
+    if (lo < 127 && ax == bound(lo) && (lo & 1)) lo++;
+    return (uint8_t)(x < 0 ? -lo : lo);
+}
+
+static int emit_table(const char *name, int op) {
+    int a, b;
+    printf("const posit8 %s[65536] = {\n", name);
+    for (a = 0; a < 256; a++) {
+        for (b = 0; b < 256; b++) {
+            double da = decode(a, 8), db = decode(b, 8), r;
+            uint8_t p;
+            /* sums and products of two posit8 values are exact in double; a quotient
+             * is never close enough to a rounding boundary to be rounded twice */
+            switch (op) {
+            case 0: r = da + db; break;
+            case 1: r = da - db; break;
+            case 2: r = da * db; break;
+            default: r = db == 0.0 ? NAN : da / db; break;
+            }
+            p = encode(r);
+            if (p != encode_bounds(r)) {
+                fprintf(stderr, "posit8_gen: encoders disagree for %s(0x%02x, 0x%02x)\n", name, a, b);
+                return 1;
+            }
+            printf("%s0x%02x,", b % 16 ? " " : "\n    ", p);
+        }
+    }
+    printf("\n};\n\n");
+    return 0;
+}
+
+int main(void) {
+    int p;
+    printf("/* Generated by posit8_gen, do not edit. */\n");
+    printf("#include <math.h>\n");
+    printf("#include \"posit8.h\"\n\n");
+
+    printf("const double posit8_decode_table[256] = {\n");
+    for (p = 0; p < 256; p++) {
+        if (p == 0x80) printf("    NAN,\n");
+        else printf("    %.17g,\n", decode(p, 8));
+    }
+    printf("};\n\n");
+
+    printf("const double posit8_encode_bounds[126] = {\n");
+    for (p = 1; p < 127; p++)
+        printf("    %.17g,\n", bound(p));
+    printf("};\n\n");
+
+    return emit_table("posit8_add_table", 0) || emit_table("posit8_sub_table", 1) ||
+           emit_table("posit8_mul_table", 2) || emit_table("posit8_div_table", 3);
+}
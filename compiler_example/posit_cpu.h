@@ -0,0 +1,26 @@
+#ifndef POSIT_CPU_H
+#define POSIT_CPU_H
+
+/* Runtime CPU dispatch for the posit array kernels
+ * The SIMD kernels are compiled with per-function target attributes, so the
+ * runtime builds without -mavx2 and falls back to the scalar loops on CPUs
+ * (or compilers) without AVX2.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+#define POSIT_X86_SIMD 1
+#define POSIT_TARGET_AVX2 __attribute__((target("avx2")))
+
+static inline int posit_cpu_has_avx2(void) {
+    static int has_avx2 = -1;
+    if (has_avx2 < 0) {
+        __builtin_cpu_init();
+        has_avx2 = __builtin_cpu_supports("avx2") != 0;
+    }
+    return has_avx2;
+}
+#endif
+
+#endif /* POSIT_CPU_H */
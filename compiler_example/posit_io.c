@@ -0,0 +1,92 @@
+#define _POSIX_C_SOURCE 200809L
+#include "posit_io.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* the text after name= on the command line, or NULL */
+static const char *argument(const char *name, int argc, char **argv) {
+    size_t len = strlen(name);
+    int i;
+    for (i = 1; i < argc; i++)
+        if (strncmp(argv[i], name, len) == 0 && argv[i][len] == '=') return argv[i] + len + 1;
+    return NULL;
+}
+
+/* name=path on the command line, name.bin otherwise */
+static const char *array_path(const char *name, int argc, char **argv, char *fallback, size_t size) {
+    const char *path = argument(name, argc, argv);
+    if (path != NULL) return path;
+    snprintf(fallback, size, "%s.bin", name);
+    return fallback;
+}
+
+void *posit_io_map(const char *name, size_t bytes, int argc, char **argv) {
+    char fallback[1024];
+    const char *path = array_path(name, argc, argv, fallback, sizeof(fallback));
+    struct stat st;
+    void *data;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != bytes) {
+        fprintf(stderr, "%s: array %s needs %zu bytes\n", path, name, bytes);
+        close(fd);
+        return NULL;
+    }
+    data = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror(path);
+        return NULL;
+    }
+    /* the generated loops stream through their inputs once */
+    posix_madvise(data, bytes, POSIX_MADV_SEQUENTIAL);
+    return data;
+}
+
+int posit_io_store(const char *name, const void *data, size_t bytes, int argc, char **argv) {
+    char fallback[1024], temp[1040];
+    const char *path = array_path(name, argc, argv, fallback, sizeof(fallback));
+    FILE *f;
+    int ok;
+
+    /* truncating the file in place would pull it from under a mapped input */
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+    f = fopen(temp, "wb");
+    if (f == NULL) {
+        perror(temp);
+        return -1;
+    }
+    ok = fwrite(data, 1, bytes, f) == bytes;
+    ok &= fclose(f) == 0;
+    if (!ok || rename(temp, path) != 0) {
+        perror(ok ? path : temp);
+        remove(temp);
+        return -1;
+    }
+    return 0;
+}
+
+int posit_io_scalar(const char *name, double *value, int argc, char **argv) {
+    const char *text = argument(name, argc, argv);
+    char *end;
+
+    if (text == NULL) {
+        fprintf(stderr, "missing input %s=value\n", name);
+        return -1;
+    }
+    *value = strtod(text, &end);
+    if (end == text || *end != '\0') {
+        fprintf(stderr, "input %s: %s is not a number\n", name, text);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef POSIT_IO_H
+#define POSIT_IO_H
+
+#include <stddef.h>
+
+/* Inputs and array files for compiled posit programs
+ * An array named x lives in x.bin, or in the file given as an x=path
+ * argument to the program. Files hold the raw posit bit patterns in the
+ * machine's byte order, with no header. A scalar input a is given as an
+ * a=value argument.
+ */
+
+/* Map the input array name, which must be exactly bytes long. The mapping is
+ * private: updates reach the file only when the program stores the array.
+ * Returns NULL after printing the reason to stderr.
+ */
+void *posit_io_map(const char *name, size_t bytes, int argc, char **argv);
+
+/* Write the array name, through a temporary file renamed over the old one, so
+ * that data may still be a mapping of that file. Returns 0, or -1 after
+ * printing the reason to stderr.
+ */
+int posit_io_store(const char *name, const void *data, size_t bytes, int argc, char **argv);
+
+/* Read the scalar input name. Returns 0, or -1 after printing the reason to stderr. */
+int posit_io_scalar(const char *name, double *value, int argc, char **argv);
+
+#endif /* POSIT_IO_H */
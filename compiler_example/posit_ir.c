@@ -0,0 +1,2376 @@
+#include "posit_ir.h"
+#include "posit8.h"
+#include "posit16.h"
+/* posit32 and the quire only: posit8 and posit16 come from the runtimes above */
+#define POSIT_SFP_POSIT32_ONLY
+#include "posit_sfp.h"
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Arena for everything that lives as long as the compiler: interned names and
+ * generated operand strings. Blocks are never freed individually.
+ */
+#define ARENA_BLOCK (64 * 1024)
+
+typedef struct arena_block {
+    struct arena_block *next;
+    size_t used, size;
+    char data[];
+} arena_block_t;
+
+static arena_block_t *arena = NULL;
+
+static void *xrealloc(void *p, size_t n) {
+    p = realloc(p, n);
+    if (p == NULL) {
+        fprintf(stderr, "Error: out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void *arena_alloc(size_t n) {
+    void *p;
+    n = (n + 7) & ~(size_t)7;
+    if (arena == NULL || arena->used + n > arena->size) {
+        size_t size = n > ARENA_BLOCK ? n : ARENA_BLOCK;
+        arena_block_t *block = (arena_block_t*)xrealloc(NULL, sizeof(arena_block_t) + size);
+        block->next = arena;
+        block->used = 0;
+        block->size = size;
+        arena = block;
+    }
+    p = arena->data + arena->used;
+    arena->used += n;
+    return p;
+}
+
+static const char *arena_printf(const char *fmt, ...) {
+    char *s;
+    int n;
+    va_list ap;
+    va_start(ap, fmt);
+    n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    s = (char*)arena_alloc((size_t)n + 1);
+    va_start(ap, fmt);
+    vsnprintf(s, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    return s;
+}
+
+static uint64_t hash_bytes(const char *s) {
+    uint64_t h = 14695981039346656037ULL;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static uint64_t hash_mix(uint64_t h, uint64_t x) {
+    h ^= x + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+/* Open addressing tables of ids (-1 empty), grown at half load */
+typedef struct {
+    int *slots;
+    size_t mask, count;
+} id_table_t;
+
+static void table_init(id_table_t *t, size_t size) {
+    t->slots = (int*)xrealloc(NULL, size * sizeof(int));
+    memset(t->slots, 0xFF, size * sizeof(int));
+    t->mask = size - 1;
+    t->count = 0;
+}
+
+/* Interned names: equal names are the same pointer */
+static const char **names = NULL;
+static size_t name_count = 0;
+static id_table_t name_table;
+
+static void name_insert(id_table_t *t, int id) {
+    size_t i = hash_bytes(names[id]) & t->mask;
+    while (t->slots[i] >= 0) i = (i + 1) & t->mask;
+    t->slots[i] = id;
+    t->count++;
+}
+
+static const char *intern(const char *text) {
+    size_t i = hash_bytes(text) & name_table.mask;
+    char *copy;
+    for (; name_table.slots[i] >= 0; i = (i + 1) & name_table.mask)
+        if (strcmp(names[name_table.slots[i]], text) == 0) return names[name_table.slots[i]];
+    copy = (char*)arena_alloc(strlen(text) + 1);
+    strcpy(copy, text);
+    names = (const char**)xrealloc(names, (name_count + 1) * sizeof(const char*));
+    names[name_count] = copy;
+    if (2 * (name_table.count + 1) > name_table.mask + 1) {
+        size_t n;
+        free(name_table.slots);
+        table_init(&name_table, 2 * (name_table.mask + 1));
+        for (n = 0; n < name_count; n++) name_insert(&name_table, (int)n);
+    }
+    name_insert(&name_table, (int)name_count);
+    name_count++;
+    return copy;
+}
+
+/* SSA values, hash-consed */
+static ir_value_t *values = NULL;
+static size_t value_count = 0, value_cap = 0;
+static id_table_t value_table;
+
+static uint64_t value_hash(const ir_value_t *v) {
+    uint64_t h = hash_mix((uint64_t)v->op, (uint64_t)v->type);
+    h = hash_mix(h, (uint64_t)(uint32_t)v->a);
+    h = hash_mix(h, (uint64_t)(uint32_t)v->b);
+    h = hash_mix(h, v->bits);
+    h = hash_mix(h, (uint64_t)(uint32_t)v->array);
+    h = hash_mix(h, (uint64_t)(uint32_t)v->version);
+    h = hash_mix(h, (uint64_t)(uint32_t)v->offset);
+    h = hash_mix(h, (uint64_t)(uint32_t)v->loop);
+    return hash_mix(h, (uint64_t)(uintptr_t)v->name);
+}
+
+static int value_equal(const ir_value_t *x, const ir_value_t *y) {
+    return x->op == y->op && x->type == y->type && x->a == y->a && x->b == y->b &&
+           x->bits == y->bits && x->name == y->name && x->array == y->array &&
+           x->version == y->version && x->offset == y->offset && x->loop == y->loop;
+}
+
+static void value_insert(int id) {
+    size_t i = value_hash(&values[id]) & value_table.mask;
+    while (value_table.slots[i] >= 0) i = (i + 1) & value_table.mask;
+    value_table.slots[i] = id;
+    value_table.count++;
+}
+
+static int intern_value(ir_value_t *v) {
+    size_t i = value_hash(v) & value_table.mask;
+    for (; value_table.slots[i] >= 0; i = (i + 1) & value_table.mask)
+        if (value_equal(&values[value_table.slots[i]], v)) return value_table.slots[i];
+    v->varying = v->op == IR_ELEM || (v->a >= 0 && values[v->a].varying) || (v->b >= 0 && values[v->b].varying);
+    if (value_count == value_cap) {
+        value_cap = value_cap ? 2 * value_cap : 1024;
+        values = (ir_value_t*)xrealloc(values, value_cap * sizeof(ir_value_t));
+    }
+    values[value_count] = *v;
+    if (2 * (value_table.count + 1) > value_table.mask + 1) {
+        size_t n;
+        free(value_table.slots);
+        table_init(&value_table, 2 * (value_table.mask + 1));
+        for (n = 0; n < value_count; n++) value_insert((int)n);
+    }
+    value_insert((int)value_count);
+    return (int)value_count++;
+}
+
+static int make_value(ir_op_t op, posit_type_t type, int a, int b, uint32_t bits, const char *name) {
+    ir_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.op = op;
+    v.type = type;
+    v.a = a;
+    v.b = b;
+    v.bits = bits;
+    v.name = name;
+    return intern_value(&v);
+}
+
+static int make_const(posit_type_t type, uint32_t bits) {
+    return make_value(IR_CONST, type, -1, -1, bits, NULL);
+}
+
+/* Statements: declarations in source order. Values created while parsing a
+ * statement are emitted just before it, so operands always come first.
+ */
+typedef struct {
+    const char *type_name;  /* NULL for supported posit declarations */
+    posit_type_t type;
+    const char *name;
+    int value;
+    int fused;              /* quire declaration */
+    int array;              /* element statement: the array symbol written, else -1 */
+    int quire;              /* quire statement: the quire symbol, else -1 */
+    const ir_term_t *terms; /* accumulation: the products added; none declares the quire */
+    int nterms;
+    int offset, loop;       /* writes array[index + offset] in iteration space loop */
+    long long lo, hi;       /* for lo <= index < hi */
+    size_t value_end;       /* values created up to the end of this statement */
+} ir_stmt_t;
+
+static ir_stmt_t *stmts = NULL;
+static size_t stmt_count = 0, stmt_cap = 0;
+
+/* Declared variables and arrays */
+typedef struct {
+    const char *name;
+    int value;              /* -1 for an array or a quire */
+    posit_type_t type;      /* arrays */
+    long long length;
+    int input;              /* declared input: arrays are mapped from a file, not written back */
+    int quire;              /* quire32 variable */
+    int version;            /* statements that wrote the array or the quire so far */
+    double lo, hi;          /* inputs: the declared range, if ranged */
+    int ranged;
+    int read;               /* read by live code: arrays and inputs set by ir_emit, quires by compute_liveness */
+} ir_symbol_t;
+
+static ir_symbol_t *symbols = NULL;
+static size_t symbol_count = 0;
+static id_table_t symbol_table;
+
+static void symbol_insert(int id) {
+    size_t i = hash_bytes(symbols[id].name) & symbol_table.mask;
+    while (symbol_table.slots[i] >= 0) i = (i + 1) & symbol_table.mask;
+    symbol_table.slots[i] = id;
+    symbol_table.count++;
+}
+
+/* Semantic errors are reported as they are found; nothing is emitted after one */
+static int error_count = 0;
+
+static void ir_error(const char *fmt, ...) {
+    va_list ap;
+    fprintf(stderr, "Error: ");
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+    error_count++;
+}
+
+int ir_errors(void) {
+    return error_count;
+}
+
+/* The loop being parsed. Statements outside loops are iteration spaces of
+ * their own, so array elements of different statements are never shared.
+ */
+static const char *loop_index = NULL;
+static long long loop_lo = 0, loop_hi = 0;
+static int current_space = 0;
+
+void ir_init(void) {
+    table_init(&name_table, 1024);
+    table_init(&value_table, 2048);
+    table_init(&symbol_table, 1024);
+}
+
+/* Pattern of the posit of type nearest to value */
+static uint32_t encode_bits(posit_type_t type, double value) {
+    posit16 p = 0;
+    posit32 q = 0;
+    if (type == TYPE_POSIT32) {
+        posit32_from_double(&q, value);
+        return q;
+    }
+    if (type == TYPE_POSIT16) {
+        posit16_from_double(&p, value);
+        return p;
+    }
+    return posit8_from_double_v(value);
+}
+
+static double posit_value(posit_type_t type, uint32_t bits) {
+    double value = 0.0;
+    if (type == TYPE_POSIT32) posit32_to_double(&value, (posit32)bits);
+    else if (type == TYPE_POSIT16) posit16_to_double(&value, (posit16)bits);
+    else value = posit8_to_double_v((posit8)bits);
+    return value;
+}
+
+/* Literals are encoded at compile time, correctly rounded */
+int ir_literal(const char *text) {
+    double value = strtod(text, NULL);
+    if (strstr(text, "p32") != NULL) return make_const(TYPE_POSIT32, encode_bits(TYPE_POSIT32, value));
+    if (strstr(text, "p16") != NULL) return make_const(TYPE_POSIT16, encode_bits(TYPE_POSIT16, value));
+    /* Default to posit8 for p8 or no suffix */
+    return make_const(TYPE_POSIT8, encode_bits(TYPE_POSIT8, value));
+}
+
+int ir_input(const char *name) {
+    if (loop_index != NULL && strcmp(name, loop_index) == 0)
+        ir_error("the loop index %s can only index arrays", name);
+    return make_value(IR_INPUT, TYPE_POSIT8, -1, -1, 0, intern(name));
+}
+
+/* Through double, which holds every posit8, posit16 and posit32 value
+ * exactly: a narrowing conversion rounds once. Each type holds every value
+ * of the narrower ones.
+ */
+static uint32_t convert_bits(uint32_t bits, posit_type_t from, posit_type_t type) {
+    return encode_bits(type, posit_value(from, bits));
+}
+
+static const char *type_name(posit_type_t type) {
+    return type == TYPE_POSIT32 ? "posit32" : type == TYPE_POSIT16 ? "posit16" : "posit8";
+}
+
+static int type_bits(posit_type_t type) {
+    return type == TYPE_POSIT32 ? 32 : type == TYPE_POSIT16 ? 16 : 8;
+}
+
+static int type_es(posit_type_t type) {
+    return type == TYPE_POSIT32 ? 2 : 1;
+}
+
+/* maxpos = 2^((n - 2) * 2^es) */
+static int type_max_scale(posit_type_t type) {
+    return (type_bits(type) - 2) << type_es(type);
+}
+
+static uint32_t one_bits(posit_type_t type) {
+    return 1u << (type_bits(type) - 2);
+}
+
+int ir_convert(int a, posit_type_t type) {
+    if (values[a].type == type) return a;
+    if (values[a].op == IR_CONST) return make_const(type, convert_bits(values[a].bits, values[a].type, type));
+    return make_value(IR_CONVERT, type, a, -1, 0, NULL);
+}
+
+/* With an error bound, types are chosen by precision selection in ir_emit:
+ * until then operations keep their operands as they are, and the only
+ * conversions are the roundings of declarations.
+ */
+static double error_bound = 0.0;
+
+/* a <op> b in the wider of the operand types. Constants are folded in
+ * ir_emit, after contraction has decided how many roundings there are.
+ */
+int ir_binary(ir_op_t op, int a, int b) {
+    posit_type_t type = values[a].type > values[b].type ? values[a].type : values[b].type;
+    /* the array functions stop at posit16 */
+    if (type == TYPE_POSIT32 && (values[a].varying || values[b].varying))
+        ir_error("array elements cannot be computed in posit32");
+    if (error_bound == 0.0) {
+        a = ir_convert(a, type);
+        b = ir_convert(b, type);
+    }
+    /* canonical operand order for the commutative operations, for CSE */
+    if ((op == IR_ADD || op == IR_MUL) && a > b) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    return make_value(op, type, a, b, 0, NULL);
+}
+
+/* Leaves: constants, inputs and array elements */
+static int is_computed(int v) {
+    return values[v].op != IR_CONST && values[v].op != IR_INPUT && values[v].op != IR_ELEM;
+}
+
+/* Values that round to a type of their own, unlike leaves, uses of variables
+ * and reads of quires
+ */
+static int is_operation(int v) {
+    return is_computed(v) && values[v].op != IR_NAME && values[v].op != IR_QUIRE;
+}
+
+static int find_symbol(const char *name) {
+    size_t i = hash_bytes(name) & symbol_table.mask;
+    int found = -1;
+    /* the latest declaration wins */
+    for (; symbol_table.slots[i] >= 0; i = (i + 1) & symbol_table.mask)
+        if (strcmp(symbols[symbol_table.slots[i]].name, name) == 0) found = symbol_table.slots[i];
+    return found;
+}
+
+static int add_symbol(const char *name, int value) {
+    symbols = (ir_symbol_t*)xrealloc(symbols, (symbol_count + 1) * sizeof(ir_symbol_t));
+    memset(&symbols[symbol_count], 0, sizeof(ir_symbol_t));
+    symbols[symbol_count].name = name;
+    symbols[symbol_count].value = value;
+    if (2 * (symbol_table.count + 1) > symbol_table.mask + 1) {
+        size_t n;
+        free(symbol_table.slots);
+        table_init(&symbol_table, 2 * (symbol_table.mask + 1));
+        for (n = 0; n < symbol_count; n++) symbol_insert((int)n);
+    }
+    symbol_insert((int)symbol_count);
+    return (int)symbol_count++;
+}
+
+static int make_elem(int array, int offset) {
+    ir_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.op = IR_ELEM;
+    v.type = symbols[array].type;
+    v.a = v.b = -1;
+    v.name = symbols[array].name;
+    v.array = array;
+    v.version = symbols[array].version;
+    v.offset = offset;
+    v.loop = current_space;
+    return intern_value(&v);
+}
+
+/* The quire's contents so far, rounded to posit32 */
+static int make_quire(int quire) {
+    ir_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.op = IR_QUIRE;
+    v.type = TYPE_POSIT32;
+    v.a = v.b = -1;
+    v.name = symbols[quire].name;
+    v.array = quire;
+    v.version = symbols[quire].version;
+    return intern_value(&v);
+}
+
+int ir_lookup(const char *name) {
+    int found = find_symbol(name);
+    if (found < 0) return -1;
+    if (symbols[found].quire) return make_quire(found);
+    if (symbols[found].value < 0) {
+        /* outside loops an array stands for each of its elements in turn */
+        if (loop_index != NULL) {
+            ir_error("array %s needs an index in a loop", name);
+            return make_const(symbols[found].type, 0);
+        }
+        return make_elem(found, 0);
+    }
+    /* a declared input is the value itself */
+    if (symbols[found].input) return symbols[found].value;
+    /* a variable holds a rounded value: contraction must not look through it */
+    return make_value(IR_NAME, values[symbols[found].value].type, symbols[found].value, -1, 0, NULL);
+}
+
+static ir_stmt_t *new_stmt(void) {
+    if (stmt_count == stmt_cap) {
+        stmt_cap = stmt_cap ? 2 * stmt_cap : 256;
+        stmts = (ir_stmt_t*)xrealloc(stmts, stmt_cap * sizeof(ir_stmt_t));
+    }
+    memset(&stmts[stmt_count], 0, sizeof(ir_stmt_t));
+    stmts[stmt_count].value = -1;
+    stmts[stmt_count].array = -1;
+    stmts[stmt_count].quire = -1;
+    return &stmts[stmt_count++];
+}
+
+/* A scalar cannot hold array elements, and an array or quire name is never rebound */
+static int check_scalar(const char *name, int value) {
+    int found = find_symbol(name);
+    if (found >= 0 && symbols[found].value < 0) {
+        ir_error("%s is already declared as %s", name, symbols[found].quire ? "a quire" : "an array");
+        return 0;
+    }
+    if (values[value].varying) {
+        ir_error("scalar %s cannot be initialized from array elements", name);
+        return 0;
+    }
+    return 1;
+}
+
+void ir_declare(posit_type_t type, const char *name, int value) {
+    ir_stmt_t *s;
+    if (!check_scalar(name, value)) return;
+    if (error_bound == 0.0)
+        value = ir_convert(value, type);
+    else if (!is_operation(value))
+        /* a rounding of its own, whatever precision selection makes of it */
+        value = make_value(IR_CONVERT, type, value, -1, 0, NULL);
+    s = new_stmt();
+    s->type = type;
+    s->name = intern(name);
+    s->value = value;
+    s->value_end = value_count;
+    add_symbol(s->name, value);
+}
+
+void ir_declare_quire(const char *name, int value) {
+    if (!check_scalar(name, value)) return;
+    ir_declare(values[value].type, name, value);
+    stmts[stmt_count - 1].fused = 1;
+}
+
+void ir_declare_accumulator(const char *type_name, const char *name) {
+    ir_stmt_t *s;
+    int quire;
+    if (strcmp(type_name, "quire32") != 0) {
+        ir_error("%s needs a value, only a quire32 starts out as zero", name);
+        return;
+    }
+    if (find_symbol(name) >= 0) {
+        ir_error("%s is already declared", name);
+        return;
+    }
+    quire = add_symbol(intern(name), -1);
+    symbols[quire].quire = 1;
+    symbols[quire].type = TYPE_POSIT32;
+    s = new_stmt();
+    s->type = TYPE_POSIT32;
+    s->name = symbols[quire].name;
+    s->quire = quire;
+    s->value_end = value_count;
+}
+
+/* v without the widening conversions operations insert on their operands */
+static int unwidened(int v) {
+    while (values[v].op == IR_CONVERT && values[values[v].a].type < values[v].type) v = values[v].a;
+    return v;
+}
+
+/* The products of a sum go into the quire unrounded: the sum is flattened
+ * into +-a*b terms, through the conversions of mixed-type operations, with
+ * both factors converted to posit32 exactly and other leaves becoming x*1
+ */
+void ir_accumulate(const char *name, int value, int negate) {
+    int found = find_symbol(name), one = make_const(TYPE_POSIT32, one_bits(TYPE_POSIT32));
+    ir_term_t *terms = NULL;
+    int *stack = NULL;
+    size_t nterms = 0, depth = 0, cap = 64;
+    ir_stmt_t *s;
+    if (found < 0 || !symbols[found].quire) {
+        ir_error("%s is not a quire", name);
+        return;
+    }
+    if (values[value].varying) {
+        ir_error("quire %s cannot accumulate array elements", name);
+        return;
+    }
+    stack = (int*)xrealloc(NULL, 2 * cap * sizeof(int));
+    terms = (ir_term_t*)xrealloc(NULL, cap * sizeof(ir_term_t));
+    stack[depth++] = value;
+    stack[depth++] = negate;
+    while (depth > 0) {
+        int neg = stack[--depth], w = unwidened(stack[--depth]);
+        const ir_value_t *y = &values[w];
+        while (depth + 4 > 2 * cap || nterms + 1 > cap) {
+            cap *= 2;
+            stack = (int*)xrealloc(stack, 2 * cap * sizeof(int));
+            terms = (ir_term_t*)xrealloc(terms, cap * sizeof(ir_term_t));
+        }
+        if (y->op == IR_ADD || y->op == IR_SUB) {
+            stack[depth++] = y->b;
+            stack[depth++] = neg ^ (y->op == IR_SUB);
+            stack[depth++] = y->a;
+            stack[depth++] = neg;
+            continue;
+        }
+        if (y->op == IR_MUL) {
+            /* read before converting: new values may move the table */
+            int fa = unwidened(y->a), fb = unwidened(y->b);
+            terms[nterms].a = ir_convert(fa, TYPE_POSIT32);
+            terms[nterms].b = ir_convert(fb, TYPE_POSIT32);
+        } else {
+            terms[nterms].a = ir_convert(w, TYPE_POSIT32);
+            terms[nterms].b = one;
+        }
+        terms[nterms++].neg = neg;
+    }
+    s = new_stmt();
+    s->type = TYPE_POSIT32;
+    s->name = symbols[found].name;
+    s->quire = found;
+    s->nterms = (int)nterms;
+    s->terms = (ir_term_t*)arena_alloc(nterms * sizeof(ir_term_t));
+    memcpy((void*)s->terms, terms, nterms * sizeof(ir_term_t));
+    s->value_end = value_count;
+    /* later reads see the new contents */
+    symbols[found].version++;
+    free(stack);
+    free(terms);
+}
+
+void ir_unsupported(const char *type_name) {
+    ir_stmt_t *s = new_stmt();
+    s->type_name = intern(type_name);
+    s->value_end = value_count;
+}
+
+/* Array lengths, loop bounds and index offsets are decimal integers */
+static long long parse_count(const char *text) {
+    char *end;
+    long long n;
+    errno = 0;
+    n = strtoll(text, &end, 10);
+    if (*end != '\0' || errno != 0 || n > (1LL << 40)) {
+        ir_error("%s is not an array length or index", text);
+        return 0;
+    }
+    return n;
+}
+
+/* Array elements a varying value reads, found by a walk over the values
+ * that depend on them
+ */
+static int *walk_stack = NULL, *walk_elems = NULL;
+static unsigned *walk_mark = NULL;
+static size_t walk_cap = 0, walk_mark_cap = 0;
+static unsigned walk_stamp = 0;
+
+static size_t find_elements(int root) {
+    size_t depth = 0, count = 0;
+    if (walk_mark_cap < value_count) {
+        walk_mark = (unsigned*)xrealloc(walk_mark, value_cap * sizeof(unsigned));
+        memset(walk_mark + walk_mark_cap, 0, (value_cap - walk_mark_cap) * sizeof(unsigned));
+        walk_mark_cap = value_cap;
+    }
+    if (++walk_stamp == 0) {
+        memset(walk_mark, 0, walk_mark_cap * sizeof(unsigned));
+        walk_stamp = 1;
+    }
+    if (walk_cap == 0) {
+        walk_cap = 64;
+        walk_stack = (int*)xrealloc(NULL, walk_cap * sizeof(int));
+        walk_elems = (int*)xrealloc(NULL, walk_cap * sizeof(int));
+    }
+    walk_stack[depth++] = root;
+    while (depth > 0) {
+        int v = walk_stack[--depth];
+        if (v < 0 || !values[v].varying || walk_mark[v] == walk_stamp) continue;
+        walk_mark[v] = walk_stamp;
+        if (depth + 2 > walk_cap || count + 1 > walk_cap) {
+            walk_cap *= 2;
+            walk_stack = (int*)xrealloc(walk_stack, walk_cap * sizeof(int));
+            walk_elems = (int*)xrealloc(walk_elems, walk_cap * sizeof(int));
+        }
+        if (values[v].op == IR_ELEM) {
+            walk_elems[count++] = v;
+        } else {
+            walk_stack[depth++] = values[v].a;
+            walk_stack[depth++] = values[v].b;
+        }
+    }
+    return count;
+}
+
+/* Every element value reads for lo <= index < hi lies inside its array; a
+ * whole-array statement (length >= 0) reads arrays of its own length
+ */
+static void check_elements(int value, long long lo, long long hi, long long length) {
+    size_t i, n = find_elements(value);
+    for (i = 0; i < n; i++) {
+        const ir_value_t *x = &values[walk_elems[i]];
+        const ir_symbol_t *a = &symbols[x->array];
+        if (length >= 0 && a->length != length)
+            ir_error("array %s has %lld elements, not %lld", a->name, a->length, length);
+        else if (lo + x->offset < 0 || hi + x->offset > a->length)
+            ir_error("%s[%lld] is out of bounds, %s has %lld elements", a->name,
+                     lo + x->offset < 0 ? lo + x->offset : hi - 1 + x->offset, a->name, a->length);
+    }
+}
+
+/* array[index + offset] = value for lo <= index < hi */
+static void add_write(int array, long long lo, long long hi, int offset, int value) {
+    ir_stmt_t *s;
+    if (error_bound == 0.0) value = ir_convert(value, symbols[array].type);
+    s = new_stmt();
+    s->type = symbols[array].type;
+    s->name = symbols[array].name;
+    s->value = value;
+    s->array = array;
+    s->offset = offset;
+    s->loop = current_space;
+    s->lo = lo;
+    s->hi = hi;
+    s->value_end = value_count;
+    /* later reads see the new contents */
+    symbols[array].version++;
+}
+
+void ir_declare_array(const char *type_name, const char *name, const char *length, int value) {
+    posit_type_t type = TYPE_POSIT8;
+    int errors = error_count, array;
+    long long n = parse_count(length);
+    if (strcmp(type_name, "posit16") == 0) {
+        type = TYPE_POSIT16;
+    } else if (strcmp(type_name, "posit8") != 0) {
+        ir_error("arrays of %s are not supported", type_name);
+        return;
+    }
+    if (n <= 0) {
+        if (error_count == errors) ir_error("array %s needs at least one element", name);
+        return;
+    }
+    if (find_symbol(name) >= 0) {
+        ir_error("%s is already declared", name);
+        return;
+    }
+    if (value >= 0) check_elements(value, 0, n, n);
+    array = add_symbol(intern(name), -1);
+    symbols[array].type = type;
+    symbols[array].length = n;
+    symbols[array].input = value < 0;
+    if (value >= 0) add_write(array, 0, n, 0, value);
+    current_space++;
+}
+
+void ir_loop_begin(const char *index, const char *lo, const char *hi) {
+    loop_lo = parse_count(lo);
+    loop_hi = parse_count(hi);
+    if (loop_lo >= loop_hi) ir_error("loop range %s:%s is empty", lo, hi);
+    loop_index = intern(index);
+    current_space++;
+}
+
+void ir_loop_end(void) {
+    loop_index = NULL;
+    current_space++;
+}
+
+int ir_index(const char *index, const char *offset, int sign) {
+    long long n = offset != NULL ? parse_count(offset) : 0;
+    if (loop_index == NULL || strcmp(index, loop_index) != 0) {
+        ir_error("%s is not a loop index", index);
+        return 0;
+    }
+    if (n > (1 << 30)) {
+        ir_error("index offset %s is too large", offset);
+        return 0;
+    }
+    return sign * (int)n;
+}
+
+int ir_element(const char *name, int offset) {
+    int found = find_symbol(name);
+    if (found < 0 || symbols[found].value >= 0 || symbols[found].quire) {
+        ir_error("%s is not an array", name);
+        return make_const(TYPE_POSIT8, 0);
+    }
+    return make_elem(found, offset);
+}
+
+void ir_assign(const char *name, int offset, int value) {
+    int found = find_symbol(name);
+    if (found < 0 || symbols[found].value >= 0 || symbols[found].quire) {
+        ir_error("%s is not an array", name);
+        return;
+    }
+    if (loop_lo + offset < 0 || loop_hi + offset > symbols[found].length) {
+        ir_error("%s[%lld] is out of bounds, %s has %lld elements", name,
+                 loop_lo + offset < 0 ? loop_lo + offset : loop_hi - 1 + offset, name, symbols[found].length);
+        return;
+    }
+    check_elements(value, loop_lo, loop_hi, -1);
+    add_write(found, loop_lo, loop_hi, offset, value);
+}
+
+void ir_declare_input(const char *type_name, const char *name) {
+    posit_type_t type = TYPE_POSIT8;
+    int found;
+    if (strcmp(type_name, "posit32") == 0) {
+        type = TYPE_POSIT32;
+    } else if (strcmp(type_name, "posit16") == 0) {
+        type = TYPE_POSIT16;
+    } else if (strcmp(type_name, "posit8") != 0) {
+        ir_error("inputs of %s are not supported", type_name);
+        return;
+    }
+    if (find_symbol(name) >= 0) {
+        ir_error("%s is already declared", name);
+        return;
+    }
+    found = add_symbol(intern(name), make_value(IR_INPUT, type, -1, -1, 0, intern(name)));
+    symbols[found].input = 1;
+}
+
+void ir_input_range(const char *name, double lo, double hi) {
+    int found = find_symbol(name);
+    ir_symbol_t *x;
+    double maxpos;
+    /* only right after the input's own declaration: a failed one declared nothing */
+    if (found < 0 || found != (int)symbol_count - 1) return;
+    x = &symbols[found];
+    if (!x->input) return;
+    maxpos = ldexp(1.0, type_max_scale(x->value >= 0 ? values[x->value].type : x->type));
+    if (!(lo <= hi)) {
+        ir_error("range %g:%g of %s is empty", lo, hi, name);
+    } else if (lo < -maxpos || hi > maxpos) {
+        ir_error("range %g:%g of %s exceeds its type", lo, hi, name);
+    } else {
+        x->lo = lo;
+        x->hi = hi;
+        x->ranged = 1;
+    }
+}
+
+/* Buffered output */
+typedef struct {
+    char *data;
+    size_t len, cap;
+} buffer_t;
+
+static void buf_printf(buffer_t *b, const char *fmt, ...) {
+    va_list ap;
+    int n;
+    for (;;) {
+        va_start(ap, fmt);
+        n = vsnprintf(b->data + b->len, b->cap - b->len, fmt, ap);
+        va_end(ap);
+        if (n >= 0 && b->len + (size_t)n < b->cap) break;
+        b->cap = b->cap ? 2 * b->cap : 64 * 1024;
+        if (n >= 0 && b->cap < b->len + (size_t)n + 1) b->cap = b->len + (size_t)n + 1;
+        b->data = (char*)xrealloc(b->data, b->cap);
+    }
+    b->len += (size_t)n;
+}
+
+/* Operands of a value: a and b, or both factors of every term of a dot product */
+static int operand_count(const ir_value_t *x) {
+    if (x->op == IR_DOT) return 2 * x->nterms;
+    return x->b >= 0 ? 2 : x->a >= 0 ? 1 : 0;
+}
+
+static int operand_at(const ir_value_t *x, int i) {
+    if (x->op == IR_DOT) return (i & 1) ? x->terms[i >> 1].b : x->terms[i >> 1].a;
+    return i ? x->b : x->a;
+}
+
+
+static int torch_enabled = 0;
+
+void ir_set_torch(int enabled) {
+    torch_enabled = enabled;
+}
+
+/* Liveness: operands always have smaller ids than their users, so one
+ * backward sweep from the declared values finds everything needed and
+ * counts the uses of each value (a declaration counts as a use). PyTorch
+ * extensions print nothing: only arrays are needed there, then the quires
+ * needed code reads, and ir_emit counts the scalar declarations it reads.
+ */
+static void compute_liveness(char *live, int *uses) {
+    size_t s;
+    int v, i, changed;
+    for (s = 0; s < symbol_count; s++)
+        if (symbols[s].quire) symbols[s].read = !torch_enabled;
+    do {
+        memset(live, 0, value_count);
+        memset(uses, 0, value_count * sizeof(int));
+        for (s = 0; s < stmt_count; s++) {
+            if (stmts[s].type_name || (stmts[s].quire >= 0 && !symbols[stmts[s].quire].read)) continue;
+            /* an accumulation uses the factors of its products */
+            for (i = 0; i < 2 * stmts[s].nterms; i++) {
+                int w = (i & 1) ? stmts[s].terms[i >> 1].b : stmts[s].terms[i >> 1].a;
+                live[w] = 1;
+                uses[w]++;
+            }
+            if (stmts[s].quire >= 0 || (torch_enabled && stmts[s].array < 0)) continue;
+            live[stmts[s].value] = 1;
+            uses[stmts[s].value]++;
+        }
+        for (v = (int)value_count - 1; v >= 0; v--) {
+            if (!live[v] || !is_computed(v)) continue;
+            for (i = 0; i < operand_count(&values[v]); i++) {
+                live[operand_at(&values[v], i)] = 1;
+                uses[operand_at(&values[v], i)]++;
+            }
+        }
+        /* a quire read by live code needs its accumulations, sweep again */
+        changed = 0;
+        for (v = 0; v < (int)value_count; v++) {
+            if (!live[v] || values[v].op != IR_QUIRE || symbols[values[v].array].read) continue;
+            symbols[values[v].array].read = 1;
+            changed = 1;
+        }
+    } while (changed);
+}
+
+static int contract_enabled = 1;
+
+void ir_set_contract(int enabled) {
+    contract_enabled = enabled;
+}
+
+/* Contraction: a tree of additions and subtractions whose inner nodes have no
+ * other use is flattened into +-a*b terms, other leaves becoming x*1, and
+ * evaluated as one dot product. Uses of declared variables (IR_NAME) hold
+ * rounded values and stay leaves. Quire declarations are always flattened,
+ * through shared subexpressions too.
+ */
+static void contract(const char *live, const int *uses, const char *fused) {
+    ir_term_t *terms = NULL;
+    int *stack = NULL;
+    char *inner_sum = (char*)calloc(value_count + 1, 1);
+    size_t cap = 0;
+    int v, i;
+    /* sums only used by another sum are flattened with it, not on their own */
+    for (v = 0; v < (int)value_count; v++) {
+        if (!live[v] || values[v].varying || (values[v].op != IR_ADD && values[v].op != IR_SUB)) continue;
+        for (i = 0; i < 2; i++) {
+            int w = operand_at(&values[v], i);
+            if (uses[w] == 1) inner_sum[w] = 1;
+        }
+    }
+    for (v = 0; v < (int)value_count; v++) {
+        const ir_value_t *x = &values[v];
+        size_t nterms = 0, depth = 0;
+        int products = 0, one;
+        /* a lone product is rounded once already; array code has no fused operations */
+        if (!live[v] || x->varying || (x->op != IR_ADD && x->op != IR_SUB)) continue;
+        if (!fused[v] && (!contract_enabled || inner_sum[v])) continue;
+        one = make_const(x->type, one_bits(x->type));
+        x = &values[v];
+        /* explicit stack of (value, negated) pairs */
+        if (cap < 2) {
+            cap = 64;
+            stack = (int*)xrealloc(stack, 2 * cap * sizeof(int));
+            terms = (ir_term_t*)xrealloc(terms, cap * sizeof(ir_term_t));
+        }
+        stack[depth++] = v;
+        stack[depth++] = 0;
+        while (depth > 0) {
+            int neg = stack[--depth], w = stack[--depth];
+            const ir_value_t *y = &values[w];
+            int inner = w == v || fused[v] || uses[w] == 1;
+            while (depth + 4 > 2 * cap || nterms + (size_t)y->nterms + 1 > cap) {
+                cap *= 2;
+                stack = (int*)xrealloc(stack, 2 * cap * sizeof(int));
+                terms = (ir_term_t*)xrealloc(terms, cap * sizeof(ir_term_t));
+            }
+            if (inner && y->op == IR_DOT) {
+                /* a shared sum contracted before */
+                for (i = 0; i < y->nterms; i++) {
+                    terms[nterms] = y->terms[i];
+                    terms[nterms].neg ^= neg;
+                    products += values[y->terms[i].b].op != IR_CONST || values[y->terms[i].b].bits != values[one].bits;
+                    nterms++;
+                }
+            } else if (inner && (y->op == IR_ADD || y->op == IR_SUB)) {
+                stack[depth++] = y->b;
+                stack[depth++] = neg ^ (y->op == IR_SUB);
+                stack[depth++] = y->a;
+                stack[depth++] = neg;
+            } else if (y->op == IR_MUL) {
+                terms[nterms].a = y->a;
+                terms[nterms].b = y->b;
+                terms[nterms].neg = neg;
+                nterms++;
+                products++;
+            } else {
+                terms[nterms].a = w;
+                terms[nterms].b = one;
+                terms[nterms].neg = neg;
+                nterms++;
+            }
+        }
+        /* a plain sum keeps its additions unless a quire is asked for */
+        if (products == 0 && !fused[v]) continue;
+        values[v].op = IR_DOT;
+        values[v].a = values[v].b = -1;
+        values[v].nterms = (int)nterms;
+        values[v].terms = (ir_term_t*)arena_alloc(nterms * sizeof(ir_term_t));
+        memcpy((void*)values[v].terms, terms, nterms * sizeof(ir_term_t));
+    }
+    free(stack);
+    free(terms);
+    free(inner_sum);
+}
+
+/* Constant folding with the runtime's own correctly rounded operations, so a
+ * folded value is bit-identical to the one the program would compute
+ */
+static void fold_constants(void) {
+    int v, i;
+    for (v = 0; v < (int)value_count; v++) {
+        ir_value_t *x = &values[v];
+        int n = operand_count(x);
+        uint32_t z = 0;
+        /* a quire read has no operands, but is only known at run time */
+        if (!is_computed(v) || x->op == IR_QUIRE) continue;
+        for (i = 0; i < n; i++)
+            if (values[operand_at(x, i)].op != IR_CONST) break;
+        if (i < n) continue;
+        if (x->op == IR_NAME) {
+            z = values[x->a].bits;
+        } else if (x->op == IR_CONVERT) {
+            z = convert_bits(values[x->a].bits, values[x->a].type, x->type);
+        } else if (x->op == IR_DOT) {
+            posit32 *fa = (posit32*)xrealloc(NULL, (size_t)x->nterms * sizeof(posit32));
+            posit32 *fb = (posit32*)xrealloc(NULL, (size_t)x->nterms * sizeof(posit32));
+            for (i = 0; i < x->nterms; i++) {
+                fa[i] = values[x->terms[i].a].bits;
+                fb[i] = values[x->terms[i].b].bits;
+                if (x->terms[i].neg) fb[i] = (posit32)-fb[i];
+            }
+            if (x->type == TYPE_POSIT32) {
+                z = quire32_dot(fa, fb, (size_t)x->nterms);
+            } else if (x->type == TYPE_POSIT16) {
+                posit16 *ga = (posit16*)xrealloc(NULL, (size_t)x->nterms * sizeof(posit16));
+                posit16 *gb = (posit16*)xrealloc(NULL, (size_t)x->nterms * sizeof(posit16));
+                posit16 r = 0;
+                for (i = 0; i < x->nterms; i++) {
+                    ga[i] = (posit16)fa[i];
+                    gb[i] = (posit16)fb[i];
+                }
+                posit16_dot_n(&r, ga, gb, (size_t)x->nterms);
+                z = r;
+                free(ga);
+                free(gb);
+            } else {
+                posit8 *ga = (posit8*)xrealloc(NULL, (size_t)x->nterms), *gb = (posit8*)xrealloc(NULL, (size_t)x->nterms);
+                posit8 r = 0;
+                for (i = 0; i < x->nterms; i++) {
+                    ga[i] = (posit8)fa[i];
+                    gb[i] = (posit8)fb[i];
+                }
+                posit8_dot_n(&r, ga, gb, (size_t)x->nterms);
+                z = r;
+                free(ga);
+                free(gb);
+            }
+            free(fa);
+            free(fb);
+        } else if (x->type == TYPE_POSIT32) {
+            posit32 p = (posit32)values[x->a].bits, q = (posit32)values[x->b].bits, r = 0;
+            switch (x->op) {
+            case IR_ADD: posit32_add(&r, p, q); break;
+            case IR_SUB: posit32_sub(&r, p, q); break;
+            case IR_MUL: posit32_mul(&r, p, q); break;
+            default: posit32_div(&r, p, q); break;
+            }
+            z = r;
+        } else if (x->type == TYPE_POSIT16) {
+            posit16 p = (posit16)values[x->a].bits, q = (posit16)values[x->b].bits, r = 0;
+            switch (x->op) {
+            case IR_ADD: posit16_add(&r, p, q); break;
+            case IR_SUB: posit16_sub(&r, p, q); break;
+            case IR_MUL: posit16_mul(&r, p, q); break;
+            default: posit16_div(&r, p, q); break;
+            }
+            z = r;
+        } else {
+            posit8 p = (posit8)values[x->a].bits, q = (posit8)values[x->b].bits;
+            switch (x->op) {
+            case IR_ADD: z = posit8_add_v(p, q); break;
+            case IR_SUB: z = posit8_sub_v(p, q); break;
+            case IR_MUL: z = posit8_mul_v(p, q); break;
+            default: z = posit8_div_v(p, q); break;
+            }
+        }
+        x->op = IR_CONST;
+        x->a = x->b = -1;
+        x->bits = z;
+        x->terms = NULL;
+        x->nterms = 0;
+    }
+}
+
+/* Precision selection. Interval analysis gives every value the range of its
+ * exact result for inputs within their ranges, and a first-order forward
+ * analysis bounds how far the computed value can be from it, given the type
+ * each operation rounds to. Operations start out as posit8; while a declared
+ * value misses the bound, the operation contributing most error to it is
+ * widened. The search stops at uses of variables: when nothing left in a
+ * statement can be widened, the variables it reads are given a tighter bound
+ * and the next round widens their statements instead.
+ */
+#define PRECISION_ROUNDS 8
+
+void ir_set_error_bound(double bound) {
+    error_bound = bound;
+}
+
+typedef struct {
+    double lo, hi;
+} interval_t;
+
+typedef struct {
+    interval_t range;       /* of the exact value */
+    double error;           /* bound on |computed - exact| */
+    double local;           /* the part of error added by this operation's roundings */
+    double limit;           /* bound asked for by statements reading the variable */
+    double gain;            /* error of the statement being widened per unit of error here */
+    posit_type_t type;      /* operations: the type rounded to */
+    unsigned cone;
+    int recurrent;          /* element possibly written by an earlier iteration of its loop */
+} precision_t;
+
+static precision_t *prec = NULL;
+static const posit_type_t widest_type = TYPE_POSIT32;
+
+static const interval_t unbounded = {-HUGE_VAL, HUGE_VAL};
+
+static interval_t type_range(posit_type_t type) {
+    interval_t r;
+    r.hi = ldexp(1.0, type_max_scale(type));
+    r.lo = -r.hi;
+    return r;
+}
+
+static double magnitude(interval_t x) {
+    return fmax(fabs(x.lo), fabs(x.hi));
+}
+
+static double min_magnitude(interval_t x) {
+    return x.lo <= 0.0 && x.hi >= 0.0 ? 0.0 : fmin(fabs(x.lo), fabs(x.hi));
+}
+
+/* Largest rounding error of type on values of magnitude up to m: half the
+ * spacing of the binade holding m, which widens as the regime grows
+ */
+static double rounding_error(posit_type_t type, double m) {
+    int max_scale = type_max_scale(type), es = type_es(type), scale, k, fraction;
+    if (m == 0.0) return 0.0;
+    /* saturated at maxpos */
+    if (!(m <= ldexp(1.0, max_scale))) return HUGE_VAL;
+    frexp(m, &scale);
+    scale--;
+    /* everything below minpos rounds to minpos */
+    if (scale < -max_scale) return ldexp(1.0, -max_scale);
+    k = scale >= 0 ? scale >> es : -((((1 << es) - 1) - scale) >> es);
+    fraction = type_bits(type) - 1 - (k >= 0 ? k + 2 : 1 - k) - es;
+    /* with exponent bits cut off, neighbours are a factor of 2^(2^cut) apart */
+    return fraction >= 0 ? ldexp(1.0, scale - fraction - 1) : ldexp(1.0, scale + (1 << -fraction) - 1);
+}
+
+static double rounded(posit_type_t type, double x) {
+    return posit_value(type, encode_bits(type, x));
+}
+
+static interval_t interval_of(ir_op_t op, interval_t a, interval_t b) {
+    interval_t r;
+    double p[4];
+    int i;
+    if (op == IR_ADD) {
+        r.lo = a.lo + b.lo;
+        r.hi = a.hi + b.hi;
+    } else if (op == IR_SUB) {
+        r.lo = a.lo - b.hi;
+        r.hi = a.hi - b.lo;
+    } else {
+        if (op == IR_DIV) {
+            double lo = b.lo;
+            if (b.lo <= 0.0 && b.hi >= 0.0) return unbounded;
+            b.lo = 1.0 / b.hi;
+            b.hi = 1.0 / lo;
+        }
+        p[0] = a.lo * b.lo;
+        p[1] = a.lo * b.hi;
+        p[2] = a.hi * b.lo;
+        p[3] = a.hi * b.hi;
+        r.lo = r.hi = p[0];
+        for (i = 1; i < 4; i++) {
+            r.lo = fmin(r.lo, p[i]);
+            r.hi = fmax(r.hi, p[i]);
+        }
+    }
+    /* inf - inf and 0 * inf */
+    if (isnan(r.lo) || isnan(r.hi)) return unbounded;
+    return r;
+}
+
+/* The type a value is held in: a use of a variable in the variable's */
+static posit_type_t held_type(int v) {
+    if (values[v].op == IR_NAME) v = values[v].a;
+    return is_operation(v) ? prec[v].type : values[v].type;
+}
+
+/* Error of operand k read in type, with the rounding of a narrowing conversion */
+static double operand_error(int k, posit_type_t type) {
+    if (type_bits(type) >= type_bits(held_type(k))) return prec[k].error;
+    if (values[k].op == IR_CONST)
+        return fabs(posit_value(values[k].type, values[k].bits) - posit_value(type, convert_bits(values[k].bits, values[k].type, type)));
+    return prec[k].error + rounding_error(type, magnitude(prec[k].range) + prec[k].error);
+}
+
+/* s * e, where an exact operand stays exact whatever its weight */
+static double weighted(double s, double e) {
+    return e == 0.0 ? 0.0 : s * e;
+}
+
+/* d(error of v)/d(error of its operands a and b) */
+static void sensitivities(int v, double *da, double *db) {
+    const ir_value_t *x = &values[v];
+    double ea = operand_error(x->a, prec[v].type), eb = operand_error(x->b, prec[v].type);
+    double ma = magnitude(prec[x->a].range), mb = magnitude(prec[x->b].range), d;
+    *da = *db = 1.0;
+    if (x->op == IR_MUL) {
+        *da = mb + eb;
+        *db = ma + ea;
+    } else if (x->op == IR_DIV) {
+        d = min_magnitude(prec[x->b].range) - eb;
+        *da = d > 0.0 ? 1.0 / d : HUGE_VAL;
+        *db = d > 0.0 ? (ma + ea) / (min_magnitude(prec[x->b].range) * d) : HUGE_VAL;
+    }
+}
+
+static void update_error(int v) {
+    const ir_value_t *x = &values[v];
+    precision_t *p = &prec[v];
+    double ea, eb, da, db, carried;
+    if (x->op == IR_NAME) {
+        p->error = prec[x->a].error;
+        return;
+    }
+    if (x->op == IR_CONVERT) {
+        p->error = operand_error(x->a, p->type);
+        p->local = p->error - prec[x->a].error;
+        return;
+    }
+    /* leaves, and quire reads: set by propagate_errors */
+    if (!is_operation(v)) return;
+    ea = operand_error(x->a, p->type);
+    eb = operand_error(x->b, p->type);
+    sensitivities(v, &da, &db);
+    if (x->op == IR_ADD || x->op == IR_SUB) {
+        carried = ea + eb;
+    } else if (x->op == IR_MUL) {
+        carried = weighted(magnitude(prec[x->b].range), ea) + weighted(magnitude(prec[x->a].range), eb) + ea * eb;
+    } else {
+        carried = weighted(da, ea) + weighted(db, eb);
+    }
+    if (isnan(carried)) carried = HUGE_VAL;
+    if (carried == 0.0 && p->range.lo == p->range.hi)
+        /* an exact result known at compile time: the rounding is known too */
+        p->error = fabs(rounded(p->type, p->range.lo) - p->range.lo);
+    else
+        p->error = carried + rounding_error(p->type, magnitude(p->range) + carried);
+    /* what widening this operation could remove: its rounding and its operands' */
+    p->local = p->error - weighted(da, prec[x->a].error) - weighted(db, prec[x->b].error);
+    if (isnan(p->local) || p->local < 0.0) p->local = isnan(p->local) ? HUGE_VAL : 0.0;
+}
+
+/* Ranges of the exact values, statement by statement: an element of an array
+ * is within everything written to the array before it is read, and a quire
+ * holds the sum of what was accumulated into it. A loop that may read what it
+ * wrote in an earlier iteration is not followed around; the elements it reads
+ * that way are only known to be within their type.
+ */
+static void compute_ranges(void) {
+    interval_t *contents = (interval_t*)xrealloc(NULL, (symbol_count + 1) * sizeof(interval_t));
+    char *filled = (char*)calloc(symbol_count + 1, 1);
+    size_t s, t, v, begin = 0;
+    for (v = 0; v < symbol_count; v++) {
+        const ir_symbol_t *x = &symbols[v];
+        contents[v] = type_range(x->type);
+        filled[v] = x->input;
+        if (x->quire) contents[v].lo = contents[v].hi = 0.0;
+        if (x->value < 0 && x->ranged) {
+            contents[v].lo = x->lo;
+            contents[v].hi = x->hi;
+        }
+    }
+    for (s = 0; s < stmt_count; s++) {
+        for (v = begin; v < stmts[s].value_end; v++) {
+            const ir_value_t *x = &values[v];
+            precision_t *p = &prec[v];
+            int found;
+            switch (x->op) {
+            case IR_CONST:
+                p->range.lo = p->range.hi = posit_value(x->type, x->bits);
+                if (isnan(p->range.lo)) p->range = unbounded;
+                break;
+            case IR_INPUT:
+                found = find_symbol(x->name);
+                p->range = type_range(x->type);
+                if (found >= 0 && symbols[found].value == (int)v && symbols[found].ranged) {
+                    p->range.lo = symbols[found].lo;
+                    p->range.hi = symbols[found].hi;
+                }
+                break;
+            case IR_ELEM:
+                p->range = contents[x->array];
+                for (t = s; t < stmt_count && stmts[t].array >= 0 && stmts[t].loop == x->loop; t++)
+                    if (stmts[t].array == x->array && stmts[t].offset > x->offset) p->recurrent = 1;
+                if (p->recurrent) p->range = type_range(x->type);
+                break;
+            case IR_QUIRE:
+                p->range = contents[x->array];
+                break;
+            case IR_CONVERT:
+            case IR_NAME:
+                p->range = prec[x->a].range;
+                break;
+            default:
+                p->range = interval_of(x->op, prec[x->a].range, prec[x->b].range);
+                break;
+            }
+        }
+        begin = stmts[s].value_end;
+        for (t = 0; t < (size_t)stmts[s].nterms; t++) {
+            const ir_term_t *term = &stmts[s].terms[t];
+            interval_t r = interval_of(IR_MUL, prec[term->a].range, prec[term->b].range);
+            interval_t *q = &contents[stmts[s].quire];
+            q->lo += term->neg ? -r.hi : r.lo;
+            q->hi += term->neg ? -r.lo : r.hi;
+        }
+        if (stmts[s].array >= 0) {
+            /* an array keeps the first contents it is written, then the hull of all of them */
+            interval_t r = prec[stmts[s].value].range, bound = type_range(stmts[s].type);
+            r.lo = fmin(fmax(r.lo, bound.lo), bound.hi);
+            r.hi = fmax(fmin(r.hi, bound.hi), bound.lo);
+            if (filled[stmts[s].array]) {
+                r.lo = fmin(r.lo, contents[stmts[s].array].lo);
+                r.hi = fmax(r.hi, contents[stmts[s].array].hi);
+            }
+            contents[stmts[s].array] = r;
+            filled[stmts[s].array] = 1;
+        }
+    }
+    free(contents);
+    free(filled);
+}
+
+/* Error of the value statement s stores, and the most it may have */
+static double stored_error(size_t s) {
+    return stmts[s].array >= 0 ? operand_error(stmts[s].value, stmts[s].type) : prec[stmts[s].value].error;
+}
+
+static double stored_limit(size_t s) {
+    return fmin(error_bound * fmax(1.0, magnitude(prec[stmts[s].value].range)), prec[stmts[s].value].limit);
+}
+
+/* Errors with the types chosen so far, statement by statement as for ranges.
+ * A quire adds the products of its factors' errors without rounding them, and
+ * reading it rounds once to posit32.
+ */
+static void propagate_errors(void) {
+    double *written = (double*)calloc(symbol_count + 1, sizeof(double));
+    size_t s, v, begin = 0;
+    int t;
+    for (s = 0; s < stmt_count; s++) {
+        for (v = begin; v < stmts[s].value_end; v++) {
+            const ir_value_t *x = &values[v];
+            if (x->op == IR_ELEM)
+                prec[v].error = prec[v].recurrent ? HUGE_VAL : written[x->array];
+            else if (x->op == IR_QUIRE)
+                prec[v].error = written[x->array] + rounding_error(TYPE_POSIT32, magnitude(prec[v].range) + written[x->array]);
+            else
+                update_error((int)v);
+        }
+        begin = stmts[s].value_end;
+        for (t = 0; t < stmts[s].nterms; t++) {
+            const ir_term_t *term = &stmts[s].terms[t];
+            double ea = prec[term->a].error, eb = prec[term->b].error;
+            written[stmts[s].quire] += weighted(magnitude(prec[term->b].range), ea) +
+                                       weighted(magnitude(prec[term->a].range), eb) + ea * eb;
+        }
+        if (stmts[s].array >= 0) written[stmts[s].array] = fmax(written[stmts[s].array], stored_error(s));
+    }
+    free(written);
+}
+
+static int compare_ids(const void *x, const void *y) {
+    return *(const int*)x - *(const int*)y;
+}
+
+/* The values statement s computes without going through a variable, in
+ * increasing id order (walk_elems), with the gain of each
+ */
+static size_t precision_cone(size_t s) {
+    size_t depth = 0, count = 0, i;
+    int j;
+    find_elements(-1);  /* sizes the walk arrays and takes a fresh stamp */
+    walk_stack[depth++] = stmts[s].value;
+    while (depth > 0) {
+        int v = walk_stack[--depth];
+        if (walk_mark[v] == walk_stamp) continue;
+        walk_mark[v] = walk_stamp;
+        prec[v].gain = 0.0;
+        if (depth + 2 > walk_cap || count + 1 > walk_cap) {
+            walk_cap *= 2;
+            walk_stack = (int*)xrealloc(walk_stack, walk_cap * sizeof(int));
+            walk_elems = (int*)xrealloc(walk_elems, walk_cap * sizeof(int));
+        }
+        walk_elems[count++] = v;
+        if (!is_operation(v)) continue;
+        for (j = 0; j < operand_count(&values[v]); j++) walk_stack[depth++] = operand_at(&values[v], j);
+    }
+    /* operands have smaller ids: gains flow from the value down */
+    qsort(walk_elems, count, sizeof(int), compare_ids);
+    prec[stmts[s].value].gain = 1.0;
+    for (i = count; i-- > 0;) {
+        int v = walk_elems[i];
+        double da, db;
+        if (!is_operation(v)) continue;
+        if (values[v].op == IR_CONVERT) {
+            prec[values[v].a].gain += prec[v].gain;
+            continue;
+        }
+        sensitivities(v, &da, &db);
+        prec[values[v].a].gain += weighted(da, prec[v].gain);
+        prec[values[v].b].gain += weighted(db, prec[v].gain);
+    }
+    return count;
+}
+
+/* Uses of variables the quire reads among the count values of statement s's
+ * cone accumulated before it, with their gains: the magnitude of the other
+ * factor of their product times the gain of the read
+ */
+static int *fed_names = NULL;
+static double *fed_gains = NULL;
+static size_t fed_cap = 0;
+
+static size_t quire_fed(size_t s, size_t count) {
+    size_t i, t, n = 0;
+    int k;
+    for (i = 0; i < count; i++) {
+        const ir_value_t *x = &values[walk_elems[i]];
+        double gain = prec[walk_elems[i]].gain;
+        if (x->op != IR_QUIRE || gain == 0.0) continue;
+        for (t = 0; t < s; t++) {
+            if (stmts[t].quire != x->array) continue;
+            for (k = 0; k < 2 * stmts[t].nterms; k++) {
+                const ir_term_t *term = &stmts[t].terms[k >> 1];
+                int f = (k & 1) ? term->b : term->a, other = (k & 1) ? term->a : term->b;
+                if (values[f].op == IR_CONVERT) f = values[f].a;
+                if (values[f].op != IR_NAME) continue;
+                if (n == fed_cap) {
+                    fed_cap = fed_cap ? 2 * fed_cap : 64;
+                    fed_names = (int*)xrealloc(fed_names, fed_cap * sizeof(int));
+                    fed_gains = (double*)xrealloc(fed_gains, fed_cap * sizeof(double));
+                }
+                fed_names[n] = f;
+                fed_gains[n++] = gain * magnitude(prec[other].range);
+            }
+        }
+    }
+    return n;
+}
+
+/* Ask the variable a use v reads for less error, unless it adds none */
+static int tighten(int v, double gain, double scale) {
+    double limit = prec[v].error * scale;
+    if (gain == 0.0 || prec[v].error == 0.0 || !(limit < prec[values[v].a].limit)) return 0;
+    prec[values[v].a].limit = limit;
+    return 1;
+}
+
+/* Widen the operation of statement s contributing most error. When none can
+ * be, -1 if the variables it reads, directly or through quires, were asked
+ * for less error, else 0.
+ */
+static int widen_statement(size_t s) {
+    size_t count = precision_cone(s), i;
+    int best = -1, root = stmts[s].value;
+    double most = 0.0;
+    for (i = 0; i < count; i++) {
+        int v = walk_elems[i];
+        double contribution;
+        /* array code stops at posit16 */
+        if (!is_operation(v) || prec[v].type == (values[v].varying ? TYPE_POSIT16 : widest_type)) continue;
+        /* rounding twice on the way into an array gains nothing */
+        if (v == root && stmts[s].array >= 0 && type_bits(prec[v].type) >= type_bits(stmts[s].type)) continue;
+        contribution = weighted(prec[v].gain, prec[v].local);
+        if (contribution > most) {
+            most = contribution;
+            best = v;
+        }
+    }
+    if (best < 0) {
+        /* ask the variables read for less error, in proportion to what is missing,
+         * unless the statement misses the bound even with exact variables
+         */
+        double scale = stored_limit(s) / stored_error(s) / 2.0, own = stored_error(s);
+        size_t fed = quire_fed(s, count);
+        int tightened = 0;
+        for (i = 0; i < count; i++)
+            if (values[walk_elems[i]].op == IR_NAME) own -= weighted(prec[walk_elems[i]].gain, prec[walk_elems[i]].error);
+        for (i = 0; i < fed; i++) own -= weighted(fed_gains[i], prec[fed_names[i]].error);
+        if (!(own < stored_limit(s))) return 0;
+        for (i = 0; i < count; i++)
+            if (values[walk_elems[i]].op == IR_NAME) tightened |= tighten(walk_elems[i], prec[walk_elems[i]].gain, scale);
+        for (i = 0; i < fed; i++) tightened |= tighten(fed_names[i], fed_gains[i], scale);
+        return tightened ? -1 : 0;
+    }
+    prec[best].type = best == root && stmts[s].array >= 0 ? stmts[s].type : (posit_type_t)(prec[best].type + 1);
+    for (i = 0; i < count; i++)
+        if (values[walk_elems[i]].op != IR_ELEM) update_error(walk_elems[i]);
+    return 1;
+}
+
+/* Values rebuilt in their chosen types, with conversions where operands are
+ * held in another type. Statement by statement again, so that the values of a
+ * statement still come just before it.
+ */
+static void retype_values(void) {
+    int *map = (int*)xrealloc(NULL, (value_count + 1) * sizeof(int));
+    size_t s, v, begin = 0;
+    free(value_table.slots);
+    table_init(&value_table, 2048);
+    for (s = 0; s < stmt_count; s++) {
+        size_t end = stmts[s].value_end;
+        for (v = begin; v < end; v++) {
+            ir_value_t x = values[v];
+            int a, b;
+            if (x.op == IR_CONVERT) {
+                map[v] = ir_convert(map[x.a], prec[v].type);
+            } else if (x.op == IR_NAME) {
+                map[v] = make_value(IR_NAME, values[map[x.a]].type, map[x.a], -1, 0, NULL);
+            } else if (!is_operation((int)v)) {
+                map[v] = intern_value(&x);
+            } else {
+                a = ir_convert(map[x.a], prec[v].type);
+                b = ir_convert(map[x.b], prec[v].type);
+                if ((x.op == IR_ADD || x.op == IR_MUL) && a > b) {
+                    int t = a;
+                    a = b;
+                    b = t;
+                }
+                map[v] = make_value(x.op, prec[v].type, a, b, 0, NULL);
+            }
+        }
+        begin = end;
+        if (stmts[s].quire >= 0) {
+            /* the factors of accumulations are posit32 whatever they are held in */
+            ir_term_t *terms = stmts[s].nterms ? (ir_term_t*)arena_alloc((size_t)stmts[s].nterms * sizeof(ir_term_t)) : NULL;
+            int t;
+            for (t = 0; t < stmts[s].nterms; t++) {
+                terms[t] = stmts[s].terms[t];
+                terms[t].a = ir_convert(map[terms[t].a], TYPE_POSIT32);
+                terms[t].b = ir_convert(map[terms[t].b], TYPE_POSIT32);
+            }
+            stmts[s].terms = terms;
+        } else if (stmts[s].array >= 0) {
+            stmts[s].value = ir_convert(map[stmts[s].value], stmts[s].type);
+        } else if (!stmts[s].type_name) {
+            stmts[s].value = map[stmts[s].value];
+            stmts[s].type = values[stmts[s].value].type;
+        }
+        stmts[s].value_end = value_count;
+    }
+    free(map);
+}
+
+static void select_precision(void) {
+    size_t s, v;
+    int round, changed = 1, widened, t;
+    char *warned, *kept = (char*)calloc(value_count + 1, 1);
+    prec = (precision_t*)calloc(value_count + 1, sizeof(precision_t));
+    /* what quires accumulate keeps its declared types, operands first */
+    for (s = 0; s < stmt_count; s++)
+        for (t = 0; t < stmts[s].nterms; t++) kept[stmts[s].terms[t].a] = kept[stmts[s].terms[t].b] = 1;
+    for (v = value_count; v-- > 0;) {
+        prec[v].type = kept[v] ? values[v].type : TYPE_POSIT8;
+        prec[v].limit = HUGE_VAL;
+        if (!kept[v] || !is_operation((int)v)) continue;
+        for (t = 0; t < operand_count(&values[v]); t++) kept[operand_at(&values[v], t)] = 1;
+    }
+    free(kept);
+    compute_ranges();
+
+    for (round = 0; round < PRECISION_ROUNDS && changed; round++) {
+        changed = 0;
+        propagate_errors();
+        for (s = 0; s < stmt_count; s++) {
+            if (stmts[s].type_name || stmts[s].quire >= 0) continue;
+            while (stored_error(s) > stored_limit(s)) {
+                widened = widen_statement(s);
+                /* a tighter bound on a variable read is met in the next round */
+                if (widened != 0) changed = 1;
+                if (widened <= 0) break;
+            }
+        }
+    }
+    propagate_errors();
+    warned = (char*)calloc(symbol_count + 1, 1);
+    for (s = 0; s < stmt_count; s++) {
+        if (stmts[s].type_name || stmts[s].quire >= 0 || (stmts[s].array >= 0 && warned[stmts[s].array])) continue;
+        if (stored_error(s) <= error_bound * fmax(1.0, magnitude(prec[stmts[s].value].range))) continue;
+        fprintf(stderr, "Warning: %s may be off by more than the error bound\n", stmts[s].name);
+        if (stmts[s].array >= 0) warned[stmts[s].array] = 1;
+    }
+    free(warned);
+    retype_values();
+    free(prec);
+    prec = NULL;
+}
+
+/* Emission state: the C operand naming each value, remaining uses and the
+ * temporary holding it. Temporaries of each C type are pooled and a temporary
+ * is reused as soon as the last use of its value has been emitted. Array code
+ * keeps its intermediate results in block temporaries of BLOCK elements.
+ */
+#define BLOCK 256
+/* statements fused into one blocked loop at most, unless one loop has more */
+#define FUSE_MAX 64
+/* indices per task of at::parallel_for in PyTorch extensions */
+#define GRAIN 2048
+
+/* scalar kinds in the order of posit_type_t */
+enum { KIND_POSIT8, KIND_POSIT16, KIND_POSIT32, KIND_DOUBLE, KIND_BLOCK8, KIND_BLOCK16, KIND_FLOATS, KIND_COUNT };
+static const char *kind_names[KIND_COUNT] = {"posit8", "posit16", "posit32", "double", "posit8", "posit16", "float"};
+
+typedef struct {
+    const char **code;
+    const char **broadcast; /* block temporary filled with a uniform value */
+    int *uses;
+    int *same;              /* an equal value an earlier statement of the group computes, or -1 */
+    int *written;           /* the statement of the group that last wrote each array, or -1 */
+    int *temp;
+    int *temp_kind;
+    size_t temp_count;
+    int *pool[KIND_COUNT];
+    size_t pool_len[KIND_COUNT];
+    int block;              /* array elements are addressed a block at a time */
+    size_t local_base;      /* temporaries from here on are declared in a parallel loop body */
+    const char *indent;
+    buffer_t body;
+} emitter_t;
+
+static int temp_acquire(emitter_t *e, int kind) {
+    size_t i = e->pool_len[kind];
+    /* a parallel loop body only reuses its own temporaries */
+    while (i > 0 && (size_t)e->pool[kind][i - 1] < e->local_base) i--;
+    if (i > 0) {
+        int t = e->pool[kind][i - 1];
+        e->pool[kind][i - 1] = e->pool[kind][--e->pool_len[kind]];
+        return t;
+    }
+    e->temp_kind = (int*)xrealloc(e->temp_kind, (e->temp_count + 1) * sizeof(int));
+    e->temp_kind[e->temp_count] = kind;
+    return (int)e->temp_count++;
+}
+
+static void temp_release(emitter_t *e, int t) {
+    int kind = e->temp_kind[t];
+    e->pool[kind] = (int*)xrealloc(e->pool[kind], (e->pool_len[kind] + 1) * sizeof(int));
+    e->pool[kind][e->pool_len[kind]++] = t;
+}
+
+/* v, or the value of an earlier statement of its group that it reuses */
+static int shared(const emitter_t *e, int v) {
+    return e->same[v] >= 0 ? e->same[v] : v;
+}
+
+static const char *offset_text(int offset) {
+    if (offset == 0) return "";
+    return arena_printf(" %c %d", offset < 0 ? '-' : '+', offset < 0 ? -offset : offset);
+}
+
+static const char *const_text(posit_type_t type, uint32_t bits) {
+    return arena_printf("((%s)0x%0*X)", type_name(type), type_bits(type) / 4, bits);
+}
+
+/* PyTorch extensions keep arrays in float tensors, which hold every posit8
+ * and posit16 value exactly: an element is converted where it is first read
+ */
+static const char *tensor_element(emitter_t *e, int v) {
+    const ir_value_t *x = &values[v];
+    const char *elem = arena_printf("%s[idx%s]", x->name, offset_text(x->offset));
+    e->temp[v] = temp_acquire(e, KIND_POSIT8 + (int)x->type);
+    if (x->type == TYPE_POSIT8)
+        buf_printf(&e->body, "%st%d = posit8_from_double_v(%s);\n", e->indent, e->temp[v], elem);
+    else
+        buf_printf(&e->body, "%s%s_from_double(&t%d, %s);\n", e->indent, type_name(x->type), e->temp[v], elem);
+    return arena_printf("t%d", e->temp[v]);
+}
+
+static const char *operand(emitter_t *e, int v) {
+    v = shared(e, v);
+    if (e->code[v] == NULL) {
+        if (values[v].op == IR_CONST)
+            e->code[v] = const_text(values[v].type, values[v].bits);
+        else if (values[v].op == IR_INPUT)
+            e->code[v] = values[v].name;
+        else if (values[v].op == IR_ELEM && torch_enabled)
+            e->code[v] = tensor_element(e, v);
+        else if (values[v].op == IR_ELEM)
+            e->code[v] = arena_printf(e->block ? "%s + base%s" : "%s[idx%s]", values[v].name, offset_text(values[v].offset));
+    }
+    return e->code[v];
+}
+
+/* -v: negating a posit is the two's complement of its pattern */
+static const char *negated(emitter_t *e, int v, int neg) {
+    if (!neg) return operand(e, v);
+    if (values[v].op == IR_CONST)
+        return const_text(values[v].type, -values[v].bits & (uint32_t)(((uint64_t)1 << type_bits(values[v].type)) - 1));
+    return arena_printf("(%s)-%s", type_name(values[v].type), operand(e, v));
+}
+
+static void use_done(emitter_t *e, int v) {
+    v = shared(e, v);
+    if (--e->uses[v] == 0 && e->temp[v] >= 0) temp_release(e, e->temp[v]);
+}
+
+static int is_one(int v) {
+    return values[v].op == IR_CONST && values[v].bits == one_bits(values[v].type);
+}
+
+/* Materialize v into dest, declared there if declare is set, or into a
+ * pooled temporary
+ */
+static void emit_value(emitter_t *e, int v, const char *dest, int declare) {
+    if (values[v].op == IR_NAME) {
+        /* the variable itself, nothing to compute */
+        e->code[v] = operand(e, values[v].a);
+        use_done(e, values[v].a);
+        return;
+    }
+
+    static const char *op_names[] = {"", "", "add", "sub", "mul", "div"};
+    const ir_value_t *x = &values[v];
+    const char *type = type_name(x->type);
+    buffer_t args = {NULL, 0, 0};
+    const char *fn;
+    int i;
+    /* posit16 and posit32 operations and dot products return through an out-parameter */
+    int out_param = x->type != TYPE_POSIT8 || (x->op == IR_DOT && x->nterms > 2);
+
+    if (x->op == IR_CONVERT) {
+        /* through double: posit16 and posit32 are decoded into a temporary below */
+        fn = x->type == TYPE_POSIT8 ? "posit8_from_double_v" : arena_printf("%s_from_double", type);
+        buf_printf(&args, values[x->a].type == TYPE_POSIT8 ? "posit8_to_double_v(%s)" : "%s", operand(e, x->a));
+    } else if (x->op == IR_QUIRE) {
+        /* the quire's contents so far, rounded once */
+        fn = "quire32_to_posit";
+        buf_printf(&args, "%s", x->name);
+    } else if (x->op == IR_DOT && x->nterms == 2 && (is_one(x->terms[0].b) || is_one(x->terms[1].b))) {
+        /* a*b + c: fused multiply-add */
+        const ir_term_t *p = is_one(x->terms[1].b) ? &x->terms[0] : &x->terms[1];
+        const ir_term_t *c = p == &x->terms[0] ? &x->terms[1] : &x->terms[0];
+        fn = x->type == TYPE_POSIT8 ? "posit8_fma_v" : arena_printf("%s_fma", type);
+        buf_printf(&args, "%s, %s, %s", negated(e, p->a, p->neg), operand(e, p->b), negated(e, c->a, c->neg));
+    } else if (x->op == IR_DOT) {
+        /* posit32 sums go through the quire32 of posit_sfp.h. C++ has no
+         * compound literals: the factors are initializer lists there
+         */
+        const char *open = torch_enabled ? "std::initializer_list<%s>{" : "(const %s[]){";
+        const char *close = torch_enabled ? "}.begin()" : "}";
+        out_param = x->type != TYPE_POSIT32;
+        fn = x->type == TYPE_POSIT32 ? "quire32_dot" : arena_printf("%s_dot_n", type);
+        buf_printf(&args, open, type);
+        for (i = 0; i < x->nterms; i++)
+            buf_printf(&args, "%s%s", i ? ", " : "", negated(e, x->terms[i].a, x->terms[i].neg));
+        buf_printf(&args, "%s, ", close);
+        buf_printf(&args, open, type);
+        for (i = 0; i < x->nterms; i++)
+            buf_printf(&args, "%s%s", i ? ", " : "", operand(e, x->terms[i].b));
+        buf_printf(&args, "%s, %d", close, x->nterms);
+    } else {
+        fn = x->type == TYPE_POSIT8 ? arena_printf("posit8_%s_v", op_names[x->op]) : arena_printf("%s_%s", type, op_names[x->op]);
+        buf_printf(&args, "%s, %s", operand(e, x->a), operand(e, x->b));
+    }
+
+    /* operands first, so that the result can reuse one of their temporaries */
+    for (i = 0; i < operand_count(x); i++) use_done(e, operand_at(x, i));
+    if (dest == NULL) {
+        e->temp[v] = temp_acquire(e, KIND_POSIT8 + (int)x->type);
+        dest = arena_printf("t%d", e->temp[v]);
+    }
+    e->code[v] = dest;
+
+    if (x->op == IR_CONVERT && values[x->a].type != TYPE_POSIT8) {
+        int d = temp_acquire(e, KIND_DOUBLE);
+        buf_printf(&e->body, "%s%s_to_double(&t%d, %s);\n", e->indent, type_name(values[x->a].type), d, args.data);
+        if (!out_param) {
+            buf_printf(&e->body, "%s%s%s%s = %s(t%d);\n", e->indent, declare ? type : "", declare ? " " : "", dest, fn, d);
+        } else {
+            if (declare) buf_printf(&e->body, "%s%s %s;\n", e->indent, type, dest);
+            buf_printf(&e->body, "%s%s(&%s, t%d);\n", e->indent, fn, dest, d);
+        }
+        temp_release(e, d);
+    } else if (out_param) {
+        if (declare) buf_printf(&e->body, "%s%s %s;\n", e->indent, type, dest);
+        buf_printf(&e->body, "%s%s(&%s, %s);\n", e->indent, fn, dest, args.data);
+    } else {
+        buf_printf(&e->body, "%s%s%s%s = %s(%s);\n", e->indent, declare ? type : "", declare ? " " : "", dest, fn, args.data);
+    }
+    free(args.data);
+}
+
+/* Array code operands: varying values are blocks, uniform ones broadcast */
+static const char *block_operand(emitter_t *e, int v) {
+    return values[v].varying ? operand(e, v) : e->broadcast[v];
+}
+
+/* v for the count elements of the current block, into dest or a block temporary */
+static void emit_block_value(emitter_t *e, int v, const char *dest) {
+    static const char *op_names[] = {"", "", "add", "sub", "mul", "div"};
+    const ir_value_t *x = &values[v];
+    const char *type = type_name(x->type);
+    const char *a = block_operand(e, x->a), *b = x->b >= 0 ? block_operand(e, x->b) : NULL;
+    int i;
+
+    /* the array functions allow the result to be one of the operands */
+    for (i = 0; i < operand_count(x); i++) use_done(e, operand_at(x, i));
+    if (dest == NULL) {
+        e->temp[v] = temp_acquire(e, x->type == TYPE_POSIT16 ? KIND_BLOCK16 : KIND_BLOCK8);
+        dest = arena_printf("t%d", e->temp[v]);
+    }
+    e->code[v] = dest;
+
+    if (x->op == IR_CONVERT) {
+        /* through float, which holds every posit8 and posit16 value exactly */
+        int f = temp_acquire(e, KIND_FLOATS);
+        buf_printf(&e->body, "%s%s_to_float_n(t%d, %s, count);\n", e->indent, type_name(values[x->a].type), f, a);
+        buf_printf(&e->body, "%s%s_from_float_n(%s, t%d, count);\n", e->indent, type, dest, f);
+        temp_release(e, f);
+    } else {
+        buf_printf(&e->body, "%s%s_%s_n(%s, %s, %s, count);\n", e->indent, type, op_names[x->op], dest, a, b);
+    }
+}
+
+static size_t stmt_begin(size_t s) {
+    return s ? stmts[s - 1].value_end : 0;
+}
+
+/* Statements first..end-1 of one iteration space or more, with the same range
+ * of indices, may run a block of indices at a time, statement by statement,
+ * when that reads and leaves the same elements as running them index by
+ * index: a read of an element an earlier statement writes must not look
+ * ahead of the write, a read of one a later statement (or the same one)
+ * writes must not look behind it, and of two writes to an array the later
+ * statement's must not look ahead of the earlier one's.
+ */
+static int can_block(size_t first, size_t end) {
+    size_t s, t, i, n;
+    for (s = first; s < end; s++) {
+        for (t = first; t < s; t++)
+            if (stmts[t].array == stmts[s].array && stmts[t].offset < stmts[s].offset) return 0;
+        n = find_elements(stmts[s].value);
+        for (i = 0; i < n; i++) {
+            const ir_value_t *x = &values[walk_elems[i]];
+            for (t = first; t < end; t++) {
+                if (stmts[t].array != x->array) continue;
+                if (t < s ? x->offset > stmts[t].offset : x->offset < stmts[t].offset) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/* Statements first..end-1 may also run index by index in any order of the
+ * indices, as threads of a parallel loop do, when every element one of them
+ * writes is written and read by the others at the same index only
+ */
+static int can_parallelize(size_t first, size_t end) {
+    size_t s, t, i, n;
+    for (s = first; s < end; s++) {
+        for (t = first; t < s; t++)
+            if (stmts[t].array == stmts[s].array && stmts[t].offset != stmts[s].offset) return 0;
+        n = find_elements(stmts[s].value);
+        for (i = 0; i < n; i++) {
+            const ir_value_t *x = &values[walk_elems[i]];
+            for (t = first; t < end; t++)
+                if (stmts[t].array == x->array && x->offset != stmts[t].offset) return 0;
+        }
+    }
+    return 1;
+}
+
+static int can_fuse(size_t first, size_t end) {
+    return torch_enabled ? can_parallelize(first, end) : can_block(first, end);
+}
+
+static size_t space_end(size_t s) {
+    size_t end = s + 1;
+    while (end < stmt_count && stmts[end].array >= 0 && stmts[end].loop == stmts[s].loop) end++;
+    return end;
+}
+
+/* Loop fusion: consecutive array statements over the same range become one
+ * blocked loop, or one parallel loop in PyTorch extensions. A loop that
+ * cannot (a recurrence such as x[i] = x[i - 1] + ...) runs index by index on
+ * its own.
+ */
+static void plan_groups(int *group_first, char *sequential) {
+    size_t s = 0, i;
+    for (i = 0; i < stmt_count; i++) group_first[i] = -1;
+    while (s < stmt_count) {
+        size_t end, next;
+        if (stmts[s].array < 0) {
+            s++;
+            continue;
+        }
+        end = space_end(s);
+        sequential[s] = !can_fuse(s, end);
+        while (!sequential[s] && end < stmt_count && end - s < FUSE_MAX && stmts[end].array >= 0 &&
+               stmts[end].lo == stmts[s].lo && stmts[end].hi == stmts[s].hi) {
+            next = space_end(end);
+            if (!can_fuse(s, next)) break;
+            end = next;
+        }
+        for (i = s; i < end; i++) group_first[i] = (int)s;
+        s = end;
+    }
+}
+
+/* The varying values statement s computes, except its own value */
+static void emit_statement_values(emitter_t *e, size_t s, const char *live) {
+    size_t i;
+    for (i = stmt_begin(s); i < stmts[s].value_end; i++) {
+        if (!live[i] || !values[i].varying || !is_computed((int)i) || e->code[i] != NULL || e->same[i] >= 0 ||
+            (int)i == stmts[s].value)
+            continue;
+        if (e->block) emit_block_value(e, (int)i, NULL);
+        else emit_value(e, (int)i, NULL, 0);
+    }
+}
+
+/* Whether statement s reads the array it writes at another index */
+static int reads_shifted(size_t s) {
+    size_t i, n = find_elements(stmts[s].value);
+    for (i = 0; i < n; i++)
+        if (values[walk_elems[i]].array == stmts[s].array && values[walk_elems[i]].offset != stmts[s].offset) return 1;
+    return 0;
+}
+
+/* Array code reads a uniform operand u from a block temporary filled once */
+static void broadcast(emitter_t *e, int u, long long fill, int *filled, size_t *nfilled) {
+    int t;
+    if (values[u].varying || e->broadcast[u] != NULL) return;
+    t = temp_acquire(e, values[u].type == TYPE_POSIT16 ? KIND_BLOCK16 : KIND_BLOCK8);
+    e->broadcast[u] = arena_printf("t%d", t);
+    filled[(*nfilled)++] = u;
+    filled[(*nfilled)++] = t;
+    buf_printf(&e->body, "    for (size_t k = 0; k < %lld; k++) t%d[k] = %s;\n", fill, t, operand(e, u));
+}
+
+static uint64_t element_hash(const emitter_t *e, const ir_value_t *x) {
+    uint64_t h = hash_mix((uint64_t)x->op, (uint64_t)x->type);
+    if (x->op == IR_CONVERT) return hash_mix(h, (uint64_t)(uint32_t)shared(e, x->a));
+    h = hash_mix(h, (uint64_t)(uint32_t)x->array);
+    h = hash_mix(h, (uint64_t)(uint32_t)x->version);
+    return hash_mix(h, (uint64_t)(uint32_t)x->offset);
+}
+
+static int element_equal(const emitter_t *e, const ir_value_t *x, const ir_value_t *y) {
+    if (x->op != y->op || x->type != y->type) return 0;
+    if (x->op == IR_CONVERT) return shared(e, x->a) == shared(e, y->a);
+    return x->array == y->array && x->version == y->version && x->offset == y->offset;
+}
+
+/* v reuses u: it is never emitted, and its uses become uses of u */
+static void share_value(emitter_t *e, int v, int u) {
+    int i;
+    for (i = 0; i < operand_count(&values[v]); i++) e->uses[shared(e, operand_at(&values[v], i))]--;
+    e->uses[u] += e->uses[v];
+    e->uses[v] = 0;
+    e->same[v] = u;
+}
+
+/* The statements of a group come from loops of their own, so each has its own
+ * values for the elements it reads. Over one range of indices, equal elements
+ * and their conversions are the same value: each is computed once per group,
+ * so an input block is converted once however many statements read it.
+ * PyTorch extensions keep arrays in float tensors: there an element an earlier
+ * statement of the group wrote is that statement's value, still in its posit
+ * temporary, rather than the float read back and converted again.
+ */
+static void share_elements(emitter_t *e, size_t first, size_t end, const char *live) {
+    size_t begin = stmt_begin(first), size = 16, s, v;
+    id_table_t seen;
+    while (size < 2 * (stmts[end - 1].value_end - begin)) size *= 2;
+    table_init(&seen, size);
+    for (s = first; s < end; s++) {
+        for (v = stmt_begin(s); v < stmts[s].value_end; v++) {
+            const ir_value_t *x = &values[v];
+            int w = x->op == IR_ELEM && torch_enabled ? e->written[x->array] : -1;
+            size_t i;
+            if (!live[v] || !x->varying || (x->op != IR_ELEM && x->op != IR_CONVERT)) continue;
+            if (w >= 0 && stmts[w].offset == x->offset && values[shared(e, stmts[w].value)].type == x->type) {
+                share_value(e, (int)v, shared(e, stmts[w].value));
+                continue;
+            }
+            i = element_hash(e, x) & seen.mask;
+            for (; seen.slots[i] >= 0; i = (i + 1) & seen.mask)
+                if (element_equal(e, &values[seen.slots[i]], x)) break;
+            if (seen.slots[i] >= 0) share_value(e, (int)v, seen.slots[i]);
+            else seen.slots[i] = (int)v;
+        }
+        e->written[stmts[s].array] = (int)s;
+    }
+    for (s = first; s < end; s++) e->written[stmts[s].array] = -1;
+    free(seen.slots);
+}
+
+/* Statements first..end-1, all over lo <= index < hi */
+static void emit_group(emitter_t *e, size_t first, size_t end, int sequential, const char *live) {
+    long long lo = stmts[first].lo, hi = stmts[first].hi;
+    long long fill = hi - lo < BLOCK ? hi - lo : BLOCK;
+    int *filled = NULL;
+    size_t nfilled = 0, s, i;
+    int j;
+
+    share_elements(e, first, end, live);
+    if (sequential) {
+        buf_printf(&e->body, "    for (size_t idx = %lld; idx < %lld; idx++) {\n", lo, hi);
+    } else {
+        e->block = 1;
+        /* (value, temporary) pairs: at most two operands per value and the stored values */
+        filled = (int*)xrealloc(NULL, 2 * (2 * (stmts[end - 1].value_end - stmt_begin(first)) + end - first) * sizeof(int));
+        for (s = first; s < end; s++) {
+            for (i = stmt_begin(s); i < stmts[s].value_end; i++) {
+                if (!live[i] || !values[i].varying || !is_computed((int)i) || e->same[i] >= 0) continue;
+                for (j = 0; j < operand_count(&values[i]); j++) broadcast(e, operand_at(&values[i], j), fill, filled, &nfilled);
+            }
+            broadcast(e, stmts[s].value, fill, filled, &nfilled);
+        }
+        buf_printf(&e->body, "    for (size_t base = %lld; base < %lld; base += %d) {\n", lo, hi, BLOCK);
+        buf_printf(&e->body, "        size_t count = %lld - base < %d ? %lld - base : %d;\n", hi, BLOCK, hi, BLOCK);
+    }
+    e->indent = "        ";
+
+    for (s = first; s < end; s++) {
+        int r = shared(e, stmts[s].value);
+        const char *type = type_name(stmts[s].type);
+        const char *target = arena_printf(e->block ? "%s + base%s" : "%s[idx%s]", stmts[s].name, offset_text(stmts[s].offset));
+        emit_statement_values(e, s, live);
+        if (values[r].varying && is_computed(r) && e->code[r] == NULL && e->uses[r] == 1 && !(e->block && reads_shifted(s))) {
+            /* computed straight into the array */
+            if (e->block) emit_block_value(e, r, target);
+            else emit_value(e, r, target, 0);
+        } else {
+            if (values[r].varying && is_computed(r) && e->code[r] == NULL) {
+                if (e->block) emit_block_value(e, r, NULL);
+                else emit_value(e, r, NULL, 0);
+            }
+            if (e->block)
+                buf_printf(&e->body, "        memmove(%s, %s, count * sizeof(%s));\n", target, block_operand(e, r), type);
+            else
+                buf_printf(&e->body, "        %s = %s;\n", target, operand(e, r));
+        }
+        use_done(e, r);
+    }
+
+    buf_printf(&e->body, "    }\n");
+    e->indent = "    ";
+    e->block = 0;
+    for (i = 0; i < nfilled; i += 2) {
+        e->broadcast[filled[i]] = NULL;
+        temp_release(e, filled[i + 1]);
+    }
+    free(filled);
+}
+
+/* Statements first..end-1 of a PyTorch extension, index by index with the
+ * elements converted from and to the float tensors. A parallel loop declares
+ * its temporaries in its body, so that every thread has its own.
+ */
+static void emit_tensor_group(emitter_t *e, size_t first, size_t end, int sequential, const char *live) {
+    buffer_t outer = e->body;
+    size_t s, t;
+    int kind;
+
+    memset(&e->body, 0, sizeof(e->body));
+    share_elements(e, first, end, live);
+    if (!sequential) e->local_base = e->temp_count;
+    e->indent = sequential ? "        " : "            ";
+    for (s = first; s < end; s++) {
+        int r = shared(e, stmts[s].value);
+        const char *target = arena_printf("%s[idx%s]", stmts[s].name, offset_text(stmts[s].offset));
+        emit_statement_values(e, s, live);
+        if (values[r].varying && is_computed(r) && e->code[r] == NULL) emit_value(e, r, NULL, 0);
+        if (stmts[s].type == TYPE_POSIT8)
+            buf_printf(&e->body, "%s%s = posit8_to_float_v(%s);\n", e->indent, target, operand(e, r));
+        else
+            buf_printf(&e->body, "%s%s_to_float(&%s, %s);\n", e->indent, type_name(stmts[s].type), target, operand(e, r));
+        use_done(e, r);
+    }
+
+    if (sequential) {
+        buf_printf(&outer, "    for (int64_t idx = %lld; idx < %lld; idx++) {\n", stmts[first].lo, stmts[first].hi);
+    } else {
+        buf_printf(&outer, "    at::parallel_for(%lld, %lld, %d, [&](int64_t begin, int64_t end) {\n",
+                   stmts[first].lo, stmts[first].hi, GRAIN);
+        for (kind = 0; kind < KIND_COUNT; kind++) {
+            int n = 0;
+            for (t = e->local_base; t < e->temp_count; t++) {
+                if (e->temp_kind[t] != kind) continue;
+                if (n++) buf_printf(&outer, ", t%d", (int)t);
+                else buf_printf(&outer, "        %s t%d", kind_names[kind], (int)t);
+            }
+            if (n) buf_printf(&outer, ";\n");
+            /* gone with the loop body */
+            for (t = 0; t < e->pool_len[kind];) {
+                if ((size_t)e->pool[kind][t] >= e->local_base) e->pool[kind][t] = e->pool[kind][--e->pool_len[kind]];
+                else t++;
+            }
+        }
+        for (t = e->local_base; t < e->temp_count; t++) e->temp_kind[t] = -1;
+        buf_printf(&outer, "        for (int64_t idx = begin; idx < end; idx++) {\n");
+    }
+    if (e->body.len) buf_printf(&outer, "%s", e->body.data);
+    buf_printf(&outer, sequential ? "    }\n" : "        }\n    });\n");
+    free(e->body.data);
+    e->body = outer;
+    e->local_base = 0;
+    e->indent = "    ";
+}
+
+/* Arrays a program stores or a PyTorch extension returns: the computed ones and the inputs a loop writes */
+static int is_output(const ir_symbol_t *a) {
+    return a->value < 0 && !a->quire && (!a->input || a->version > 0);
+}
+
+/* A scalar input the program uses without declaring it */
+static int is_undeclared(int v, const char *live) {
+    int found;
+    if (!live[v] || values[v].op != IR_INPUT) return 0;
+    found = find_symbol(values[v].name);
+    return found < 0 || !symbols[found].input;
+}
+
+static void emit_input(buffer_t *head, posit_type_t type, const char *name) {
+    if (type == TYPE_POSIT8)
+        buf_printf(head, "    posit8 %s = posit8_from_double_v(%s_arg);\n", name, name);
+    else
+        buf_printf(head, "    %s %s;\n    %s_from_double(&%s, %s_arg);\n", type_name(type), name, type_name(type), name, name);
+}
+
+/* forward(): input arrays as float tensors, scalar inputs as doubles */
+static void emit_torch_head(buffer_t *head, const char *live, buffer_t *args) {
+    size_t i;
+    int first = 1;
+    buf_printf(head, "std::vector<at::Tensor> forward(");
+    for (i = 0; i < symbol_count; i++) {
+        const ir_symbol_t *a = &symbols[i];
+        if (!a->input) continue;
+        if (a->value >= 0 && !a->read)
+            buf_printf(head, "%sdouble /* %s, unused */", first ? "" : ", ", a->name);
+        else
+            buf_printf(head, "%s%s %s_arg", first ? "" : ", ", a->value < 0 ? "at::Tensor" : "double", a->name);
+        buf_printf(args, ", py::arg(\"%s\")", a->name);
+        first = 0;
+    }
+    for (i = 0; i < value_count; i++) {
+        if (!is_undeclared((int)i, live)) continue;
+        buf_printf(head, "%sdouble %s_arg", first ? "" : ", ", values[i].name);
+        buf_printf(args, ", py::arg(\"%s\")", values[i].name);
+        first = 0;
+    }
+    buf_printf(head, ") {\n");
+
+    for (i = 0; i < symbol_count; i++) {
+        const ir_symbol_t *a = &symbols[i];
+        if (a->value >= 0 || a->quire) continue;
+        if (a->input) {
+            buf_printf(head, "    TORCH_CHECK(%s_arg.device().is_cpu() && %s_arg.numel() == %lld, \"%s must be a CPU tensor of %lld elements\");\n",
+                       a->name, a->name, a->length, a->name, a->length);
+            if (!a->read && !is_output(a)) continue;
+            /* a loop writes a copy */
+            buf_printf(head, "    at::Tensor %s_tensor = %s_arg.to(at::kFloat%s).contiguous();\n", a->name, a->name,
+                       a->version > 0 ? ", false, true" : "");
+        } else {
+            buf_printf(head, "    at::Tensor %s_tensor = at::empty({%lld}, at::kFloat);\n", a->name, a->length);
+        }
+        buf_printf(head, "    %sfloat *%s = %s_tensor.data_ptr<float>();\n", is_output(a) ? "" : "const ", a->name, a->name);
+    }
+    /* scalar inputs are rounded to their types once, if anything reads them */
+    for (i = 0; i < value_count; i++)
+        if (live[i] && values[i].op == IR_INPUT) emit_input(head, values[i].type, values[i].name);
+}
+
+void ir_emit(FILE *out) {
+    emitter_t e;
+    buffer_t head = {NULL, 0, 0}, args = {NULL, 0, 0};
+    char *live, *fused, *sequential, *read;
+    int *group_first;
+    size_t i, s, begin = 0;
+    int result_counter = 0, kind, arrays = 0, inputs = 0, wide = 0, outputs = 0, found;
+
+    for (i = 0; i < symbol_count; i++) outputs |= is_output(&symbols[i]);
+    if (torch_enabled && !outputs) {
+        ir_error("a PyTorch extension returns arrays, but the program computes none");
+        return;
+    }
+
+    /* the types of everything else depend on the ones precision selection picks */
+    if (error_bound > 0.0) select_precision();
+
+    /* the constants 1 used by contraction exist before the tables are sized */
+    make_const(TYPE_POSIT8, one_bits(TYPE_POSIT8));
+    make_const(TYPE_POSIT16, one_bits(TYPE_POSIT16));
+    make_const(TYPE_POSIT32, one_bits(TYPE_POSIT32));
+
+    memset(&e, 0, sizeof(e));
+    e.indent = "    ";
+    live = (char*)calloc(value_count + 1, 1);
+    fused = (char*)calloc(value_count + 1, 1);
+    read = (char*)calloc(value_count + 1, 1);
+    sequential = (char*)calloc(stmt_count + 1, 1);
+    group_first = (int*)xrealloc(NULL, (stmt_count + 1) * sizeof(int));
+    e.code = (const char**)calloc(value_count + 1, sizeof(const char*));
+    e.broadcast = (const char**)calloc(value_count + 1, sizeof(const char*));
+    e.uses = (int*)calloc(value_count + 1, sizeof(int));
+    e.same = (int*)xrealloc(NULL, (value_count + 1) * sizeof(int));
+    memset(e.same, 0xFF, (value_count + 1) * sizeof(int));
+    e.written = (int*)xrealloc(NULL, (symbol_count + 1) * sizeof(int));
+    memset(e.written, 0xFF, (symbol_count + 1) * sizeof(int));
+    e.temp = (int*)xrealloc(NULL, (value_count + 1) * sizeof(int));
+    for (i = 0; i < value_count; i++) e.temp[i] = -1;
+    for (s = 0; s < stmt_count; s++) {
+        if (stmts[s].type_name) continue;
+        if (stmts[s].fused) fused[stmts[s].value] = 1;
+    }
+    for (i = 0; i < symbol_count; i++) arrays |= symbols[i].value < 0 && !symbols[i].quire;
+
+    /* Passes: contraction, then folding and liveness on the contracted values.
+     * Values nothing depends on are never emitted.
+     */
+    compute_liveness(live, e.uses);
+    contract(live, e.uses, fused);
+    fold_constants();
+    compute_liveness(live, e.uses);
+    if (torch_enabled) {
+        /* the scalar variables array code reads, and the arrays it reads */
+        for (i = 0; i < value_count; i++) {
+            if (!live[i]) continue;
+            if (values[i].op == IR_NAME) read[values[i].a] = 1;
+            if (values[i].op == IR_ELEM) symbols[values[i].array].read = 1;
+            if (values[i].op == IR_INPUT && (found = find_symbol(values[i].name)) >= 0) symbols[found].read = 1;
+        }
+        for (s = 0; s < stmt_count; s++)
+            if (!stmts[s].type_name && stmts[s].quire < 0 && stmts[s].array < 0 && read[stmts[s].value]) e.uses[stmts[s].value]++;
+    }
+    plan_groups(group_first, sequential);
+    for (i = 0; i < value_count; i++) inputs |= live[i] && values[i].op == IR_INPUT;
+    /* posit32 and the quire are lowered to posit_sfp.h */
+    for (i = 0; i < value_count; i++) wide |= live[i] && values[i].type == TYPE_POSIT32;
+    for (s = 0; s < stmt_count; s++) wide |= !torch_enabled && !stmts[s].type_name && stmts[s].type == TYPE_POSIT32;
+
+    for (s = 0; s < stmt_count; s++) {
+        const ir_stmt_t *st = &stmts[s];
+        const char *type = type_name(st->type);
+        int root_value = st->type_name || st->array >= 0 ? -1 : st->value;
+        for (i = begin; i < st->value_end; i++) {
+            /* the declared value itself is computed straight into the variable */
+            if (live[i] && is_computed((int)i) && !values[i].varying && e.code[i] == NULL && (int)i != root_value)
+                emit_value(&e, (int)i, NULL, 0);
+        }
+        begin = st->value_end;
+        if (st->type_name) {
+            /* For now: float and double have no codegen */
+            buf_printf(&e.body, "    /* TODO: codegen for type %s */\n", st->type_name);
+            continue;
+        }
+        if (st->quire >= 0) {
+            /* every product goes into the quire exactly */
+            int t;
+            if (!symbols[st->quire].read) continue;
+            if (st->nterms == 0) buf_printf(&e.body, "    quire32 %s = quire32_init();\n", st->name);
+            for (t = 0; t < st->nterms; t++) {
+                buf_printf(&e.body, "    quire32_fma(&%s, %s, %s);\n", st->name,
+                           negated(&e, st->terms[t].a, st->terms[t].neg), operand(&e, st->terms[t].b));
+                use_done(&e, st->terms[t].a);
+                use_done(&e, st->terms[t].b);
+            }
+            continue;
+        }
+        if (st->array >= 0) {
+            /* a group of array statements is emitted after its last one */
+            if (s + 1 != stmt_count && group_first[s + 1] == group_first[s]) continue;
+            if (torch_enabled) emit_tensor_group(&e, (size_t)group_first[s], s + 1, sequential[group_first[s]], live);
+            else emit_group(&e, (size_t)group_first[s], s + 1, sequential[group_first[s]], live);
+            continue;
+        }
+        if (torch_enabled && !read[root_value]) {
+            /* no variable, but array code may share the value */
+            if (live[root_value] && is_computed(root_value) && e.code[root_value] == NULL) emit_value(&e, root_value, NULL, 0);
+            continue;
+        }
+        if (is_computed(root_value) && e.code[root_value] == NULL && values[root_value].op != IR_NAME) {
+            emit_value(&e, root_value, st->name, 1);
+        } else {
+            if (values[root_value].op == IR_NAME && e.code[root_value] == NULL) emit_value(&e, root_value, NULL, 0);
+            buf_printf(&e.body, "    %s %s = %s;\n", type, st->name, operand(&e, root_value));
+            /* later uses read the variable, the temporary can be reused */
+            if (is_computed(root_value)) e.code[root_value] = st->name;
+        }
+        use_done(&e, root_value);
+        /* extensions return arrays only */
+        if (torch_enabled) continue;
+        buf_printf(&e.body, "    double result%d;\n", result_counter);
+        buf_printf(&e.body, "    %s_to_double(&result%d, %s);\n", type, result_counter, st->name);
+        buf_printf(&e.body, "    printf(\"Result: %%.6f\\n\", result%d);\n", result_counter);
+        result_counter++;
+    }
+
+    /* Prolog, with the temporaries declared up front */
+    if (torch_enabled) {
+        buf_printf(&head, "/* PyTorch extension: torch.utils.cpp_extension.load with posit8.c,\n"
+                          " * posit8_tables.c and posit16.c%s as sources */\n",
+                   wide ? ", and posit_sfp.c built with -DPOSIT_SFP_POSIT32_ONLY," : "");
+        buf_printf(&head, "#include <torch/extension.h>\n");
+        buf_printf(&head, "#include <ATen/Parallel.h>\n");
+        buf_printf(&head, "#include <vector>\n");
+    } else {
+        buf_printf(&head, "#include <stdio.h>\n");
+    }
+    if (arrays && !torch_enabled) buf_printf(&head, "#include <string.h>\n");
+    buf_printf(&head, "#include \"posit8.h\"\n");
+    buf_printf(&head, "#include \"posit16.h\"\n");
+    if (wide) {
+        buf_printf(&head, "#define POSIT_SFP_POSIT32_ONLY\n");
+        buf_printf(&head, "#include \"posit_sfp.h\"\n");
+    }
+    if ((arrays || inputs) && !torch_enabled) buf_printf(&head, "#include \"posit_io.h\"\n");
+    buf_printf(&head, "\n");
+    if (torch_enabled) emit_torch_head(&head, live, &args);
+    else buf_printf(&head, arrays || inputs ? "int main(int argc, char **argv) {\n" : "int main(void) {\n");
+    for (kind = 0; kind < KIND_COUNT; kind++) {
+        const char *size = kind >= KIND_BLOCK8 ? arena_printf("[%d]", BLOCK) : "";
+        int first = 1;
+        for (i = 0; i < e.temp_count; i++) {
+            if (e.temp_kind[i] != kind) continue;
+            if (first) buf_printf(&head, "    %s t%d%s", kind_names[kind], (int)i, size);
+            else buf_printf(&head, ", t%d%s", (int)i, size);
+            first = 0;
+        }
+        if (!first) buf_printf(&head, ";\n");
+    }
+    /* arrays: inputs mapped from their files, the others static */
+    for (i = 0; i < symbol_count; i++) {
+        const ir_symbol_t *a = &symbols[i];
+        const char *type = type_name(a->type);
+        if (a->value >= 0 || a->quire || torch_enabled) continue;
+        if (!a->input) {
+            buf_printf(&head, "    static %s %s[%lld];\n", type, a->name, a->length);
+            continue;
+        }
+        buf_printf(&head, "    %s *%s = (%s*)posit_io_map(\"%s\", %lld * sizeof(%s), argc, argv);\n",
+                   type, a->name, type, a->name, a->length, type);
+        buf_printf(&head, "    if (%s == NULL) return 1;\n", a->name);
+    }
+    /* scalar inputs come from name=value arguments, rounded to their types once */
+    for (i = 0; i < value_count; i++) {
+        if (torch_enabled || !live[i] || values[i].op != IR_INPUT) continue;
+        buf_printf(&head, "    double %s_arg;\n", values[i].name);
+        buf_printf(&head, "    if (posit_io_scalar(\"%s\", &%s_arg, argc, argv) != 0) return 1;\n", values[i].name, values[i].name);
+        emit_input(&head, values[i].type, values[i].name);
+    }
+
+    fwrite(head.data, 1, head.len, out);
+    if (e.body.len) fwrite(e.body.data, 1, e.body.len, out);
+    if (torch_enabled) {
+        int first = 1;
+        fputs("    return {", out);
+        for (i = 0; i < symbol_count; i++) {
+            if (!is_output(&symbols[i])) continue;
+            fprintf(out, "%s%s_tensor", first ? "" : ", ", symbols[i].name);
+            first = 0;
+        }
+        fputs("};\n}\n\nPYBIND11_MODULE(TORCH_EXTENSION_NAME, m) {\n", out);
+        fprintf(out, "    m.def(\"forward\", &forward, \"Posit kernel (CPU)\"%s);\n}\n", args.len ? args.data : "");
+    } else {
+        /* Epilog: computed arrays, and the inputs a loop writes, are written to their files */
+        for (i = 0; i < symbol_count; i++) {
+            const char *type = type_name(symbols[i].type);
+            if (!is_output(&symbols[i])) continue;
+            fprintf(out, "    if (posit_io_store(\"%s\", %s, %lld * sizeof(%s), argc, argv) != 0) return 1;\n",
+                    symbols[i].name, symbols[i].name, symbols[i].length, type);
+        }
+        fputs("    return 0;\n}\n", out);
+    }
+
+    free(head.data);
+    free(args.data);
+    free(e.body.data);
+    free(live);
+    free(fused);
+    free(read);
+    free(sequential);
+    free(group_first);
+    free(e.code);
+    free(e.broadcast);
+    free(e.uses);
+    free(e.same);
+    free(e.written);
+    free(e.temp);
+    free(e.temp_kind);
+    for (kind = 0; kind < KIND_COUNT; kind++) free(e.pool[kind]);
+}
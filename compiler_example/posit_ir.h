@@ -0,0 +1,134 @@
+#ifndef POSIT_IR_H
+#define POSIT_IR_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Intermediate representation for the posit compiler
+ * The parser builds SSA values instead of printing C as it reduces. Values
+ * are hash-consed on creation, which eliminates common subexpressions.
+ * ir_emit then contracts sums of products, folds constants, drops values no
+ * declaration depends on, reuses temporaries whose last use has passed and
+ * writes the program in one go.
+ *
+ * Array statements (whole-array declarations and loop bodies) use the same
+ * values: an array element is a leaf that varies with the loop index, and so
+ * does everything computed from one. Varying values are lowered to the
+ * runtime's array functions, one call per operation and block of elements.
+ */
+
+/* Posit formats the code generator lowers to, narrowest first: posit8 and
+ * posit16 (es=1) on this directory's runtimes, posit32 (es=2) on posit_sfp.h
+ */
+typedef enum { TYPE_POSIT8, TYPE_POSIT16, TYPE_POSIT32 } posit_type_t;
+
+typedef enum {
+    IR_CONST,   /* bit pattern known at compile time */
+    IR_INPUT,   /* a declared input, or a name the program does not declare (posit8) */
+    IR_ADD,
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_CONVERT, /* operand a converted to the value's type */
+    IR_NAME,    /* a use of the declared variable holding operand a */
+    IR_DOT,     /* sum of +-a*b terms rounded once, made by contraction */
+    IR_ELEM,    /* array element at the loop index plus an offset */
+    IR_QUIRE    /* a quire32 variable rounded to posit32, after version accumulations */
+} ir_op_t;
+
+/* One term of an IR_DOT: (-1)^neg * a * b */
+typedef struct {
+    int a, b;
+    int neg;
+} ir_term_t;
+
+typedef struct {
+    ir_op_t op;
+    posit_type_t type;
+    int a, b;                /* operand values, -1 if unused */
+    uint32_t bits;           /* IR_CONST */
+    const char *name;        /* IR_INPUT, interned */
+    const ir_term_t *terms;  /* IR_DOT */
+    int nterms;
+    int array, version;      /* IR_ELEM, IR_QUIRE: symbol and writes to it before the read */
+    int offset, loop;        /* IR_ELEM: index offset and the iteration space */
+    int varying;             /* depends on an array element, not hashed */
+} ir_value_t;
+
+void ir_init(void);
+
+/* Value builders, returning value ids */
+int ir_literal(const char *text);
+int ir_input(const char *name);
+int ir_binary(ir_op_t op, int a, int b);
+int ir_convert(int a, posit_type_t type);
+
+/* Declared variables: declarations are single assignments, so a name stands
+ * for its value and uses of it share the value's code
+ */
+int ir_lookup(const char *name);
+void ir_declare(posit_type_t type, const char *name, int value);
+void ir_unsupported(const char *type_name);
+
+/* A quire declaration: the value is accumulated exactly and rounded once to
+ * the posit type of its terms, whether or not contraction is enabled
+ */
+void ir_declare_quire(const char *name, int value);
+
+/* Quire variables: quire32 q; starts at zero, q += expression; and
+ * q -= expression; add every product of the sum exactly, and a use of q is
+ * its value rounded to posit32 at that point
+ */
+void ir_declare_accumulator(const char *type_name, const char *name);
+void ir_accumulate(const char *name, int value, int negate);
+
+/* Arrays: an array declared without a value is an input, mapped from a
+ * binary file at run time; one declared with a value is computed element-wise
+ * over its whole length and written to a file when the program ends.
+ */
+void ir_declare_array(const char *type_name, const char *name, const char *length, int value);
+
+/* for index in lo:hi { array[index + offset] = expression; ... } */
+void ir_loop_begin(const char *index, const char *lo, const char *hi);
+void ir_loop_end(void);
+int ir_index(const char *index, const char *offset, int sign);
+int ir_element(const char *name, int offset);
+void ir_assign(const char *name, int offset, int value);
+
+/* Inputs: a scalar input declared with its range, and the range of an input
+ * array. Undeclared names are posit8 inputs; inputs without a range may take
+ * any value of their type.
+ */
+void ir_declare_input(const char *type_name, const char *name);
+void ir_input_range(const char *name, double lo, double hi);
+
+/* Number of semantic errors reported so far */
+int ir_errors(void);
+
+/* Contract a*b + c into fma and longer sums of products into quire dot
+ * products: one rounding instead of one per operation (on by default)
+ */
+void ir_set_contract(int enabled);
+
+/* Precision selection: with a bound set, every scalar variable and every
+ * temporary gets the narrowest posit type that keeps each declared value
+ * within bound * max(1, M) of the exact result, M the largest magnitude
+ * interval analysis of the inputs' ranges finds it can take; the declared
+ * types are replaced.
+ * Arrays keep their declared types, and array code stays within posit16.
+ * Quire accumulations keep theirs too. 0 (the default) turns it off.
+ */
+void ir_set_error_bound(double bound);
+
+/* PyTorch backend: instead of a program, write a C++ extension for
+ * torch.utils.cpp_extension.load whose forward() takes the input arrays as
+ * float tensors and the scalar inputs as numbers, and returns the arrays the
+ * program computes. Array statements run in one pass over the elements,
+ * split across threads, rounding after every operation as the program does.
+ */
+void ir_set_torch(int enabled);
+
+/* Write the C program for everything declared so far */
+void ir_emit(FILE *out);
+
+#endif /* POSIT_IR_H */
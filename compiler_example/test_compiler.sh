@@ -0,0 +1,57 @@
+#!/bin/bash
+# Compile posit programs to C, build them and check what they print.
+
+make > /dev/null 2>&1 || { echo "Error: Build failed."; exit 1; }
+LIBS="posit8.o posit8_tables.o posit16.o posit_sfp.o posit_io.o -lm"
+failed=0
+
+# check NAME PROGRAM EXPECTED ARGS...: compile PROGRAM, run it with ARGS and compare its output
+check() {
+    local name=$1 program=$2 expected=$3
+    shift 3
+    echo "=== $name ==="
+    echo "$program"
+    if ! echo "$program" | ./posit_compiler > test_$name.c || \
+       ! gcc -I../softposit_example -o test_$name test_$name.c $LIBS; then
+        echo "FAILED: does not compile"
+        failed=1
+        return
+    fi
+    actual=$(./test_$name "$@" 2>&1)
+    echo "$actual"
+    if [ "$actual" != "$expected" ]; then
+        echo "FAILED: expected"
+        echo "$expected"
+        failed=1
+    fi
+    echo ""
+}
+
+check literals "posit8 x = 1.5p8 + 2.0p8;" "Result: 3.500000"
+check variables "posit8 a = 1.0p8; posit8 b = 2.0p8; posit8 c = a + b;" \
+"Result: 1.000000
+Result: 2.000000
+Result: 3.000000"
+check quire "posit16 a = 0.1p16; quire32 q; q += a*a; q -= a*a; posit32 r = q;" \
+"Result: 0.100006
+Result: 0.000000"
+# scalar inputs are read from name=value arguments
+check scalar_input "posit8 a in -2:2; posit16 b in 0:100; posit8 c = a * 1.5p8 + 1p8; posit16 d = b / 3p16 + c;" \
+"Result: 2.875000
+Result: 6.208984" a=1.25 b=10
+check missing_input "posit8 a in -2:2; posit8 c = a + 1p8;" "missing input a=value"
+# an input array a loop writes to is stored back to its file
+printf '\x40\x40\x40\x40\x40\x40\x40\x40' > test_x.bin
+check input_array_write "posit8 x[8]; for i in 2:6 { x[i] = x[i] * 2.0p8; }" "" x=test_x.bin
+stored=$(od -An -tx1 test_x.bin | tr -d ' \n')
+if [ "$stored" != "4040505050504040" ]; then
+    echo "FAILED: x stored as $stored, expected 4040505050504040"
+    failed=1
+fi
+
+rm -f test_*.c test_x.bin test_literals test_variables test_quire test_scalar_input test_missing_input test_input_array_write
+if [ $failed -ne 0 ]; then
+    echo "Some tests failed."
+    exit 1
+fi
+echo "All tests passed."
@@ -55,7 +55,31 @@ int main(void) {
         printf("Error in quire accumulation\n");
     }
 
-    // Test 5: Conversion Error (NaN input)
+    // Test 5: Square root (sqrt(2.0))
+    err = posit32_sqrt(&c, b);
+    if (err == POSIT_OK) {
+        posit32_to_float(&fc, c);
+        printf("Sqrt Result: %f\n", fc);
+    } else {
+        printf("Error in sqrt\n");
+    }
+
+    // Test 6: Arrays (element-wise product and dot product of 1..4 with 0.5)
+    float xs[4] = {1.0f, 2.0f, 3.0f, 4.0f}, ys[4] = {0.5f, 0.5f, 0.5f, 0.5f}, out[4];
+    posit32 px[4], py[4], pz[4];
+    err = posit32_from_float_array(px, xs, 4);
+    err |= posit32_from_float_array(py, ys, 4);
+    err |= posit32_mul_array(pz, px, py, 4);
+    err |= posit32_to_float_array(out, pz, 4);
+    if (err == POSIT_OK) {
+        printf("Array Result: %f %f %f %f\n", out[0], out[1], out[2], out[3]);
+        posit32_to_float(&fc, quire32_dot(px, py, 4));
+        printf("Dot Result: %f\n", fc);
+    } else {
+        printf("Error in array operations\n");
+    }
+
+    // Test 7: Conversion Error (NaN input)
     err = float_to_posit32(&c, 0.0f / 0.0f); // NaN
     if (err == POSIT_NOT_A_REAL) {
         printf("Error: NaN input detected\n");
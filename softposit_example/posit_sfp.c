@@ -1,54 +1,422 @@
-#include "posit.h"
+#include "posit_sfp.h"
 #include <string.h>
-// #include <softposit.h> // SoftPosit library - TODO: Install or provide correct path
 
 /* Runtime Library for Posit Arithmetic
  *
- * Implements posit.h functions using SoftPosit for true posit arithmetic and
- * a basic quire emulation for posit32. Replaces IEEE 754 float-based placeholder
- * logic with proper posit operations, supporting Dr. John L. Gustafson's
- * requirements for posit integration in C.
+ * Self-contained implementation of posit_sfp.h: posit32 (es=2) arithmetic,
+ * conversions and the quire work on the integer fields of the posits only, with
+ * no floating-point round-trips and no external library. Every operation is
+ * correctly rounded (round to nearest, ties to the even bit pattern, no
+ * rounding to zero or NaR), matching SoftPosit results.
  *
- * Note: Quire implementation is simplified and requires optimization (e.g., GMP
- * or custom 512-bit arithmetic) for full accuracy.
+ * The quire is an exact 512-bit fixed-point accumulator: products are formed
+ * from the integer posit fields and added with multi-limb carries, and
+ * extraction rounds the full 512-bit value correctly.
  */
 
+typedef unsigned __int128 u128;
+
+#ifdef POSIT_SFP_POSIT32_ONLY
+enum { POSIT_OK = 0, POSIT_OVERFLOW, POSIT_INVALID, POSIT_NOT_A_REAL };
+#endif
+
+/* Integer posit32 (es=2) helpers
+ * A finite nonzero posit32 is (-1)^sign * 2^scale * sig / 2^63 with the hidden bit
+ * at bit 63 of sig and scale in [-120, 120].
+ */
+#define P32_NAR 0x80000000u
+#define P32_MAXPOS 0x7FFFFFFFu
+#define P32_MAX_SCALE 120
+
+static inline void p32_decode(posit32 p, int *sign, int32_t *scale, uint64_t *sig) {
+    uint64_t x;
+    int n, k;
+    *sign = p >> 31;
+    if (*sign) p = -p;
+    x = (uint64_t)(p << 1) << 32;
+    if (x >> 63) {
+        n = __builtin_clzll(~x);
+        k = n - 1;
+    } else {
+        n = __builtin_clzll(x);
+        k = -n;
+    }
+    x = (n + 1 >= 64) ? 0 : x << (n + 1);
+    *scale = 4 * k + (int32_t)(x >> 62);
+    *sig = (1ULL << 63) | ((x << 2) >> 1);
+}
+
+/* Round (-1)^sign * 2^scale * sig / 2^63 to the nearest nbits posit with es exponent
+ * bits, ties to the even pattern; returns the pattern in the low nbits bits.
+ * sig must have its top bit set; sticky flags nonzero bits below sig. Never rounds to 0 or NaR.
+ */
+static inline uint32_t posit_round_pack(int nbits, int es, int sign, int32_t scale, uint64_t sig, int sticky) {
+    const int32_t max_scale = (nbits - 2) << es;
+    const uint32_t maxpos = (1u << (nbits - 1)) - 1;
+    const uint32_t mask = (uint32_t)((1ULL << nbits) - 1);
+    const int cut = 129 - nbits; /* field bits below the nbits - 1 pattern bits */
+    u128 field;
+    uint32_t p;
+    int len, k, e;
+    if (scale > max_scale) {
+        p = maxpos;
+    } else if (scale < -max_scale) {
+        p = 1;
+    } else {
+        k = scale >> es;
+        e = scale & ((1 << es) - 1);
+        /* regime, exponent and fraction left aligned in 128 bits */
+        if (k >= 0) {
+            len = k + 2;
+            field = (((u128)1 << (k + 1)) - 1) << (128 - (k + 1));
+        } else {
+            len = 1 - k;
+            field = (u128)1 << (128 - len);
+        }
+        field |= (u128)e << (128 - len - es);
+        field |= ((u128)(sig << 1) << 64) >> (len + es);
+        p = (uint32_t)(field >> cut);
+        if (p != maxpos && ((field >> (cut - 1)) & 1) &&
+            ((field & (((u128)1 << (cut - 1)) - 1)) || sticky || (p & 1)))
+            p++;
+        if (p == 0) p = 1;
+    }
+    return (sign ? -p : p) & mask;
+}
+
+static inline posit32 p32_round_pack(int sign, int32_t scale, uint64_t sig, int sticky) {
+    return posit_round_pack(32, 2, sign, scale, sig, sticky);
+}
+
+static inline int clz128(u128 x) {
+    uint64_t hi = (uint64_t)(x >> 64);
+    return hi ? __builtin_clzll(hi) : 64 + __builtin_clzll((uint64_t)x);
+}
+
+/* round (-1)^sign * 2^scale * x / 2^126, x with bit 126 set */
+static inline posit32 p32_round_fields(int sign, int32_t scale, u128 x) {
+    x <<= 1;
+    return p32_round_pack(sign, scale, (uint64_t)(x >> 64), (uint64_t)x != 0);
+}
+
+/* exact sum of two values in the form of p32_round_fields, rounded once */
+static inline posit32 p32_add_fields(int sa, int32_t ea, u128 a, int sb, int32_t eb, u128 b) {
+    int32_t shift, et;
+    int st, lz;
+    u128 t, s;
+    if (ea < eb || (ea == eb && a < b)) {
+        t = a; a = b; b = t;
+        et = ea; ea = eb; eb = et;
+        st = sa; sa = sb; sb = st;
+    }
+    shift = ea - eb;
+    if (shift >= 127) {
+        /* b lies entirely below a's last bit, keep it as a sticky bit */
+        b = 1;
+    } else if (shift > 0) {
+        int lost = (b & (((u128)1 << shift) - 1)) != 0;
+        b = (b >> shift) | lost;
+    }
+    s = (sa == sb) ? a + b : a - b;
+    if (s == 0) return 0;
+    lz = clz128(s);
+    s <<= lz;
+    return p32_round_pack(sa, ea + 1 - lz, (uint64_t)(s >> 64), (uint64_t)s != 0);
+}
+
+static inline posit32 p32_add(posit32 a, posit32 b) {
+    int sa, sb;
+    int32_t ea, eb;
+    uint64_t ma, mb;
+    if (a == P32_NAR || b == P32_NAR) return P32_NAR;
+    if (a == 0) return b;
+    if (b == 0) return a;
+    p32_decode(a, &sa, &ea, &ma);
+    p32_decode(b, &sb, &eb, &mb);
+    return p32_add_fields(sa, ea, (u128)ma << 63, sb, eb, (u128)mb << 63);
+}
+
+static inline posit32 p32_sub(posit32 a, posit32 b) {
+    /* negation is the two's complement of the pattern and keeps NaR */
+    return p32_add(a, -b);
+}
+
+static inline posit32 p32_mul(posit32 a, posit32 b) {
+    int sa, sb;
+    int32_t ea, eb;
+    uint64_t ma, mb;
+    u128 prod;
+    if (a == P32_NAR || b == P32_NAR) return P32_NAR;
+    if (a == 0 || b == 0) return 0;
+    p32_decode(a, &sa, &ea, &ma);
+    p32_decode(b, &sb, &eb, &mb);
+    prod = (u128)ma * mb;
+    if (prod >> 127)
+        return p32_round_fields(sa ^ sb, ea + eb + 1, prod >> 1);
+    return p32_round_fields(sa ^ sb, ea + eb, prod);
+}
+
+static inline posit32 p32_div(posit32 a, posit32 b) {
+    int sa, sb;
+    int32_t ea, eb;
+    uint64_t ma, mb;
+    u128 num, q;
+    if (a == P32_NAR || b == P32_NAR || b == 0) return P32_NAR;
+    if (a == 0) return 0;
+    p32_decode(a, &sa, &ea, &ma);
+    p32_decode(b, &sb, &eb, &mb);
+    /* 2^64 * ma / mb lies in (2^63, 2^65) */
+    num = (u128)ma << 64;
+    q = num / mb;
+    if (q >> 64)
+        return p32_round_pack(sa ^ sb, ea - eb, (uint64_t)(q >> 1), (q & 1) || num % mb);
+    return p32_round_pack(sa ^ sb, ea - eb - 1, (uint64_t)q, num % mb != 0);
+}
+
+static inline posit32 p32_fma(posit32 a, posit32 b, posit32 c) {
+    int sa, sb, sc, lz;
+    int32_t ea, eb, ec, ep;
+    uint64_t ma, mb, mc;
+    u128 prod;
+    if (a == P32_NAR || b == P32_NAR || c == P32_NAR) return P32_NAR;
+    if (a == 0 || b == 0) return c;
+    p32_decode(a, &sa, &ea, &ma);
+    p32_decode(b, &sb, &eb, &mb);
+    /* exact 56-bit product normalized to bit 126 */
+    prod = (u128)(ma >> 36) * (mb >> 36);
+    lz = clz128(prod);
+    ep = ea + eb - 54 + (127 - lz);
+    prod <<= lz - 1;
+    if (c == 0) return p32_round_fields(sa ^ sb, ep, prod);
+    p32_decode(c, &sc, &ec, &mc);
+    return p32_add_fields(sa ^ sb, ep, prod, sc, ec, (u128)mc << 63);
+}
+
+/* floor(sqrt(n)), digit by digit */
+static inline uint64_t isqrt128(u128 n, int *inexact) {
+    u128 rem = 0, root = 0, trial;
+    int i;
+    for (i = 0; i < 64; i++) {
+        rem = (rem << 2) | (n >> 126);
+        n <<= 2;
+        root <<= 1;
+        trial = (root << 1) | 1;
+        if (rem >= trial) {
+            rem -= trial;
+            root |= 1;
+        }
+    }
+    *inexact = rem != 0;
+    return (uint64_t)root;
+}
+
+static inline posit32 p32_sqrt(posit32 a) {
+    int sa, inexact;
+    int32_t ea;
+    uint64_t ma, root;
+    if (a == 0) return 0;
+    if (a >> 31) return P32_NAR; /* NaR and negative numbers */
+    p32_decode(a, &sa, &ea, &ma);
+    /* sqrt(ma * 2^63) or sqrt(ma * 2^64) lies in [2^63, 2^64) */
+    root = isqrt128((u128)ma << (63 + (ea & 1)), &inexact);
+    return p32_round_pack(0, (ea - (ea & 1)) / 2, root, inexact);
+}
+
+/* IEEE 754 binary64 / binary32 bits to an nbits posit, NaN and infinities map to NaR */
+static inline uint32_t posit_from_ieee(int nbits, int es, uint64_t bits, int exp_bits, int man_bits) {
+    const uint64_t man_mask = (1ULL << man_bits) - 1;
+    const int32_t exp_max = (1 << exp_bits) - 1, bias = exp_max >> 1;
+    int sign = (int)(bits >> (exp_bits + man_bits));
+    int32_t exp = (int32_t)((bits >> man_bits) & exp_max);
+    uint64_t man = bits & man_mask;
+    int lz;
+    if (exp == exp_max) return 1u << (nbits - 1);
+    if (exp == 0) {
+        if (man == 0) return 0;
+        /* subnormal */
+        lz = __builtin_clzll(man);
+        return posit_round_pack(nbits, es, sign, 1 - bias - man_bits + (63 - lz), man << lz, 0);
+    }
+    return posit_round_pack(nbits, es, sign, exp - bias, (1ULL << 63) | (man << (63 - man_bits)), 0);
+}
+
+static inline uint64_t double_bits(double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+static inline uint32_t float_bits(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+/* exact: posit32 values need at most 28 significant bits */
+static inline double p32_to_double(posit32 p) {
+    int sign;
+    int32_t scale;
+    uint64_t sig, bits;
+    double d;
+    if (p == 0) return 0.0;
+    p32_decode(p, &sign, &scale, &sig);
+    bits = ((uint64_t)sign << 63) | ((uint64_t)(scale + 1023) << 52) | ((sig << 1) >> 12);
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+/* rounded to nearest even, scales up to 120 stay in the normal binary32 range */
+static inline float p32_to_float(posit32 p) {
+    int sign;
+    int32_t scale;
+    uint64_t sig, frac;
+    uint32_t bits;
+    float f;
+    if (p == 0) return 0.0f;
+    p32_decode(p, &sign, &scale, &sig);
+    frac = sig << 1;
+    bits = ((uint32_t)sign << 31) | ((uint32_t)(scale + 127) << 23) | (uint32_t)(frac >> 41);
+    if (((frac >> 40) & 1) && ((frac & ((1ULL << 40) - 1)) || (bits & 1)))
+        bits++;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
 posit_error_t posit32_add(posit32 *result, posit32 a, posit32 b) {
     if (!result) return POSIT_INVALID;
-    *result = addP32(a, b); // SoftPosit addition
-    if (*result == 0x80000000) return POSIT_NOT_A_REAL; // Check for Not a Real
+    *result = p32_add(a, b);
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL; // Check for Not a Real
     return POSIT_OK;
 }
 
 posit_error_t posit32_sub(posit32 *result, posit32 a, posit32 b) {
     if (!result) return POSIT_INVALID;
-    *result = subP32(a, b);
-    if (*result == 0x80000000) return POSIT_NOT_A_REAL;
+    *result = p32_sub(a, b);
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL;
     return POSIT_OK;
 }
 
 posit_error_t posit32_mul(posit32 *result, posit32 a, posit32 b) {
     if (!result) return POSIT_INVALID;
-    *result = mulP32(a, b);
-    if (*result == 0x80000000) return POSIT_NOT_A_REAL;
+    *result = p32_mul(a, b);
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL;
     return POSIT_OK;
 }
 
 posit_error_t posit32_div(posit32 *result, posit32 a, posit32 b) {
     if (!result) return POSIT_INVALID;
-    if (b == 0) return POSIT_NOT_A_REAL; // Division by zero
-    *result = divP32(a, b);
-    if (*result == 0x80000000) return POSIT_NOT_A_REAL;
+    *result = p32_div(a, b); // Division by zero gives Not a Real
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL;
     return POSIT_OK;
 }
 
 posit_error_t posit32_fma(posit32 *result, posit32 a, posit32 b, posit32 c) {
     if (!result) return POSIT_INVALID;
-    *result = fmaP32(a, b, c); // SoftPosit FMA
-    if (*result == 0x80000000) return POSIT_NOT_A_REAL;
+    *result = p32_fma(a, b, c); // a * b + c with a single rounding
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL;
     return POSIT_OK;
 }
 
+posit_error_t posit32_sqrt(posit32 *result, posit32 a) {
+    if (!result) return POSIT_INVALID;
+    *result = p32_sqrt(a);
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL;
+    return POSIT_OK;
+}
+
+/* Quire32
+ * 512-bit two's complement fixed point with the lsb at 2^-240 (= minpos^2): every product
+ * of two posit32 values is exact in it, and bits 482..510 leave room for 2^29 worst-case
+ * carries. NaR is the pattern with only the top bit set.
+ */
+#define Q32_LIMBS 8
+#define Q32_LSB_SCALE (-2 * P32_MAX_SCALE)
+
+static inline int q32_is_nar(const uint64_t q[Q32_LIMBS]) {
+    int i;
+    if (q[Q32_LIMBS - 1] != (1ULL << 63)) return 0;
+    for (i = 0; i < Q32_LIMBS - 1; i++)
+        if (q[i]) return 0;
+    return 1;
+}
+
+static inline void q32_set_nar(uint64_t q[Q32_LIMBS]) {
+    memset(q, 0, Q32_LIMBS * sizeof(uint64_t));
+    q[Q32_LIMBS - 1] = 1ULL << 63;
+}
+
+/* q += (-1)^negative * a * b, exact; returns 0 if either operand is NaR */
+static inline int q32_fma(uint64_t q[Q32_LIMBS], posit32 a, posit32 b) {
+    int sa, sb, pos, limb, off, i;
+    int32_t ea, eb;
+    uint64_t ma, mb, lo, hi, carry, t;
+    unsigned __int128 prod;
+    if (a == P32_NAR || b == P32_NAR) return 0;
+    if (a == 0 || b == 0) return 1;
+    p32_decode(a, &sa, &ea, &ma);
+    p32_decode(b, &sb, &eb, &mb);
+    /* at most 27 fraction bits each: 56-bit product of value prod * 2^(ea + eb - 54) */
+    prod = (unsigned __int128)(ma >> 36) * (mb >> 36);
+    pos = ea + eb - 54 - Q32_LSB_SCALE;
+    if (pos < 0) {
+        /* only trailing zero bits are shifted out, posit32 products are multiples of 2^-240 */
+        prod >>= -pos;
+        pos = 0;
+    }
+    limb = pos >> 6;
+    off = pos & 63;
+    lo = (uint64_t)(prod << off);
+    hi = off ? (uint64_t)(prod >> (64 - off)) : 0;
+    if (sa ^ sb) {
+        t = q[limb];
+        q[limb] = t - lo;
+        carry = t < lo;
+        if (limb + 1 < Q32_LIMBS) {
+            t = q[limb + 1];
+            q[limb + 1] = t - hi - carry;
+            carry = t < hi || (t - hi) < carry;
+            for (i = limb + 2; i < Q32_LIMBS && carry; i++)
+                carry = q[i]-- == 0;
+        }
+    } else {
+        q[limb] += lo;
+        carry = q[limb] < lo;
+        if (limb + 1 < Q32_LIMBS) {
+            t = q[limb + 1] + carry;
+            carry = t < carry;
+            q[limb + 1] = t + hi;
+            carry |= q[limb + 1] < hi;
+            for (i = limb + 2; i < Q32_LIMBS && carry; i++)
+                carry = ++q[i] == 0;
+        }
+    }
+    return 1;
+}
+
+/* correctly rounded posit32 nearest to the quire value */
+static inline posit32 q32_round(const uint64_t q[Q32_LIMBS]) {
+    uint64_t mag[Q32_LIMBS], sig, carry;
+    int sign, i, top, bit, sticky;
+    if (q32_is_nar(q)) return P32_NAR;
+    sign = q[Q32_LIMBS - 1] >> 63;
+    carry = 1;
+    for (i = 0; i < Q32_LIMBS; i++) {
+        mag[i] = sign ? ~q[i] + carry : q[i];
+        if (sign) carry = carry && mag[i] == 0;
+    }
+    for (top = Q32_LIMBS - 1; top >= 0 && mag[top] == 0; top--)
+        ;
+    if (top < 0) return 0;
+    bit = 63 - __builtin_clzll(mag[top]);
+    /* left align the 64 bits below and including the leading one */
+    sig = mag[top] << (63 - bit);
+    if (bit < 63 && top > 0) sig |= mag[top - 1] >> (bit + 1);
+    sticky = top > 0 && (mag[top - 1] << (63 - bit)) != 0;
+    for (i = top - 2; i >= 0 && !sticky; i--)
+        sticky = mag[i] != 0;
+    return p32_round_pack(sign, 64 * top + bit + Q32_LSB_SCALE, sig, sticky);
+}
+
 quire32 quire32_init(void) {
     quire32 q;
     memset(q.data, 0, sizeof(q.data));
@@ -57,102 +425,144 @@ quire32 quire32_init(void) {
 
 posit_error_t quire32_fma(quire32 *q, posit32 a, posit32 b) {
     if (!q) return POSIT_INVALID;
-    // Simplified: Convert to double for high-precision product
-    // TODO: Replace with 512-bit fixed-point arithmetic or GMP
-    double fa = convertP32ToDouble(a);
-    double fb = convertP32ToDouble(b);
-    if (fa == 0.0 || fb == 0.0) return POSIT_OK; // No accumulation needed
-    double product = fa * fb;
-    // Scale and add to quire (first 64 bits, incomplete)
-    int64_t scaled = (int64_t)(product * (1ULL << 32)); // Fixed-point scaling
-    uint64_t carry = 0;
-    uint64_t sum = q->data[0] + scaled;
-    if (sum < q->data[0]) carry = 1; // Detect carry
-    q->data[0] = sum;
-    // Propagate carry (simplified, only one step)
-    for (int i = 1; i < 8 && carry; i++) {
-        q->data[i] += carry;
-        carry = q->data[i] < carry;
+    if (q32_is_nar(q->data)) return POSIT_NOT_A_REAL;
+    if (!q32_fma(q->data, a, b)) {
+        q32_set_nar(q->data);
+        return POSIT_NOT_A_REAL;
     }
     return POSIT_OK;
 }
 
 posit_error_t quire32_to_posit(posit32 *result, quire32 q) {
     if (!result) return POSIT_INVALID;
-    // Simplified: Extract from first 64 bits
-    // TODO: Use full 512-bit value with proper rounding
-    double value = (double)q.data[0] / (1ULL << 32); // Undo scaling
-    *result = convertDoubleToP32(value);
-    if (*result == 0x80000000) return POSIT_NOT_A_REAL;
+    *result = q32_round(q.data);
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL;
     return POSIT_OK;
 }
 
+posit32 quire32_dot(const posit32 *a, const posit32 *b, size_t n) {
+    /* local accumulator so the limbs stay in registers for the whole loop */
+    uint64_t acc[Q32_LIMBS] = {0};
+    size_t i;
+    for (i = 0; i < n; i++)
+        if (!q32_fma(acc, a[i], b[i])) return P32_NAR;
+    return q32_round(acc);
+}
+
+
 posit_error_t float_to_posit32(posit32 *result, float f) {
     if (!result) return POSIT_INVALID;
-    if (isnan(f) || isinf(f)) {
-        *result = 0x80000000; // Not a Real
-        return POSIT_NOT_A_REAL;
-    }
-    *result = convertDoubleToP32((double)f);
+    *result = posit_from_ieee(32, 2, float_bits(f), 8, 23);
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL; // NaN or infinity
     return POSIT_OK;
 }
 
 posit_error_t posit32_to_float(float *result, posit32 p) {
     if (!result) return POSIT_INVALID;
-    if (p == 0x80000000) {
+    if (p == P32_NAR) {
         *result = 0.0f; // Map Not a Real to 0.0 (or NaN, depending on policy)
         return POSIT_NOT_A_REAL;
     }
-    *result = (float)convertP32ToDouble(p);
+    *result = p32_to_float(p);
     return POSIT_OK;
 }
 
 posit_error_t double_to_posit32(posit32 *result, double d) {
     if (!result) return POSIT_INVALID;
-    if (isnan(d) || isinf(d)) {
-        *result = 0x80000000;
-        return POSIT_NOT_A_REAL;
-    }
-    *result = convertDoubleToP32(d);
+    *result = posit_from_ieee(32, 2, double_bits(d), 11, 52);
+    if (*result == P32_NAR) return POSIT_NOT_A_REAL;
     return POSIT_OK;
 }
 
 posit_error_t posit32_to_double(double *result, posit32 p) {
     if (!result) return POSIT_INVALID;
-    if (p == 0x80000000) {
+    if (p == P32_NAR) {
         *result = 0.0;
         return POSIT_NOT_A_REAL;
     }
-    *result = convertP32ToDouble(p);
+    *result = p32_to_double(p);
     return POSIT_OK;
 }
 
+#ifndef POSIT_SFP_POSIT32_ONLY
 posit_error_t posit8_from_double(posit8 *result, double d) {
     if (!result) return POSIT_INVALID;
-    if (isnan(d) || isinf(d)) {
-        *result = 0x80; // Not a Real for posit8
-        return POSIT_NOT_A_REAL;
-    }
-    *result = convertDoubleToP8(d);
+    *result = (posit8)posit_from_ieee(8, 0, double_bits(d), 11, 52);
+    if (*result == 0x80) return POSIT_NOT_A_REAL; // Not a Real for posit8
     return POSIT_OK;
 }
 
 posit_error_t posit16_from_double(posit16 *result, double d) {
     if (!result) return POSIT_INVALID;
-    if (isnan(d) || isinf(d)) {
-        *result = 0x8000; // Not a Real for posit16
-        return POSIT_NOT_A_REAL;
-    }
-    *result = convertDoubleToP16(d);
+    *result = (posit16)posit_from_ieee(16, 1, double_bits(d), 11, 52);
+    if (*result == 0x8000) return POSIT_NOT_A_REAL; // Not a Real for posit16
     return POSIT_OK;
 }
+#endif
 
 posit_error_t posit32_from_double(posit32 *result, double d) {
-    if (!result) return POSIT_INVALID;
-    if (isnan(d) || isinf(d)) {
-        *result = 0x80000000;
-        return POSIT_NOT_A_REAL;
+    return double_to_posit32(result, d);
+}
+
+/* Array variants: one tight loop per buffer, POSIT_NOT_A_REAL if any result is NaR */
+#define P32_BINARY_ARRAY(name, op)                                                        \
+    posit_error_t name(posit32 *out, const posit32 *a, const posit32 *b, size_t n) {      \
+        uint32_t nar = 0;                                                                 \
+        size_t i;                                                                         \
+        if (!out || !a || !b) return POSIT_INVALID;                                       \
+        for (i = 0; i < n; i++) {                                                         \
+            out[i] = op(a[i], b[i]);                                                      \
+            nar |= out[i] == P32_NAR;                                                     \
+        }                                                                                 \
+        return nar ? POSIT_NOT_A_REAL : POSIT_OK;                                         \
     }
-    *result = convertDoubleToP32(d);
-    return POSIT_OK;
-}
\ No newline at end of file
+
+P32_BINARY_ARRAY(posit32_add_array, p32_add)
+P32_BINARY_ARRAY(posit32_sub_array, p32_sub)
+P32_BINARY_ARRAY(posit32_mul_array, p32_mul)
+P32_BINARY_ARRAY(posit32_div_array, p32_div)
+
+posit_error_t posit32_fma_array(posit32 *out, const posit32 *a, const posit32 *b, const posit32 *c, size_t n) {
+    uint32_t nar = 0;
+    size_t i;
+    if (!out || !a || !b || !c) return POSIT_INVALID;
+    for (i = 0; i < n; i++) {
+        out[i] = p32_fma(a[i], b[i], c[i]);
+        nar |= out[i] == P32_NAR;
+    }
+    return nar ? POSIT_NOT_A_REAL : POSIT_OK;
+}
+
+posit_error_t posit32_sqrt_array(posit32 *out, const posit32 *a, size_t n) {
+    uint32_t nar = 0;
+    size_t i;
+    if (!out || !a) return POSIT_INVALID;
+    for (i = 0; i < n; i++) {
+        out[i] = p32_sqrt(a[i]);
+        nar |= out[i] == P32_NAR;
+    }
+    return nar ? POSIT_NOT_A_REAL : POSIT_OK;
+}
+
+posit_error_t posit32_from_float_array(posit32 *out, const float *in, size_t n) {
+    uint32_t nar = 0;
+    size_t i;
+    if (!out || !in) return POSIT_INVALID;
+    for (i = 0; i < n; i++) {
+        out[i] = posit_from_ieee(32, 2, float_bits(in[i]), 8, 23);
+        nar |= out[i] == P32_NAR;
+    }
+    return nar ? POSIT_NOT_A_REAL : POSIT_OK;
+}
+
+posit_error_t posit32_to_float_array(float *out, const posit32 *in, size_t n) {
+    uint32_t nar = 0;
+    size_t i;
+    if (!out || !in) return POSIT_INVALID;
+    for (i = 0; i < n; i++) {
+        /* NaR maps to 0.0 as in posit32_to_float */
+        out[i] = in[i] == P32_NAR ? 0.0f : p32_to_float(in[i]);
+        nar |= in[i] == P32_NAR;
+    }
+    return nar ? POSIT_NOT_A_REAL : POSIT_OK;
+}
@@ -1,6 +1,7 @@
 #ifndef POSIT_H
 #define POSIT_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* Posit Arithmetic Interface for C
@@ -9,26 +10,35 @@
  * functions for arithmetic, fused operations, quire manipulations, and IEEE 754
  * conversions. Supports Dr. John L. Gustafson's requirements for posit integration
  * in C, including coexistence with floats, fused multiply-add, and quire-based
- * exact accumulation. Uses SoftPosit for true posit arithmetic.
+ * exact accumulation.
  *
- * Note: Requires SoftPosit library for implementation. Quire operations are
- * software-emulated pending hardware support.
+ * Note: posit_sfp.c is a self-contained, integer-only implementation with
+ * SoftPosit-compatible results. Quire operations are software-emulated
+ * pending hardware support.
+ *
+ * Defining POSIT_SFP_POSIT32_ONLY (for the header and for posit_sfp.c) leaves
+ * out posit8, posit16 and the error code names, so posit32 and the quire can
+ * be used next to another posit8/posit16 runtime: posit_compiler's generated
+ * code does. Status codes are then plain ints with the values below.
  */
 
 /* Posit Types
  * - posit8: 8-bit posit, 0 exponent bits (es=0)
  * - posit16: 16-bit posit, 1 exponent bit (es=1)
  * - posit32: 32-bit posit, 2 exponent bits (es=2)
- * Compatible with SoftPosit types (posit8_t, posit16_t, posit32_t).
+ * Bit-compatible with SoftPosit types (posit8_t, posit16_t, posit32_t).
  */
+#ifndef POSIT_SFP_POSIT32_ONLY
 typedef uint8_t posit8;
 typedef uint16_t posit16;
+#endif
 typedef uint32_t posit32;
 
 /* Quire Type
  * - quire32: 512-bit accumulator for posit32 operations, storing exact sums
  *   (e.g., dot products) without intermediate rounding.
- * - Implemented as 8 uint64_t (512 bits) for software emulation.
+ * - Implemented as 8 uint64_t (512 bits, little-endian limbs) holding a two's
+ *   complement fixed-point value with the least significant bit at 2^-240.
  */
 typedef struct {
     uint64_t data[8];
@@ -37,15 +47,19 @@ typedef struct {
 /* Error Codes
  * Returned by functions to indicate success or failure.
  */
+#ifndef POSIT_SFP_POSIT32_ONLY
 typedef enum {
     POSIT_OK = 0,
     POSIT_OVERFLOW,
     POSIT_INVALID,
     POSIT_NOT_A_REAL
 } posit_error_t;
+#else
+typedef int posit_error_t;
+#endif
 
 /* Arithmetic Operations for posit32
- * Standard operations using SoftPosit. Store result in *result.
+ * Correctly rounded operations on the integer posit fields. Store result in *result.
  */
 posit_error_t posit32_add(posit32 *result, posit32 a, posit32 b);
 posit_error_t posit32_sub(posit32 *result, posit32 a, posit32 b);
@@ -57,17 +71,37 @@ posit_error_t posit32_div(posit32 *result, posit32 a, posit32 b);
  */
 posit_error_t posit32_fma(posit32 *result, posit32 a, posit32 b, posit32 c);
 
+/* Square root for posit32: Not a Real for negative inputs. */
+posit_error_t posit32_sqrt(posit32 *result, posit32 a);
+
+/* Array Operations for posit32
+ * Element-wise over n-element buffers (out may alias an input). Return
+ * POSIT_NOT_A_REAL if any result is Not a Real.
+ */
+posit_error_t posit32_add_array(posit32 *out, const posit32 *a, const posit32 *b, size_t n);
+posit_error_t posit32_sub_array(posit32 *out, const posit32 *a, const posit32 *b, size_t n);
+posit_error_t posit32_mul_array(posit32 *out, const posit32 *a, const posit32 *b, size_t n);
+posit_error_t posit32_div_array(posit32 *out, const posit32 *a, const posit32 *b, size_t n);
+posit_error_t posit32_fma_array(posit32 *out, const posit32 *a, const posit32 *b, const posit32 *c, size_t n);
+posit_error_t posit32_sqrt_array(posit32 *out, const posit32 *a, size_t n);
+posit_error_t posit32_from_float_array(posit32 *out, const float *in, size_t n);
+posit_error_t posit32_to_float_array(float *out, const posit32 *in, size_t n);
+
 /* Quire Operations for posit32
  * - quire32_init: Initialize quire to zero.
- * - quire32_fma: Accumulate a * b into quire.
- * - quire32_to_posit: Extract posit32 result from quire.
+ * - quire32_fma: Accumulate a * b into quire exactly.
+ * - quire32_to_posit: Extract the correctly rounded posit32 result from quire.
+ * - quire32_dot: Correctly rounded dot product of two n-element arrays,
+ *   accumulated exactly in a quire (NaR if any element is NaR).
  */
 quire32 quire32_init(void);
 posit_error_t quire32_fma(quire32 *q, posit32 a, posit32 b);
 posit_error_t quire32_to_posit(posit32 *result, quire32 q);
+posit32 quire32_dot(const posit32 *a, const posit32 *b, size_t n);
 
 /* Conversions
- * Convert between posit32 and IEEE 754 float/double using SoftPosit.
+ * Convert between posit32 and IEEE 754 float/double bit patterns, rounding to
+ * nearest; NaN and infinities become Not a Real.
  */
 posit_error_t float_to_posit32(posit32 *result, float f);
 posit_error_t posit32_to_float(float *result, posit32 p);
@@ -77,8 +111,10 @@ posit_error_t posit32_to_double(double *result, posit32 p);
 /* Literal Construction
  * Create posit values from doubles.
  */
+#ifndef POSIT_SFP_POSIT32_ONLY
 posit_error_t posit8_from_double(posit8 *result, double d);
 posit_error_t posit16_from_double(posit16 *result, double d);
+#endif
 posit_error_t posit32_from_double(posit32 *result, double d);
 
 #endif /* POSIT_H */
\ No newline at end of file